@@ -0,0 +1,25 @@
+#version 330
+
+// Input vertex attributes (from vertex shader)
+in vec2 fragTexCoord;
+in vec4 fragColor;
+
+// Input uniform values
+uniform sampler2D texture0;
+uniform vec4 colDiffuse;
+
+// Output fragment color
+out vec4 finalColor;
+
+// the water frames are packed side by side in texture0, the quad is drawn with
+// texture coordinates counted in tiles so every whole number starts a new tile.
+uniform float frame;
+uniform float framesLen;
+
+void main()
+{
+    vec2 tile = fract(fragTexCoord);
+    vec2 uv = vec2((frame + tile.x)/framesLen, tile.y);
+
+    finalColor = texture(texture0, uv)*colDiffuse*fragColor;
+}
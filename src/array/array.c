@@ -1,6 +1,7 @@
 #include <slog.h>
 #include "array.h"
 #include "../memory/memory.h"
+#include "../memory/arena.h"
 #include "../common.h"
 
 // todo(hector) - make this header into a struct?
@@ -42,14 +43,29 @@ void *array_hold(void *array, int count, int item_size) {
     return newBase + 3;
 }
 
-int array_length(void *array) {
+int array_length(const void *array) {
     return (array != nil) ? ARRAY_OCCUPIED(array) : 0;
 }
 
-int array_cap(void *array) {
+int array_cap(const void *array) {
     return array != nil ? ARRAY_CAPACITY(array) : 0;
 }
 
+// keeps the memory around, useful for scratch arrays that get refilled every frame.
+void array_clear(void *array) {
+    if (array != nil) {
+        ARRAY_OCCUPIED(array) = 0;
+    }
+}
+
+// drops everything from length on, keeping the memory like array_clear.
+void array_truncate(void *array, int length) {
+    if (array == nil) { return; }
+
+    panicIf(length < 0 || length > ARRAY_OCCUPIED(array), "can't truncate an array of %d items to %d", ARRAY_OCCUPIED(array), length);
+    ARRAY_OCCUPIED(array) = length;
+}
+
 void array_free(void *array) {
     if (array != nil) {
         const u32 arraySize = headerSize + (ARRAY_ITEM_SIZE(array) * ARRAY_CAPACITY(array));
@@ -59,9 +75,29 @@ void array_free(void *array) {
     slogw("called array_free on null pointer");
 }
 
+void *array_arena_hold(Arena *arena, int count, int item_size) {
+    int *base = arena_alloc(arena, headerSize + (item_size * count));
+    base[0] = count;  // capacity
+    base[1] = count;  // occupied
+    base[2] = item_size;  // each item size
+    return base + 3;
+}
+
+// moves a dynamic array into the arena, trimmed to its length. The original is
+// freed, the returned copy has to be used from now on.
+void *array_freeze(void *array, Arena *arena) {
+    if (array == nil) { return nil; }
+
+    const int length = ARRAY_OCCUPIED(array);
+    void *frozen = array_arena_hold(arena, length, ARRAY_ITEM_SIZE(array));
+    mcopy_memory(frozen, array, length * ARRAY_ITEM_SIZE(array));
+    array_free(array);
+    return frozen;
+}
+
 void array_remove(void *array, int index, int item_size) {
     const int count = ARRAY_OCCUPIED(array);
-    for (int i = index; i < count; i++) {
+    for (int i = index; i < count - 1; i++) {
         char *dest = (char *) array + (i * item_size);
         const char *src = (char *) array + ((i + 1) * item_size);
         mcopy_memory(dest, src, item_size);
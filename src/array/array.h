@@ -12,8 +12,16 @@
 
 void* array_hold(void* array, int count, int item_size);
 void array_remove(void* array, int index, int item_size);
-int array_length(void* array);
-int array_cap(void *array);
+int array_length(const void* array);
+int array_cap(const void *array);
+void array_clear(void *array);
+void array_truncate(void *array, int length);
 void array_free(void* array);
 
+// Arrays that live in an arena are fixed, they are read like any other array
+// but never grown, removed from or freed, they go when the arena goes.
+typedef struct Arena Arena;
+void* array_arena_hold(Arena* arena, int count, int item_size);
+void* array_freeze(void* array, Arena* arena);
+
 #endif
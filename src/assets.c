@@ -9,18 +9,29 @@
 
 #include "common.h"
 #include "array/array.h"
+#include "platform.h"
+#include "profiler.h"
+#include "texture_cache.h"
 
+static struct dirent *list_directory_sorted(const char *dirPath);
 static Texture2D *import_textures_from_directory(const char *dir);
+static Texture2D import_texture_strip_from_directory(const char *dirPath);
 static int dir_entry_compare(const void *lhsp, const void *rhsp);
 static TileMap load_tile_map(i32 cols, i32 rows, const char *imagePath);
 static void unload_tile_map(TileMap *tm);
+static void load_fonts();
+static void load_audio();
+static void unload_fonts();
+static void unload_audio();
 
 Assets assets;
 
 void load_assets() {
+	PROFILE_FUNCTION();
 	assets = (Assets){};
 	assets.waterTextures.texturesList = import_textures_from_directory("./graphics/tilesets/water");
 	assets.waterTextures.len = 4;
+	assets.waterTextures.strip = import_texture_strip_from_directory("./graphics/tilesets/water");
 
 	// each graphic is 192, but we want 64px chunks
 	assets.tileMaps.coastLine = load_tile_map(3 * 8, 3 * 4, ("./graphics/tilesets/coast.png"));
@@ -37,52 +48,52 @@ void load_assets() {
 	assets.tileMaps.youngGirlCharacter = load_tile_map(4, 4, ("./graphics/characters/young_girl.png"));
 	assets.tileMaps.youngGuyCharacter = load_tile_map(4, 4, ("./graphics/characters/young_guy.png"));
 
-	assets.monsterIcons.atrox = LoadTexture("./graphics/icons/Atrox.png");
-	assets.monsterIcons.charmadillo = LoadTexture("./graphics/icons/Charmadillo.png");
-	assets.monsterIcons.cindrill = LoadTexture("./graphics/icons/Cindrill.png");
-	assets.monsterIcons.cleaf = LoadTexture("./graphics/icons/Cleaf.png");
-	assets.monsterIcons.draem = LoadTexture("./graphics/icons/Draem.png");
-	assets.monsterIcons.finiette = LoadTexture("./graphics/icons/Finiette.png");
-	assets.monsterIcons.finsta = LoadTexture("./graphics/icons/Finsta.png");
-	assets.monsterIcons.friolera = LoadTexture("./graphics/icons/Friolera.png");
-	assets.monsterIcons.gulfin = LoadTexture("./graphics/icons/Gulfin.png");
-	assets.monsterIcons.ivieron = LoadTexture("./graphics/icons/Ivieron.png");
-	assets.monsterIcons.jacana = LoadTexture("./graphics/icons/Jacana.png");
-	assets.monsterIcons.larvea = LoadTexture("./graphics/icons/Larvea.png");
-	assets.monsterIcons.pluma = LoadTexture("./graphics/icons/Pluma.png");
-	assets.monsterIcons.plumette = LoadTexture("./graphics/icons/Plumette.png");
-	assets.monsterIcons.pouch = LoadTexture("./graphics/icons/Pouch.png");
-	assets.monsterIcons.sparchu = LoadTexture("./graphics/icons/Sparchu.png");
-
-
-	assets.uiIcons.arrows = LoadTexture("./graphics/ui/arrows.png");
-	assets.uiIcons.cross = LoadTexture("./graphics/ui/cross.png");
-	assets.uiIcons.hand = LoadTexture("./graphics/ui/hand.png");
-	assets.uiIcons.notice = LoadTexture("./graphics/ui/notice.png");
-	assets.uiIcons.shieldHighlight = LoadTexture("./graphics/ui/shield_highlight.png");
-	assets.uiIcons.sword = LoadTexture("./graphics/ui/sword.png");
-	assets.uiIcons.arrowsHighlight = LoadTexture("./graphics/ui/arrows_highlight.png");
-	assets.uiIcons.defense = LoadTexture("./graphics/ui/defense.png");
-	assets.uiIcons.handHighlight = LoadTexture("./graphics/ui/hand_highlight.png");
-	assets.uiIcons.recovery = LoadTexture("./graphics/ui/recovery.png");
-	assets.uiIcons.speed = LoadTexture("./graphics/ui/speed.png");
-	assets.uiIcons.swordHighlight = LoadTexture("./graphics/ui/sword_highlight.png");
-	assets.uiIcons.attack = LoadTexture("./graphics/ui/attack.png");
-	assets.uiIcons.energy = LoadTexture("./graphics/ui/energy.png");
-	assets.uiIcons.health = LoadTexture("./graphics/ui/health.png");
-	assets.uiIcons.shield = LoadTexture("./graphics/ui/shield.png");
-	assets.uiIcons.star = LoadTexture("./graphics/ui/star.png");
-
-	assets.attackTextures.explosion = LoadTexture("./graphics/attacks/explosion.png");
-	assets.attackTextures.fire = LoadTexture("./graphics/attacks/fire.png");
-	assets.attackTextures.green = LoadTexture("./graphics/attacks/green.png");
-	assets.attackTextures.ice = LoadTexture("./graphics/attacks/ice.png");
-	assets.attackTextures.scratch = LoadTexture("./graphics/attacks/scratch.png");
-	assets.attackTextures.splash = LoadTexture("./graphics/attacks/splash.png");
-
-	assets.battleBackgrounds.forrest = LoadTexture("./graphics/backgrounds/forest.png");
-	assets.battleBackgrounds.ice = LoadTexture("./graphics/backgrounds/ice.png");
-	assets.battleBackgrounds.sand = LoadTexture("./graphics/backgrounds/sand.png");
+	assets.monsterIcons.atrox = texture_cache_load("./graphics/icons/Atrox.png");
+	assets.monsterIcons.charmadillo = texture_cache_load("./graphics/icons/Charmadillo.png");
+	assets.monsterIcons.cindrill = texture_cache_load("./graphics/icons/Cindrill.png");
+	assets.monsterIcons.cleaf = texture_cache_load("./graphics/icons/Cleaf.png");
+	assets.monsterIcons.draem = texture_cache_load("./graphics/icons/Draem.png");
+	assets.monsterIcons.finiette = texture_cache_load("./graphics/icons/Finiette.png");
+	assets.monsterIcons.finsta = texture_cache_load("./graphics/icons/Finsta.png");
+	assets.monsterIcons.friolera = texture_cache_load("./graphics/icons/Friolera.png");
+	assets.monsterIcons.gulfin = texture_cache_load("./graphics/icons/Gulfin.png");
+	assets.monsterIcons.ivieron = texture_cache_load("./graphics/icons/Ivieron.png");
+	assets.monsterIcons.jacana = texture_cache_load("./graphics/icons/Jacana.png");
+	assets.monsterIcons.larvea = texture_cache_load("./graphics/icons/Larvea.png");
+	assets.monsterIcons.pluma = texture_cache_load("./graphics/icons/Pluma.png");
+	assets.monsterIcons.plumette = texture_cache_load("./graphics/icons/Plumette.png");
+	assets.monsterIcons.pouch = texture_cache_load("./graphics/icons/Pouch.png");
+	assets.monsterIcons.sparchu = texture_cache_load("./graphics/icons/Sparchu.png");
+
+
+	assets.uiIcons.arrows = texture_cache_load("./graphics/ui/arrows.png");
+	assets.uiIcons.cross = texture_cache_load("./graphics/ui/cross.png");
+	assets.uiIcons.hand = texture_cache_load("./graphics/ui/hand.png");
+	assets.uiIcons.notice = texture_cache_load("./graphics/ui/notice.png");
+	assets.uiIcons.shieldHighlight = texture_cache_load("./graphics/ui/shield_highlight.png");
+	assets.uiIcons.sword = texture_cache_load("./graphics/ui/sword.png");
+	assets.uiIcons.arrowsHighlight = texture_cache_load("./graphics/ui/arrows_highlight.png");
+	assets.uiIcons.defense = texture_cache_load("./graphics/ui/defense.png");
+	assets.uiIcons.handHighlight = texture_cache_load("./graphics/ui/hand_highlight.png");
+	assets.uiIcons.recovery = texture_cache_load("./graphics/ui/recovery.png");
+	assets.uiIcons.speed = texture_cache_load("./graphics/ui/speed.png");
+	assets.uiIcons.swordHighlight = texture_cache_load("./graphics/ui/sword_highlight.png");
+	assets.uiIcons.attack = texture_cache_load("./graphics/ui/attack.png");
+	assets.uiIcons.energy = texture_cache_load("./graphics/ui/energy.png");
+	assets.uiIcons.health = texture_cache_load("./graphics/ui/health.png");
+	assets.uiIcons.shield = texture_cache_load("./graphics/ui/shield.png");
+	assets.uiIcons.star = texture_cache_load("./graphics/ui/star.png");
+
+	assets.attackTextures.explosion = texture_cache_load("./graphics/attacks/explosion.png");
+	assets.attackTextures.fire = texture_cache_load("./graphics/attacks/fire.png");
+	assets.attackTextures.green = texture_cache_load("./graphics/attacks/green.png");
+	assets.attackTextures.ice = texture_cache_load("./graphics/attacks/ice.png");
+	assets.attackTextures.scratch = texture_cache_load("./graphics/attacks/scratch.png");
+	assets.attackTextures.splash = texture_cache_load("./graphics/attacks/splash.png");
+
+	assets.battleBackgrounds.forrest = texture_cache_load("./graphics/backgrounds/forest.png");
+	assets.battleBackgrounds.ice = texture_cache_load("./graphics/backgrounds/ice.png");
+	assets.battleBackgrounds.sand = texture_cache_load("./graphics/backgrounds/sand.png");
 
 	assets.monsterTileMaps[MonsterIDAtrox] = load_tile_map(4, 2, "./graphics/monsters/Atrox.png");
 	assets.monsterTileMaps[MonsterIDCharmadillo] = load_tile_map(4, 2, "./graphics/monsters/Charmadillo.png");
@@ -120,131 +131,105 @@ void load_assets() {
 		"./graphics/attacks/splash.png"
 	);
 
-	assets.grassTexture = LoadTexture("./graphics/objects/grass.png");
-	assets.iceGrassTexture = LoadTexture("./graphics/objects/grass_ice.png");
-	assets.sandTexture = LoadTexture("./graphics/objects/sand.png");
+	assets.grassTexture = texture_cache_load("./graphics/objects/grass.png");
+	assets.iceGrassTexture = texture_cache_load("./graphics/objects/grass_ice.png");
+	assets.sandTexture = texture_cache_load("./graphics/objects/sand.png");
 
-	assets.characterShadowTexture = LoadTexture("./graphics/other/shadow.png");
-	assets.exclamationMarkTexture = LoadTexture("./graphics/ui/notice.png");
+	assets.characterShadowTexture = texture_cache_load("./graphics/other/shadow.png");
+	assets.exclamationMarkTexture = texture_cache_load("./graphics/ui/notice.png");
 
-	assets.fonts.dialog.size = 30;
-	assets.fonts.dialog.rFont = LoadFontEx(
-		"./graphics/fonts/PixeloidSans.ttf",
-		(i32)assets.fonts.dialog.size,
-		nil,
-		250
-	);
-	assets.fonts.regular.size = 18;
-	assets.fonts.regular.rFont = LoadFontEx(
-		"./graphics/fonts/PixeloidSans.ttf",
-		(i32)assets.fonts.regular.size,
-		nil,
-		250
-	);
-	assets.fonts.small.size = 14;
-	assets.fonts.small.rFont = LoadFontEx("./graphics/fonts/PixeloidSans.ttf", (i32)assets.fonts.small.size, nil, 250);
-	assets.fonts.bold.size = 20;
-	assets.fonts.bold.rFont = LoadFontEx("./graphics/fonts/dogicapixelbold.otf", (i32)assets.fonts.bold.size, nil, 250);
-
-	// music and sounds
-	assets.sounds.explosion = LoadSound("./audio/explosion.wav");
-	assets.sounds.evolution = LoadSound("./audio/evolution.mp3");
-	assets.sounds.fire = LoadSound("./audio/fire.wav");
-	assets.sounds.green = LoadSound("./audio/green.wav");
-	assets.sounds.ice = LoadSound("./audio/ice.mp3");
-	assets.sounds.notice = LoadSound("./audio/notice.wav");
-	assets.sounds.scratch = LoadSound("./audio/scratch.mp3");
-	assets.sounds.splash = LoadSound("./audio/splash.wav");
-
-	assets.music.battle = LoadMusicStream("./audio/battle.ogg");
-	assets.music.battle.looping = true;
-	assets.music.overWorld = LoadMusicStream("./audio/overWorld.ogg");
-	assets.music.overWorld.looping = true; // default, but explicit
+	// there is no window to rasterize fonts into and no audio device to play
+	// anything on when benchmarking headless.
+	if (!platform_is_headless()) {
+		load_fonts();
+		load_audio();
+	}
 }
 
 void unload_assets() {
 	array_range(assets.waterTextures.texturesList, i) {
-		UnloadTexture(assets.waterTextures.texturesList[i]);
+		texture_cache_release(assets.waterTextures.texturesList[i]);
 	}
 	array_free(assets.waterTextures.texturesList);
+	platform_unload_texture(assets.waterTextures.strip);
 
-	UnloadTexture(assets.tileMaps.coastLine.texture);
+	texture_cache_release(assets.tileMaps.coastLine.texture);
 	array_free(assets.tileMaps.coastLine.framesList);
 
-	UnloadTexture(assets.tileMaps.player.texture);
+	texture_cache_release(assets.tileMaps.player.texture);
 	array_free(assets.tileMaps.player.framesList);
 
-	UnloadTexture(assets.tileMaps.blondCharacter.texture);
+	texture_cache_release(assets.tileMaps.blondCharacter.texture);
 	array_free(assets.tileMaps.blondCharacter.framesList);
-	UnloadTexture(assets.tileMaps.fireBossCharacter.texture);
+	texture_cache_release(assets.tileMaps.fireBossCharacter.texture);
 	array_free(assets.tileMaps.fireBossCharacter.framesList);
-	UnloadTexture(assets.tileMaps.grassBossCharacter.texture);
+	texture_cache_release(assets.tileMaps.grassBossCharacter.texture);
 	array_free(assets.tileMaps.grassBossCharacter.framesList);
-	UnloadTexture(assets.tileMaps.hatGirlCharacter.texture);
+	texture_cache_release(assets.tileMaps.hatGirlCharacter.texture);
 	array_free(assets.tileMaps.hatGirlCharacter.framesList);
-	UnloadTexture(assets.tileMaps.purpleGirlCharacter.texture);
+	texture_cache_release(assets.tileMaps.purpleGirlCharacter.texture);
 	array_free(assets.tileMaps.purpleGirlCharacter.framesList);
-	UnloadTexture(assets.tileMaps.strawCharacter.texture);
+	texture_cache_release(assets.tileMaps.strawCharacter.texture);
 	array_free(assets.tileMaps.strawCharacter.framesList);
-	UnloadTexture(assets.tileMaps.waterBossCharacter.texture);
+	texture_cache_release(assets.tileMaps.waterBossCharacter.texture);
 	array_free(assets.tileMaps.waterBossCharacter.framesList);
-	UnloadTexture(assets.tileMaps.youngGirlCharacter.texture);
+	texture_cache_release(assets.tileMaps.youngGirlCharacter.texture);
 	array_free(assets.tileMaps.youngGirlCharacter.framesList);
-	UnloadTexture(assets.tileMaps.youngGuyCharacter.texture);
+	texture_cache_release(assets.tileMaps.youngGuyCharacter.texture);
 	array_free(assets.tileMaps.youngGuyCharacter.framesList);
 
-	UnloadTexture(assets.grassTexture);
-	UnloadTexture(assets.iceGrassTexture);
-	UnloadTexture(assets.sandTexture);
-
-	UnloadTexture(assets.characterShadowTexture);
-	UnloadTexture(assets.exclamationMarkTexture);
-
-	UnloadTexture(assets.monsterIcons.atrox);
-	UnloadTexture(assets.monsterIcons.charmadillo);
-	UnloadTexture(assets.monsterIcons.cindrill);
-	UnloadTexture(assets.monsterIcons.cleaf);
-	UnloadTexture(assets.monsterIcons.draem);
-	UnloadTexture(assets.monsterIcons.finiette);
-	UnloadTexture(assets.monsterIcons.finsta);
-	UnloadTexture(assets.monsterIcons.friolera);
-	UnloadTexture(assets.monsterIcons.gulfin);
-	UnloadTexture(assets.monsterIcons.ivieron);
-	UnloadTexture(assets.monsterIcons.jacana);
-	UnloadTexture(assets.monsterIcons.larvea);
-	UnloadTexture(assets.monsterIcons.pluma);
-	UnloadTexture(assets.monsterIcons.plumette);
-	UnloadTexture(assets.monsterIcons.pouch);
-	UnloadTexture(assets.monsterIcons.sparchu);
-
-	UnloadTexture(assets.uiIcons.arrows);
-	UnloadTexture(assets.uiIcons.cross);
-	UnloadTexture(assets.uiIcons.hand);
-	UnloadTexture(assets.uiIcons.notice);
-	UnloadTexture(assets.uiIcons.shieldHighlight);
-	UnloadTexture(assets.uiIcons.sword);
-	UnloadTexture(assets.uiIcons.arrowsHighlight);
-	UnloadTexture(assets.uiIcons.defense);
-	UnloadTexture(assets.uiIcons.handHighlight);
-	UnloadTexture(assets.uiIcons.recovery);
-	UnloadTexture(assets.uiIcons.speed);
-	UnloadTexture(assets.uiIcons.swordHighlight);
-	UnloadTexture(assets.uiIcons.attack);
-	UnloadTexture(assets.uiIcons.energy);
-	UnloadTexture(assets.uiIcons.health);
-	UnloadTexture(assets.uiIcons.shield);
-	UnloadTexture(assets.uiIcons.star);
-
-	UnloadTexture(assets.attackTextures.explosion);
-	UnloadTexture(assets.attackTextures.fire);
-	UnloadTexture(assets.attackTextures.green);
-	UnloadTexture(assets.attackTextures.ice);
-	UnloadTexture(assets.attackTextures.scratch);
-	UnloadTexture(assets.attackTextures.splash);
-
-	UnloadTexture(assets.battleBackgrounds.forrest);
-	UnloadTexture(assets.battleBackgrounds.ice);
-	UnloadTexture(assets.battleBackgrounds.sand);
+	texture_cache_release(assets.grassTexture);
+	texture_cache_release(assets.iceGrassTexture);
+	texture_cache_release(assets.sandTexture);
+
+	texture_cache_release(assets.characterShadowTexture);
+	texture_cache_release(assets.exclamationMarkTexture);
+
+	texture_cache_release(assets.monsterIcons.atrox);
+	texture_cache_release(assets.monsterIcons.charmadillo);
+	texture_cache_release(assets.monsterIcons.cindrill);
+	texture_cache_release(assets.monsterIcons.cleaf);
+	texture_cache_release(assets.monsterIcons.draem);
+	texture_cache_release(assets.monsterIcons.finiette);
+	texture_cache_release(assets.monsterIcons.finsta);
+	texture_cache_release(assets.monsterIcons.friolera);
+	texture_cache_release(assets.monsterIcons.gulfin);
+	texture_cache_release(assets.monsterIcons.ivieron);
+	texture_cache_release(assets.monsterIcons.jacana);
+	texture_cache_release(assets.monsterIcons.larvea);
+	texture_cache_release(assets.monsterIcons.pluma);
+	texture_cache_release(assets.monsterIcons.plumette);
+	texture_cache_release(assets.monsterIcons.pouch);
+	texture_cache_release(assets.monsterIcons.sparchu);
+
+	texture_cache_release(assets.uiIcons.arrows);
+	texture_cache_release(assets.uiIcons.cross);
+	texture_cache_release(assets.uiIcons.hand);
+	texture_cache_release(assets.uiIcons.notice);
+	texture_cache_release(assets.uiIcons.shieldHighlight);
+	texture_cache_release(assets.uiIcons.sword);
+	texture_cache_release(assets.uiIcons.arrowsHighlight);
+	texture_cache_release(assets.uiIcons.defense);
+	texture_cache_release(assets.uiIcons.handHighlight);
+	texture_cache_release(assets.uiIcons.recovery);
+	texture_cache_release(assets.uiIcons.speed);
+	texture_cache_release(assets.uiIcons.swordHighlight);
+	texture_cache_release(assets.uiIcons.attack);
+	texture_cache_release(assets.uiIcons.energy);
+	texture_cache_release(assets.uiIcons.health);
+	texture_cache_release(assets.uiIcons.shield);
+	texture_cache_release(assets.uiIcons.star);
+
+	texture_cache_release(assets.attackTextures.explosion);
+	texture_cache_release(assets.attackTextures.fire);
+	texture_cache_release(assets.attackTextures.green);
+	texture_cache_release(assets.attackTextures.ice);
+	texture_cache_release(assets.attackTextures.scratch);
+	texture_cache_release(assets.attackTextures.splash);
+
+	texture_cache_release(assets.battleBackgrounds.forrest);
+	texture_cache_release(assets.battleBackgrounds.ice);
+	texture_cache_release(assets.battleBackgrounds.sand);
 
 	unload_tile_map(&assets.monsterTileMaps[MonsterIDAtrox]);
 	unload_tile_map(&assets.monsterTileMaps[MonsterIDCharmadillo]);
@@ -270,26 +255,13 @@ void unload_assets() {
 	unload_tile_map(&assets.monsterAttackTileMaps[MonsterAbilityAnimationIDScratch]);
 	unload_tile_map(&assets.monsterAttackTileMaps[MonsterAbilityAnimationIDSplash]);
 
-	UnloadFont(assets.fonts.dialog.rFont);
-	UnloadFont(assets.fonts.regular.rFont);
-	UnloadFont(assets.fonts.small.rFont);
-	UnloadFont(assets.fonts.bold.rFont);
-
-	// sounds and music
-	UnloadSound(assets.sounds.explosion);
-	UnloadSound(assets.sounds.evolution);
-	UnloadSound(assets.sounds.fire);
-	UnloadSound(assets.sounds.green);
-	UnloadSound(assets.sounds.ice);
-	UnloadSound(assets.sounds.notice);
-	UnloadSound(assets.sounds.scratch);
-	UnloadSound(assets.sounds.splash);
-
-	UnloadMusicStream(assets.music.battle);
-	UnloadMusicStream(assets.music.overWorld);
+	if (!platform_is_headless()) {
+		unload_fonts();
+		unload_audio();
+	}
 }
 
-static Texture2D *import_textures_from_directory(const char *dirPath) {
+static struct dirent *list_directory_sorted(const char *dirPath) {
 	DIR *dir = opendir(dirPath);
 	panicIfNil(dir, "failed to open directory %s for texture", dirPath);
 
@@ -306,13 +278,18 @@ static Texture2D *import_textures_from_directory(const char *dirPath) {
 
 	// sort the directory entries
 	qsort(dynFileInfoList, array_length(dynFileInfoList), sizeof(*dynFileInfoList), dir_entry_compare);
+	return dynFileInfoList;
+}
+
+static Texture2D *import_textures_from_directory(const char *dirPath) {
+	struct dirent *dynFileInfoList = list_directory_sorted(dirPath);
 
 	Texture2D *dynTextures = nil;
 	for (int i = 0; i < array_length(dynFileInfoList); i++) {
 #define textFilePathBufSize 1024
 		char buff[textFilePathBufSize];
 		snprintf(buff, textFilePathBufSize, "%s/%s", dirPath, dynFileInfoList[i].d_name);
-		const Texture2D text = LoadTexture(buff);
+		const Texture2D text = texture_cache_load(buff);
 		array_push(dynTextures, text);
 	}
 
@@ -320,8 +297,38 @@ static Texture2D *import_textures_from_directory(const char *dirPath) {
 	return dynTextures;
 }
 
+// every image in the directory, in order, packed left to right into one
+// texture. The images must all be the same size.
+static Texture2D import_texture_strip_from_directory(const char *dirPath) {
+	struct dirent *dynFileInfoList = list_directory_sorted(dirPath);
+	const i32 len = array_length(dynFileInfoList);
+
+	Image strip = {};
+	for (i32 i = 0; i < len; i++) {
+		char buff[textFilePathBufSize];
+		snprintf(buff, textFilePathBufSize, "%s/%s", dirPath, dynFileInfoList[i].d_name);
+		Image frame = LoadImage(buff);
+		panicIf(!IsImageReady(frame), "failed to load image %s", buff);
+
+		if (i == 0) {
+			strip = GenImageColor(frame.width * len, frame.height, BLANK);
+		}
+		panicIf(frame.width * len != strip.width || frame.height != strip.height, "%s is not the size of the other frames", buff);
+
+		const Rectangle source = {0, 0, (f32)frame.width, (f32)frame.height};
+		const Rectangle dest = {(f32)(i * frame.width), 0, (f32)frame.width, (f32)frame.height};
+		ImageDraw(&strip, frame, source, dest, WHITE);
+		UnloadImage(frame);
+	}
+
+	const Texture2D texture = platform_load_texture_from_image(strip);
+	UnloadImage(strip);
+	array_free(dynFileInfoList);
+	return texture;
+}
+
 TileMap load_tile_map(const i32 cols, const i32 rows, const char *imagePath) {
-	const Texture2D texture = LoadTexture(imagePath);
+	const Texture2D texture = texture_cache_load(imagePath);
 	panicIf(!IsTextureReady(texture), "failed to load texture");
 
 	Rectangle *framesList = nil;
@@ -348,7 +355,7 @@ TileMap load_tile_map(const i32 cols, const i32 rows, const char *imagePath) {
 }
 
 void unload_tile_map(TileMap *tm) {
-	UnloadTexture(tm->texture);
+	texture_cache_release(tm->texture);
 	array_free(tm->framesList);
 }
 
@@ -360,6 +367,10 @@ Rectangle tile_map_get_frame_at(const TileMap tm, const i32 col, const i32 row)
 }
 
 void load_shaders() {
+	// shaders need a GL context, with them zeroed everything falls back to the
+	// default shader.
+	if (platform_is_headless()) { return; }
+
 	assets.shaders.textureOutline = LoadShader(
 		nil,
 		"./shaders/texture_outline.frag"
@@ -368,11 +379,20 @@ void load_shaders() {
 		nil,
 		"./shaders/texture_grayscale.frag"
 	);
+	assets.shaders.water = LoadShader(
+		nil,
+		"./shaders/water.frag"
+	);
+	assets.shaders.waterFrameLoc = GetShaderLocation(assets.shaders.water, "frame");
+	assets.shaders.waterFramesLenLoc = GetShaderLocation(assets.shaders.water, "framesLen");
 }
 
 void unload_shaders() {
+	if (platform_is_headless()) { return; }
+
 	UnloadShader(assets.shaders.textureOutline);
 	UnloadShader(assets.shaders.grayscale);
+	UnloadShader(assets.shaders.water);
 }
 
 static int dir_entry_compare(const void *lhsp, const void *rhsp) {
@@ -380,3 +400,61 @@ static int dir_entry_compare(const void *lhsp, const void *rhsp) {
 	const struct dirent *rhs = rhsp;
 	return strcmp(lhs->d_name, rhs->d_name);
 }
+
+static void load_fonts() {
+	assets.fonts.dialog.size = 30;
+	assets.fonts.dialog.rFont = LoadFontEx(
+		"./graphics/fonts/PixeloidSans.ttf",
+		(i32)assets.fonts.dialog.size,
+		nil,
+		250
+	);
+	assets.fonts.regular.size = 18;
+	assets.fonts.regular.rFont = LoadFontEx(
+		"./graphics/fonts/PixeloidSans.ttf",
+		(i32)assets.fonts.regular.size,
+		nil,
+		250
+	);
+	assets.fonts.small.size = 14;
+	assets.fonts.small.rFont = LoadFontEx("./graphics/fonts/PixeloidSans.ttf", (i32)assets.fonts.small.size, nil, 250);
+	assets.fonts.bold.size = 20;
+	assets.fonts.bold.rFont = LoadFontEx("./graphics/fonts/dogicapixelbold.otf", (i32)assets.fonts.bold.size, nil, 250);
+}
+
+static void load_audio() {
+	assets.sounds.explosion = LoadSound("./audio/explosion.wav");
+	assets.sounds.evolution = LoadSound("./audio/evolution.mp3");
+	assets.sounds.fire = LoadSound("./audio/fire.wav");
+	assets.sounds.green = LoadSound("./audio/green.wav");
+	assets.sounds.ice = LoadSound("./audio/ice.mp3");
+	assets.sounds.notice = LoadSound("./audio/notice.wav");
+	assets.sounds.scratch = LoadSound("./audio/scratch.mp3");
+	assets.sounds.splash = LoadSound("./audio/splash.wav");
+
+	assets.music.battle = LoadMusicStream("./audio/battle.ogg");
+	assets.music.battle.looping = true;
+	assets.music.overWorld = LoadMusicStream("./audio/overWorld.ogg");
+	assets.music.overWorld.looping = true; // default, but explicit
+}
+
+static void unload_fonts() {
+	UnloadFont(assets.fonts.dialog.rFont);
+	UnloadFont(assets.fonts.regular.rFont);
+	UnloadFont(assets.fonts.small.rFont);
+	UnloadFont(assets.fonts.bold.rFont);
+}
+
+static void unload_audio() {
+	UnloadSound(assets.sounds.explosion);
+	UnloadSound(assets.sounds.evolution);
+	UnloadSound(assets.sounds.fire);
+	UnloadSound(assets.sounds.green);
+	UnloadSound(assets.sounds.ice);
+	UnloadSound(assets.sounds.notice);
+	UnloadSound(assets.sounds.scratch);
+	UnloadSound(assets.sounds.splash);
+
+	UnloadMusicStream(assets.music.battle);
+	UnloadMusicStream(assets.music.overWorld);
+}
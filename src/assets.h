@@ -25,6 +25,9 @@ typedef struct Assets {
 	struct {
 		i32 len;
 		Texture2D *texturesList;
+		// the same frames side by side, for drawing whole water regions with
+		// the water shader.
+		Texture2D strip;
 	} waterTextures;
 
 	Texture2D grassTexture;
@@ -113,6 +116,9 @@ typedef struct Assets {
 	struct {
 		Shader textureOutline;
 		Shader grayscale;
+		Shader water;
+		i32 waterFrameLoc;
+		i32 waterFramesLenLoc;
 	} shaders;
 
 	struct {
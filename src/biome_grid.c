@@ -0,0 +1,96 @@
+//
+// Created by Hector Mejia on 10/17/26.
+//
+
+#include "biome_grid.h"
+
+#include <math.h>
+
+typedef struct CellRange {
+	i32 firstCol;
+	i32 firstRow;
+	i32 lastCol;
+	i32 lastRow;
+} CellRange;
+
+static CellRange cells_under(const BiomeGrid *grid, Rectangle rect);
+
+static const char *biomeNames[BiomeCount] = {
+	[BiomeNone] = "none",
+	[BiomeForest] = "forest",
+	[BiomeIce] = "ice",
+	[BiomeSand] = "sand",
+};
+
+Biome biome_from_str(const char *name) {
+	for (i32 i = BiomeNone + 1; i < BiomeCount; i++) {
+		if (streq(name, biomeNames[i])) {
+			return i;
+		}
+	}
+	panic("unknown biome %s", name);
+	return BiomeNone;
+}
+
+const char *biome_string(const Biome biome) {
+	panicIf(biome < 0 || biome >= BiomeCount, "invalid biome %d", biome);
+	return biomeNames[biome];
+}
+
+BiomeGrid biome_grid_new(Arena *arena, const f32 worldWidth, const f32 worldHeight, const f32 cellSize) {
+	panicIf(cellSize <= 0, "biome grid cell size must be positive");
+
+	BiomeGrid grid = {
+		.cellSize = cellSize,
+		.columns = max((i32)ceilf(worldWidth / cellSize), 1),
+		.rows = max((i32)ceilf(worldHeight / cellSize), 1),
+	};
+	grid.cells = arena_alloc(arena, sizeof(*grid.cells) * grid.columns * grid.rows);
+	grid.tables = arena_alloc(arena, sizeof(*grid.tables) * grid.columns * grid.rows);
+	return grid;
+}
+
+void biome_grid_fill(BiomeGrid *grid, const Rectangle rect, const Biome biome, const u8 table) {
+	panicIf(biome < 0 || biome >= BiomeCount, "invalid biome %d", biome);
+
+	const CellRange range = cells_under(grid, rect);
+	for (i32 row = range.firstRow; row <= range.lastRow; row++) {
+		for (i32 col = range.firstCol; col <= range.lastCol; col++) {
+			grid->cells[(row * grid->columns) + col] = (u8)biome;
+			grid->tables[(row * grid->columns) + col] = table;
+		}
+	}
+}
+
+Biome biome_grid_under(const BiomeGrid *grid, const Rectangle area, u8 *outTable) {
+	*outTable = 0;
+	if (grid->cells == nil) { return BiomeNone; }
+
+	const CellRange range = cells_under(grid, area);
+	for (i32 row = range.firstRow; row <= range.lastRow; row++) {
+		for (i32 col = range.firstCol; col <= range.lastCol; col++) {
+			const Biome biome = grid->cells[(row * grid->columns) + col];
+			if (biome != BiomeNone) {
+				*outTable = grid->tables[(row * grid->columns) + col];
+				return biome;
+			}
+		}
+	}
+	return BiomeNone;
+}
+
+// clamped to the grid, empty (first after last) when the rectangle is outside
+// of it or has no area. A rectangle ending exactly on a cell border doesn't
+// reach into the next cell.
+static CellRange cells_under(const BiomeGrid *grid, const Rectangle rect) {
+	if (rect.width <= 0 || rect.height <= 0) {
+		return (CellRange){.firstCol = 0, .lastCol = -1};
+	}
+
+	return (CellRange){
+		.firstCol = max((i32)floorf(rect.x / grid->cellSize), 0),
+		.firstRow = max((i32)floorf(rect.y / grid->cellSize), 0),
+		.lastCol = min((i32)ceilf((rect.x + rect.width) / grid->cellSize) - 1, grid->columns - 1),
+		.lastRow = min((i32)ceilf((rect.y + rect.height) / grid->cellSize) - 1, grid->rows - 1),
+	};
+}
@@ -0,0 +1,55 @@
+//
+// Created by Hector Mejia on 10/17/26.
+//
+
+#ifndef RAYLIB_POKEMON_CLONE_BIOME_GRID_H
+#define RAYLIB_POKEMON_CLONE_BIOME_GRID_H
+
+#include "raylib.h"
+#include "common.h"
+#include "memory/arena.h"
+
+// the kinds of ground wild monsters come out of, none means no encounters.
+typedef enum Biome {
+	BiomeNone = 0,
+	BiomeForest,
+	BiomeIce,
+	BiomeSand,
+
+	BiomeCount,
+} Biome;
+
+// The biome of every tile, one byte each. The Monsters layer is made of tile
+// sized objects, so asking what the player stands on is a few lookups under
+// its hit box instead of a pass over every encounter sprite.
+typedef struct BiomeGrid {
+	f32 cellSize;
+	i32 columns;
+	i32 rows;
+	u8 *cells; // columns * rows Biome values, row by row
+	// same layout, the encounter table of the patch on each cell as an index
+	// into the map's patch tables plus one, 0 rolls from the biome's table.
+	u8 *tables;
+} BiomeGrid;
+
+// the biome property of Monsters layer objects and of the game data.
+Biome biome_from_str(const char *name);
+const char *biome_string(Biome biome);
+
+BiomeGrid biome_grid_new(Arena *arena, f32 worldWidth, f32 worldHeight, f32 cellSize);
+
+/**
+ * Sets the biome and the encounter table of every cell the rectangle covers,
+ * even partially. The parts outside the grid are ignored.
+ * @param table the patch table index plus one, 0 for the biome's table
+ */
+void biome_grid_fill(BiomeGrid *grid, Rectangle rect, Biome biome, u8 table);
+
+/**
+ * Returns the first biome found in the cells under the area, going row by row,
+ * BiomeNone if there is none.
+ * @param outTable the encounter table of the cell the biome came from
+ */
+Biome biome_grid_under(const BiomeGrid *grid, Rectangle area, u8 *outTable);
+
+#endif //RAYLIB_POKEMON_CLONE_BIOME_GRID_H
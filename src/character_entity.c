@@ -9,12 +9,12 @@
 #include "assets.h"
 #include "game.h"
 #include "game_data.h"
+#include "gpu_stats.h"
 #include "raylib_extras.h"
 #include "settings.h"
 #include "array/array.h"
 
 static void character_animate(Character *c, f32 deltaTime);
-static bool line_intersects_rect(Vector2 p1, Vector2 p2, Rectangle r);
 static bool character_has_line_of_sight(const Character *c, const Rectangle *rect);
 
 Character character_new(
@@ -61,6 +61,7 @@ Character character_new(
 	// i happen to know there is nothing larger for this demo
 	strncpy(character.id, id, 16);
 	character.hitBox = rectangle_deflate(character.frame, character.frame.width / 2, 60);
+	character.previousFrame = character.frame;
 
 	return character;
 }
@@ -78,6 +79,7 @@ void character_move(Character *c, const f32 deltaTime) {
 }
 
 void character_update(Character *c, const f32 deltaTime) {
+	c->previousFrame = c->frame;
 	character_raycast(c);
 
 	if (c->isPlayer) {
@@ -118,11 +120,19 @@ void character_update(Character *c, const f32 deltaTime) {
 	character_animate(c, deltaTime);
 }
 
-void character_draw(const Character *c) {
-	const Vector2 pos = {
-		.x = c->frame.x,
-		.y = c->frame.y,
-	};
+// nobody walks a tile in a single tick, a jump that big was a teleport (a map
+// change, a spawn) and is drawn where it landed.
+Vector2 character_render_position(const Character *c) {
+	const Vector2 previous = rectangle_location(c->previousFrame);
+	const Vector2 current = rectangle_location(c->frame);
+	if (Vector2Distance(previous, current) > TILE_SIZE) {
+		return current;
+	}
+	return Vector2Lerp(previous, current, game.interpolation);
+}
+
+void character_draw(const Character *c, const f32 depth) {
+	const Vector2 pos = character_render_position(c);
 	const Rectangle frame = c->animatedSprite.sourceFrames[c->animatedSprite.currentFrame];
 	const Rectangle boundingBox = {
 		.x = pos.x,
@@ -145,17 +155,23 @@ void character_draw(const Character *c) {
 		.height = (f32)assets.characterShadowTexture.height,
 		.width = (f32)assets.characterShadowTexture.width,
 	};
+	const GpuSubsystem subsystem = gpu_stats_set_subsystem(GpuSubsystemCharacters);
 	game.gameMetrics.drawnSprites++;
-	DrawTextureRec(assets.characterShadowTexture, shadowRect, shadowPos, WHITE);
+	game.gameMetrics.drawCalls++;
+	// shadows have their own layer, so they stay under every character and
+	// never get batched on top of the sprite they belong to.
+	draw_buffer_push_texture(DrawLayerShadow, c->animatedSprite.entity.ySort, assets.characterShadowTexture, shadowRect, shadowPos, WHITE);
 
 	game.gameMetrics.drawnSprites++;
-	DrawTextureRec(c->animatedSprite.texture, frame, pos, WHITE);
+	game.gameMetrics.drawCalls++;
+	draw_buffer_push_texture(DrawLayerMain, depth, c->animatedSprite.texture, frame, pos, WHITE);
+	gpu_stats_set_subsystem(subsystem);
 
 	if (!game.isDebug) { return; }
 
-	DrawRectangleLinesEx(boundingBox, 3.f, RED);
-	DrawRectangleLinesEx(c->hitBox, 3.f, BLUE);
-	DrawCircleV(pos, 5.f, RED);
+	draw_buffer_push_rectangle_lines(DrawLayerDebug, 0, boundingBox, 3.f, RED);
+	draw_buffer_push_rectangle_lines(DrawLayerDebug, 0, c->hitBox, 3.f, BLUE);
+	draw_buffer_push_circle(DrawLayerDebug, 0, pos, 5.f, RED);
 }
 
 void character_animate(Character *c, const f32 deltaTime) {
@@ -192,6 +208,7 @@ void character_animate(Character *c, const f32 deltaTime) {
 	}
 	animated_tiled_sprite_update(&c->animatedSprite, deltaTime);
 	c->animatedSprite.entity.ySort = c->frame.y + (c->frame.height / 2);
+	c->animatedSprite.entity.position = rectangle_location(c->frame);
 	c->hitBox = rectangle_deflate(c->frame, c->frame.width / 2, 60);
 }
 
@@ -318,27 +335,15 @@ void character_raycast(Character *c) {
 	}
 }
 
-// not the best, but works here. If need more performance, use Cohen-Sutherland algorithm
-// https://stackoverflow.com/a/23641016
-static bool line_intersects_rect(const Vector2 p1, const Vector2 p2, const Rectangle r) {
-	return CheckCollisionLines(p1, p2, (Vector2){r.x, r.y}, (Vector2){r.x + r.width, r.y}, nil) ||
-		   CheckCollisionLines(p1, p2, (Vector2){r.x + r.width, r.y}, (Vector2){r.x + r.width, r.y + r.height}, nil) ||
-		   CheckCollisionLines(p1, p2, (Vector2){r.x + r.width, r.y + r.height}, (Vector2){r.x, r.y + r.height}, nil) ||
-		   CheckCollisionLines(p1, p2, (Vector2){r.x, r.y + r.height}, (Vector2){r.x, r.y}, nil) ||
-		   (CheckCollisionPointRec(p1, r) && CheckCollisionPointRec(p2, r));
-}
-
 static bool character_has_line_of_sight(const Character *const c, const Rectangle *const rect) {
 	const Vector2 characterCenter = character_get_center(c);
 	const Vector2 rectPos = {.x = rect->x, .y = rect->y};
 	const f32 distance = Vector2Distance(characterCenter, rectPos);
 	if (distance < c->radius) {
-		array_range(game.currentMap->collisionBoxes, i) {
-			const Rectangle collisionRect = game.currentMap->collisionBoxes[i];
-			if (line_intersects_rect(characterCenter, rectPos, collisionRect)) {
-				return false;
-			}
+		if (settings.exactLineOfSight) {
+			return map_line_of_sight_exact(game.currentMap, characterCenter, rectPos);
 		}
+		return map_line_of_sight(game.currentMap, characterCenter, rectPos);
 	}
 	return true;
 }
@@ -10,6 +10,7 @@
 #include "sprites.h"
 #include "assets.h"
 #include "timer.h"
+#include "draw_buffer.h"
 
 typedef enum CharacterState {
     CharacterStateIdle,
@@ -37,6 +38,9 @@ const char *character_direction_string(CharacterDirection d);
 typedef struct Character {
     char id[128];
     Rectangle frame;
+    // the frame as of the previous simulation tick, drawing interpolates
+    // between the two.
+    Rectangle previousFrame;
     Rectangle hitBox;
     Vector2 velocity;
     AnimatedTiledSprite animatedSprite;
@@ -92,9 +96,12 @@ typedef struct CharacterData {
 Character character_new(Vector2 centerPosition, TileMap tileMap, CharacterDirection direction, const char *id);
 void character_free(const Character *c);
 void character_update(Character *c, f32 deltaTime);
-void character_draw(const Character *c);
+// depth is the draw order within the main layer, see map_draw.
+void character_draw(const Character *c, f32 depth);
 void character_move(Character *c, f32 deltaTime);
 void character_set_center_at(Character *c, Vector2 center);
+// where to draw the character this frame, between its last two ticks.
+Vector2 character_render_position(const Character *c);
 Vector2 character_get_center(const Character *c);
 void character_change_direction(Character *c, Vector2 target);
 CharacterDirection character_direction_from_str(const char *directionStr);
@@ -3,6 +3,7 @@
 //
 
 #include "common.h"
+#include "rng.h"
 
 void initLogger() {
 	slog_init("logs", SLOG_FLAGS_ALL, false);
@@ -26,6 +27,6 @@ f32 clamp(const f32 n, const f32 mi, const f32 ma) {
 }
 
 f32 rand_f32(f32 min, f32 max) {
-	f32 scale = (f32)rand() / (f32)RAND_MAX; /* [0, 1.0] */
-	return min + scale * (max - min);      /* [min, max] */
+	f32 scale = rng_float(rng_game()); /* [0, 1.0) */
+	return min + scale * (max - min);  /* [min, max) */
 }
@@ -0,0 +1,192 @@
+//
+// Created by Hector Mejia on 10/17/26.
+//
+
+#include "compiled_map.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// sections start aligned so the structs inside can be read in place.
+#define SECTION_ALIGNMENT 16
+
+static u64 align_up(u64 value);
+static bool tileset_file_path(const char *sourcePath, const char *tilesetPath, char *outPath, usize len);
+static bool tilesets_changed(const CompiledMapHeader *header, const char *sourcePath);
+
+bool compiled_map_write(const char *path, CompiledMapHeader header, const CompiledMapSectionData *sections) {
+	memcpy(header.magic, COMPILED_MAP_MAGIC, sizeof(header.magic));
+	header.version = COMPILED_MAP_VERSION;
+
+	u64 offset = align_up(sizeof(header));
+	for (i32 i = 0; i < CompiledMapSectionCount; i++) {
+		header.sections[i] = (CompiledMapSectionInfo){
+			.offset = offset,
+			.count = sections[i].count,
+			.itemSize = sections[i].itemSize,
+		};
+		offset = align_up(offset + ((u64)sections[i].count * sections[i].itemSize));
+	}
+
+	FILE *file = fopen(path, "wb");
+	if (file == nil) {
+		slogw("could not open %s for writing", path);
+		return false;
+	}
+
+	static const byte padding[SECTION_ALIGNMENT] = {};
+	bool ok = fwrite(&header, sizeof(header), 1, file) == 1;
+	u64 written = sizeof(header);
+	for (i32 i = 0; ok && i < CompiledMapSectionCount; i++) {
+		ok = fwrite(padding, 1, header.sections[i].offset - written, file) == header.sections[i].offset - written;
+		written = header.sections[i].offset;
+
+		const u64 size = (u64)sections[i].count * sections[i].itemSize;
+		if (ok && size > 0) {
+			ok = fwrite(sections[i].data, size, 1, file) == 1;
+		}
+		written += size;
+	}
+
+	ok = fclose(file) == 0 && ok;
+	if (!ok) {
+		slogw("failed to write compiled map %s", path);
+		remove(path);
+	}
+	return ok;
+}
+
+bool compiled_map_open(const char *path, const char *sourcePath, const u32 *itemSizes, CompiledMapFile *outFile) {
+	const i32 fd = open(path, O_RDONLY);
+	if (fd < 0) { return false; }
+
+	struct stat fileStat;
+	if (fstat(fd, &fileStat) != 0 || (usize)fileStat.st_size < sizeof(CompiledMapHeader)) {
+		close(fd);
+		return false;
+	}
+
+	const usize size = (usize)fileStat.st_size;
+	void *data = mmap(nil, size, PROT_READ, MAP_PRIVATE, fd, 0);
+	// the mapping keeps the file alive on its own.
+	close(fd);
+	if (data == MAP_FAILED) {
+		slogw("could not mmap compiled map %s", path);
+		return false;
+	}
+
+	const CompiledMapFile file = {
+		.header = data,
+		.data = data,
+		.size = size,
+	};
+
+	const CompiledMapHeader *header = file.header;
+	const char *reason = nil;
+	i64 sourceSize = 0;
+	i64 sourceModifiedTime = 0;
+	if (memcmp(header->magic, COMPILED_MAP_MAGIC, sizeof(header->magic)) != 0) {
+		reason = "not a compiled map";
+	} else if (header->version != COMPILED_MAP_VERSION) {
+		reason = "written by another version";
+	} else if (!compiled_map_source_info(sourcePath, &sourceSize, &sourceModifiedTime) ||
+			   sourceSize != header->sourceSize ||
+			   sourceModifiedTime != header->sourceModifiedTime) {
+		reason = "the source map changed";
+	} else if (tilesets_changed(header, sourcePath)) {
+		reason = "a tileset changed";
+	}
+
+	for (i32 i = 0; reason == nil && i < CompiledMapSectionCount; i++) {
+		const CompiledMapSectionInfo section = header->sections[i];
+		if (section.itemSize != itemSizes[i]) {
+			reason = "written by a build with different structs";
+		} else if (section.offset + ((u64)section.count * section.itemSize) > size) {
+			reason = "truncated";
+		}
+	}
+
+	if (reason != nil) {
+		slogw("ignoring compiled map %s, %s", path, reason);
+		munmap(data, size);
+		return false;
+	}
+
+	*outFile = file;
+	return true;
+}
+
+void compiled_map_close(CompiledMapFile *file) {
+	if (file->data == nil) { return; }
+
+	munmap((void *)file->data, file->size);
+	*file = (CompiledMapFile){};
+}
+
+const void *compiled_map_section(const CompiledMapFile *file, const CompiledMapSection section, u32 *outCount) {
+	const CompiledMapSectionInfo info = file->header->sections[section];
+	*outCount = info.count;
+	if (info.count == 0) { return nil; }
+
+	return file->data + info.offset;
+}
+
+bool compiled_map_add_tileset(CompiledMapHeader *header, const char *sourcePath, const char *tilesetPath) {
+	if (header->tilesetsCount >= MAX_COMPILED_MAP_TILESETS) {
+		slogw("%s has more than %d tilesets", sourcePath, MAX_COMPILED_MAP_TILESETS);
+		return false;
+	}
+
+	CompiledMapSourceFile *tileset = &header->tilesets[header->tilesetsCount];
+	char path[MAX_COMPILED_MAP_TEXTURE_PATH_LEN * 2];
+	if (snprintf(tileset->path, sizeof(tileset->path), "%s", tilesetPath) >= (i32)sizeof(tileset->path) ||
+		!tileset_file_path(sourcePath, tilesetPath, path, sizeof(path)) ||
+		!compiled_map_source_info(path, &tileset->size, &tileset->modifiedTime)) {
+		slogw("could not find tileset %s of %s", tilesetPath, sourcePath);
+		return false;
+	}
+
+	header->tilesetsCount++;
+	return true;
+}
+
+bool compiled_map_source_info(const char *sourcePath, i64 *outSize, i64 *outModifiedTime) {
+	struct stat sourceStat;
+	if (stat(sourcePath, &sourceStat) != 0) { return false; }
+
+	*outSize = (i64)sourceStat.st_size;
+	*outModifiedTime = (i64)sourceStat.st_mtime;
+	return true;
+}
+
+static u64 align_up(const u64 value) {
+	return (value + SECTION_ALIGNMENT - 1) & ~(u64)(SECTION_ALIGNMENT - 1);
+}
+
+// tileset paths are relative to the folder of the .tmx, like libtmx resolves them.
+static bool tileset_file_path(const char *sourcePath, const char *tilesetPath, char *outPath, const usize len) {
+	const char *slash = strrchr(sourcePath, '/');
+	const i32 dirLen = slash != nil ? (i32)(slash - sourcePath + 1) : 0;
+	return snprintf(outPath, len, "%.*s%s", dirLen, sourcePath, tilesetPath) < (i32)len;
+}
+
+static bool tilesets_changed(const CompiledMapHeader *header, const char *sourcePath) {
+	if (header->tilesetsCount > MAX_COMPILED_MAP_TILESETS) { return true; }
+
+	for (u32 i = 0; i < header->tilesetsCount; i++) {
+		const CompiledMapSourceFile *tileset = &header->tilesets[i];
+		char path[MAX_COMPILED_MAP_TEXTURE_PATH_LEN * 2];
+		i64 size = 0;
+		i64 modifiedTime = 0;
+		// the path came from the file, it may not be terminated.
+		if (memchr(tileset->path, '\0', sizeof(tileset->path)) == nil ||
+			!tileset_file_path(sourcePath, tileset->path, path, sizeof(path)) ||
+			!compiled_map_source_info(path, &size, &modifiedTime) ||
+			size != tileset->size || modifiedTime != tileset->modifiedTime) {
+			return true;
+		}
+	}
+	return false;
+}
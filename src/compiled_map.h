@@ -0,0 +1,157 @@
+//
+// Created by Hector Mejia on 10/17/26.
+//
+
+#ifndef RAYLIB_POKEMON_CLONE_COMPILED_MAP_H
+#define RAYLIB_POKEMON_CLONE_COMPILED_MAP_H
+
+#include "raylib.h"
+#include "common.h"
+
+// A map that went through the Tiled loader once and got written to disk as the
+// arrays the game uses, so loading it is an mmap plus a few copies. The file is
+// only valid for the build that wrote it (the arrays are raw structs), so the
+// header keeps the size of every item and the loader falls back to the .tmx on
+// any mismatch, same as when the .tmx or one of its tilesets changed after
+// compiling.
+#define COMPILED_MAP_MAGIC "CMAP"
+#define COMPILED_MAP_VERSION 4
+#define COMPILED_MAP_EXTENSION ".cmap"
+#define MAX_COMPILED_MAP_TEXTURE_PATH_LEN 256
+#define MAX_COMPILED_MAP_TILESETS 16
+
+// textures are written as an index into the texture table plus one, 0 means no
+// texture.
+typedef enum CompiledMapTextureSource {
+	CompiledMapTextureSourceFile = 0,
+	CompiledMapTextureSourceGrass,
+	CompiledMapTextureSourceIceGrass,
+	CompiledMapTextureSourceSand,
+	CompiledMapTextureSourceCoastLine,
+
+	CompiledMapTextureSourceCount,
+} CompiledMapTextureSource;
+
+typedef struct CompiledMapTexture {
+	CompiledMapTextureSource source;
+	char path[MAX_COMPILED_MAP_TEXTURE_PATH_LEN]; // only for files
+} CompiledMapTexture;
+
+typedef enum CompiledMapSection {
+	CompiledMapSectionTextures = 0,
+	CompiledMapSectionBackgroundSprites,
+	CompiledMapSectionMainSprites,
+	CompiledMapSectionForegroundSprites,
+	CompiledMapSectionWaterSprites,
+	CompiledMapSectionCoastLineSprites,
+	CompiledMapSectionCollisionBoxes,
+	CompiledMapSectionTransitionBoxes,
+	CompiledMapSectionCharacterSpawns,
+	CompiledMapSectionTerrainGids,
+	CompiledMapSectionTerrainTiles,
+	CompiledMapSectionTerrainTopGids,
+	CompiledMapSectionTerrainTopTiles,
+	CompiledMapSectionEncounterPatches,
+
+	CompiledMapSectionCount,
+} CompiledMapSection;
+
+typedef struct CompiledMapSectionInfo {
+	u64 offset;
+	u32 count;
+	u32 itemSize;
+} CompiledMapSectionInfo;
+
+typedef struct CompiledMapTileLayerInfo {
+	i32 columns;
+	i32 rows;
+	f32 tileWidth;
+	f32 tileHeight;
+	i32 usedCells;
+} CompiledMapTileLayerInfo;
+
+// an external .tsx the .tmx pulls in, the path is as written in the .tmx so
+// relative to its folder.
+typedef struct CompiledMapSourceFile {
+	char path[MAX_COMPILED_MAP_TEXTURE_PATH_LEN];
+	i64 size;
+	i64 modifiedTime;
+} CompiledMapSourceFile;
+
+typedef struct CompiledMapHeader {
+	char magic[4];
+	u32 version;
+	// the .tmx the file was compiled from, when it changes the file is stale.
+	i64 sourceSize;
+	i64 sourceModifiedTime;
+	// same for every external tileset, the tiles and their textures come from
+	// those.
+	u32 tilesetsCount;
+	CompiledMapSourceFile tilesets[MAX_COMPILED_MAP_TILESETS];
+
+	Color backgroundColor;
+	Vector2 playerStartingPosition;
+	f32 width;
+	f32 height;
+	CompiledMapTileLayerInfo terrain;
+	CompiledMapTileLayerInfo terrainTop;
+
+	CompiledMapSectionInfo sections[CompiledMapSectionCount];
+} CompiledMapHeader;
+
+typedef struct CompiledMapSectionData {
+	const void *data;
+	u32 count;
+	u32 itemSize;
+} CompiledMapSectionData;
+
+typedef struct CompiledMapFile {
+	const CompiledMapHeader *header;
+	const byte *data;
+	usize size;
+} CompiledMapFile;
+
+/**
+ * Writes the header followed by every section. The section offsets, counts and
+ * item sizes in the header are filled from the given sections.
+ * @param path where to write the file
+ * @param header everything but the magic, version and sections
+ * @param sections CompiledMapSectionCount sections, in CompiledMapSection order
+ * @return true if the whole file was written
+ */
+bool compiled_map_write(const char *path, CompiledMapHeader header, const CompiledMapSectionData *sections);
+
+/**
+ * Records an external tileset of the source .tmx in the header, so the file goes
+ * stale when the tileset changes.
+ * @param header the header that will be written
+ * @param sourcePath the .tmx being compiled
+ * @param tilesetPath the tileset source as written in the .tmx
+ * @return false if the tileset could not be found or there are too many
+ */
+bool compiled_map_add_tileset(CompiledMapHeader *header, const char *sourcePath, const char *tilesetPath);
+
+/**
+ * Maps a compiled map into memory, the file is checked against the given source
+ * .tmx, its tilesets and against the item sizes the caller expects before returning.
+ * @param path the compiled file
+ * @param sourcePath the .tmx it was compiled from
+ * @param itemSizes CompiledMapSectionCount item sizes, in CompiledMapSection order
+ * @param outFile the mapped file, only valid if this returns true
+ * @return false if the file is missing, stale or was written by another build
+ */
+bool compiled_map_open(const char *path, const char *sourcePath, const u32 *itemSizes, CompiledMapFile *outFile);
+void compiled_map_close(CompiledMapFile *file);
+
+/**
+ * Returns the start of a section inside a mapped file, nil if the section is empty.
+ */
+const void *compiled_map_section(const CompiledMapFile *file, CompiledMapSection section, u32 *outCount);
+
+/**
+ * Reads the size and modification time of a file.
+ * @return false if the file could not be found
+ */
+bool compiled_map_source_info(const char *sourcePath, i64 *outSize, i64 *outModifiedTime);
+
+#endif //RAYLIB_POKEMON_CLONE_COMPILED_MAP_H
@@ -0,0 +1,314 @@
+//
+// Created by Hector Mejia on 10/17/26.
+//
+
+#include "draw_buffer.h"
+
+#include <math.h>
+#include <string.h>
+
+#include "rlgl.h"
+#include "gpu_stats.h"
+#include "array/array.h"
+
+// same limits rlgl uses for its default batch, used to estimate when it flushes.
+#define RLGL_BATCH_DRAW_CALLS 256
+#define RLGL_BATCH_QUADS 8192
+// DrawRectangleLinesEx is 4 quads, DrawCircleV is 36 segments drawn 2 per quad.
+#define RECTANGLE_LINES_QUADS 4
+#define CIRCLE_QUADS 18
+
+#define KEY_LAYER_SHIFT 56
+#define KEY_DEPTH_SHIFT 24
+#define KEY_TEXTURE_MASK 0xFFFFFF
+#define RADIX_BITS 8
+#define RADIX_BUCKETS (1 << RADIX_BITS)
+
+typedef struct SortEntry {
+	u64 key;
+	u32 command;
+} SortEntry;
+
+static DrawCommand *commands = nil;
+static SortEntry *entries = nil;
+static SortEntry *scratch = nil;
+static DrawBufferStats stats = {};
+
+static void push_command(DrawLayer layer, f32 depth, DrawCommand command);
+static u32 command_texture_id(const DrawCommand *command);
+static u32 command_shader_id(const DrawCommand *command);
+static i32 command_quads(const DrawCommand *command);
+static u32 quantise_depth(f32 depth);
+static void radix_sort(SortEntry *items, SortEntry *tmp, i32 len);
+static i64 count_texture_switches(const SortEntry *items, i32 len);
+static void submit(const DrawCommand *command);
+
+void draw_buffer_push_texture(
+	const DrawLayer layer,
+	const f32 depth,
+	const Texture2D texture,
+	const Rectangle source,
+	const Vector2 position,
+	const Color tint
+) {
+	push_command(layer, depth, (DrawCommand){
+		.type = DrawCommandTypeTexture,
+		.color = tint,
+		.texture = {
+			.texture = texture,
+			.source = source,
+			.position = position,
+		},
+	});
+}
+
+void draw_buffer_push_shaded_texture(
+	const DrawLayer layer,
+	const f32 depth,
+	const Shader shader,
+	const Texture2D texture,
+	const Rectangle source,
+	const Rectangle dest,
+	const Color tint
+) {
+	push_command(layer, depth, (DrawCommand){
+		.type = DrawCommandTypeShadedTexture,
+		.color = tint,
+		.shadedTexture = {
+			.texture = texture,
+			.source = source,
+			.dest = dest,
+			.shader = shader,
+		},
+	});
+}
+
+void draw_buffer_push_rectangle_lines(
+	const DrawLayer layer,
+	const f32 depth,
+	const Rectangle rect,
+	const f32 thickness,
+	const Color color
+) {
+	push_command(layer, depth, (DrawCommand){
+		.type = DrawCommandTypeRectangleLines,
+		.color = color,
+		.rectangleLines = {
+			.rect = rect,
+			.thickness = thickness,
+		},
+	});
+}
+
+void draw_buffer_push_circle(const DrawLayer layer, const f32 depth, const Vector2 center, const f32 radius, const Color color) {
+	push_command(layer, depth, (DrawCommand){
+		.type = DrawCommandTypeCircle,
+		.color = color,
+		.circle = {
+			.center = center,
+			.radius = radius,
+		},
+	});
+}
+
+void draw_buffer_flush() {
+	const i32 len = array_length(entries);
+	if (len == 0) { return; }
+
+	stats.commands += len;
+	stats.unsortedTextureSwitches += count_texture_switches(entries, len);
+
+	// the scratch buffer only needs to be as big as the entries.
+	while (array_length(scratch) < len) {
+		array_push(scratch, (SortEntry){});
+	}
+	radix_sort(entries, scratch, len);
+	stats.textureSwitches += count_texture_switches(entries, len);
+
+	// replays what rlgl does with its default batch, a new draw call every
+	// time the texture changes and a flush when it runs out of draw calls or
+	// vertex space, or when the shader changes. Headless the gpu_* calls only
+	// count, so the stats are all that comes out of the flush.
+	const GpuSubsystem subsystem = gpu_stats_subsystem();
+	u32 currentTexture = command_texture_id(&commands[entries[0].command]);
+	u32 currentShader = 0;
+	i32 batchDrawCalls = 1;
+	i32 batchQuads = 0;
+	for (i32 i = 0; i < len; i++) {
+		const DrawCommand *command = &commands[entries[i].command];
+		const u32 texture = command_texture_id(command);
+		const u32 shader = command_shader_id(command);
+		const i32 quads = command_quads(command);
+		gpu_stats_set_subsystem(command->subsystem);
+
+		if (shader != currentShader) {
+			if (currentShader != 0) { gpu_end_shader_mode(); }
+			if (shader != 0) { gpu_begin_shader_mode(command->shadedTexture.shader); }
+			currentShader = shader;
+			stats.batchFlushes++;
+			batchDrawCalls = 1;
+			batchQuads = 0;
+		}
+		if (texture != currentTexture) {
+			currentTexture = texture;
+			batchDrawCalls++;
+		}
+		if (batchDrawCalls >= RLGL_BATCH_DRAW_CALLS || batchQuads + quads > RLGL_BATCH_QUADS) {
+			stats.batchFlushes++;
+			batchDrawCalls = 1;
+			batchQuads = 0;
+		}
+		batchQuads += quads;
+
+		submit(command);
+	}
+	gpu_stats_set_subsystem(subsystem);
+	if (currentShader != 0) { gpu_end_shader_mode(); }
+	// whatever is left goes out when the 2D mode ends.
+	stats.batchFlushes++;
+
+	array_clear(commands);
+	array_clear(entries);
+}
+
+DrawBufferStats draw_buffer_stats() {
+	return stats;
+}
+
+void draw_buffer_reset_stats() {
+	stats = (DrawBufferStats){};
+}
+
+void draw_buffer_free() {
+	if (commands != nil) { array_free(commands); }
+	if (entries != nil) { array_free(entries); }
+	if (scratch != nil) { array_free(scratch); }
+	commands = nil;
+	entries = nil;
+	scratch = nil;
+}
+
+static void push_command(const DrawLayer layer, const f32 depth, const DrawCommand command) {
+	panicIf(layer < 0 || layer >= DrawLayerTotal, "invalid draw layer %d", layer);
+
+	const u32 commandIndex = (u32)array_length(commands);
+	array_push(commands, command);
+	// drawn long after it was pushed, it is counted against who pushed it.
+	commands[commandIndex].subsystem = layer == DrawLayerDebug ? GpuSubsystemDebug : gpu_stats_subsystem();
+
+	const u64 key = ((u64)layer << KEY_LAYER_SHIFT) |
+					((u64)quantise_depth(depth) << KEY_DEPTH_SHIFT) |
+					(u64)(command_texture_id(&command) & KEY_TEXTURE_MASK);
+	array_push(entries, ((SortEntry){.key = key, .command = commandIndex}));
+}
+
+static u32 command_texture_id(const DrawCommand *command) {
+	if (command->type == DrawCommandTypeTexture) {
+		return command->texture.texture.id;
+	}
+	if (command->type == DrawCommandTypeShadedTexture) {
+		return command->shadedTexture.texture.id;
+	}
+	// shapes are drawn with the default white texture.
+	return rlGetTextureIdDefault();
+}
+
+// 0 for the default shader.
+static u32 command_shader_id(const DrawCommand *command) {
+	if (command->type == DrawCommandTypeShadedTexture) {
+		return command->shadedTexture.shader.id;
+	}
+	return 0;
+}
+
+static i32 command_quads(const DrawCommand *command) {
+	switch (command->type) {
+		case DrawCommandTypeTexture:
+		case DrawCommandTypeShadedTexture:
+			return 1;
+		case DrawCommandTypeRectangleLines:
+			return RECTANGLE_LINES_QUADS;
+		case DrawCommandTypeCircle:
+			return CIRCLE_QUADS;
+	}
+	panic("unknown draw command type %d", command->type);
+	return 0;
+}
+
+// whole pixels, offset so negative depths (objects hanging off the top of the
+// map) still sort below positive ones as unsigned numbers.
+static u32 quantise_depth(const f32 depth) {
+	const f32 clamped = min(max(floorf(depth), (f32)INT32_MIN), (f32)INT32_MAX);
+	return (u32)((i64)clamped - (i64)INT32_MIN);
+}
+
+// least significant digit first, every pass is a stable counting sort so
+// commands with the same key keep the order they were pushed in. Passes where
+// every key has the same digit are skipped, which is most of them since there
+// are only a few layers and texture ids.
+static void radix_sort(SortEntry *items, SortEntry *tmp, const i32 len) {
+	SortEntry *src = items;
+	SortEntry *dst = tmp;
+
+	for (i32 shift = 0; shift < 64; shift += RADIX_BITS) {
+		i32 counts[RADIX_BUCKETS] = {};
+		for (i32 i = 0; i < len; i++) {
+			counts[(src[i].key >> shift) & (RADIX_BUCKETS - 1)]++;
+		}
+		if (counts[(src[0].key >> shift) & (RADIX_BUCKETS - 1)] == len) {
+			continue;
+		}
+
+		i32 offset = 0;
+		for (i32 b = 0; b < RADIX_BUCKETS; b++) {
+			const i32 count = counts[b];
+			counts[b] = offset;
+			offset += count;
+		}
+		for (i32 i = 0; i < len; i++) {
+			dst[counts[(src[i].key >> shift) & (RADIX_BUCKETS - 1)]++] = src[i];
+		}
+
+		SortEntry *swap = src;
+		src = dst;
+		dst = swap;
+	}
+
+	if (src != items) {
+		memcpy(items, src, sizeof(*items) * len);
+	}
+}
+
+static i64 count_texture_switches(const SortEntry *items, const i32 len) {
+	i64 switches = 0;
+	for (i32 i = 1; i < len; i++) {
+		if ((items[i].key & KEY_TEXTURE_MASK) != (items[i - 1].key & KEY_TEXTURE_MASK)) {
+			switches++;
+		}
+	}
+	return switches;
+}
+
+static void submit(const DrawCommand *command) {
+	switch (command->type) {
+		case DrawCommandTypeTexture:
+			gpu_draw_texture_rec(command->texture.texture, command->texture.source, command->texture.position, command->color);
+			return;
+		case DrawCommandTypeShadedTexture:
+			gpu_draw_texture_pro(
+				command->shadedTexture.texture,
+				command->shadedTexture.source,
+				command->shadedTexture.dest,
+				(Vector2){},
+				0.f,
+				command->color
+			);
+			return;
+		case DrawCommandTypeRectangleLines:
+			gpu_draw_rectangle_lines_ex(command->rectangleLines.rect, command->rectangleLines.thickness, command->color);
+			return;
+		case DrawCommandTypeCircle:
+			gpu_draw_circle_v(command->circle.center, command->circle.radius, command->color);
+			return;
+	}
+}
@@ -0,0 +1,103 @@
+//
+// Created by Hector Mejia on 10/17/26.
+//
+
+#ifndef RAYLIB_POKEMON_CLONE_DRAW_BUFFER_H
+#define RAYLIB_POKEMON_CLONE_DRAW_BUFFER_H
+
+#include "raylib.h"
+#include "common.h"
+#include "gpu_stats.h"
+
+// The order the map is drawn in, from the bottom up. Commands on the same
+// layer and at the same depth can be drawn in any order, so those get grouped
+// by texture to keep rlgl from breaking its batch on every sprite.
+typedef enum DrawLayer {
+	DrawLayerTerrain = 0,
+	DrawLayerTerrainTop,
+	DrawLayerBackground,
+	DrawLayerWater,
+	DrawLayerCoastLine,
+	DrawLayerShadow,
+	DrawLayerMain,
+	DrawLayerForeground,
+	DrawLayerOverlay,
+	DrawLayerDebug,
+
+	DrawLayerTotal,
+} DrawLayer;
+
+typedef enum DrawCommandType {
+	DrawCommandTypeTexture,
+	DrawCommandTypeShadedTexture,
+	DrawCommandTypeRectangleLines,
+	DrawCommandTypeCircle,
+} DrawCommandType;
+
+typedef struct DrawCommand {
+	DrawCommandType type;
+	GpuSubsystem subsystem;
+	Color color;
+	union {
+		struct {
+			Texture2D texture;
+			Rectangle source;
+			Vector2 position;
+		} texture;
+		// stretched over dest with a shader of its own, for things drawn as
+		// one big quad whose look comes from the shader.
+		struct {
+			Texture2D texture;
+			Rectangle source;
+			Rectangle dest;
+			Shader shader;
+		} shadedTexture;
+		struct {
+			Rectangle rect;
+			f32 thickness;
+		} rectangleLines;
+		struct {
+			Vector2 center;
+			f32 radius;
+		} circle;
+	};
+} DrawCommand;
+
+typedef struct DrawBufferStats {
+	i64 commands;
+	// texture changes the commands had in the order they were pushed, and after
+	// being sorted, every change is a new draw call for rlgl.
+	i64 unsortedTextureSwitches;
+	i64 textureSwitches;
+	// estimated times rlgl had to submit its batch, either because it ran out
+	// of draw calls or out of vertices.
+	i64 batchFlushes;
+} DrawBufferStats;
+
+void draw_buffer_push_texture(DrawLayer layer, f32 depth, Texture2D texture, Rectangle source, Vector2 position, Color tint);
+void draw_buffer_push_shaded_texture(
+	DrawLayer layer,
+	f32 depth,
+	Shader shader,
+	Texture2D texture,
+	Rectangle source,
+	Rectangle dest,
+	Color tint
+);
+void draw_buffer_push_rectangle_lines(DrawLayer layer, f32 depth, Rectangle rect, f32 thickness, Color color);
+void draw_buffer_push_circle(DrawLayer layer, f32 depth, Vector2 center, f32 radius, Color color);
+
+/**
+ * Sorts every command pushed since the last flush by layer, depth and texture,
+ * and draws them. Commands with the same key keep the order they were pushed in.
+ */
+void draw_buffer_flush();
+
+/**
+ * Returns the stats accumulated by all the flushes since the last reset.
+ */
+DrawBufferStats draw_buffer_stats();
+void draw_buffer_reset_stats();
+void draw_buffer_free();
+
+#endif //RAYLIB_POKEMON_CLONE_DRAW_BUFFER_H
@@ -0,0 +1,147 @@
+//
+// Created by Hector Mejia on 10/17/26.
+//
+
+#include "encounter_table.h"
+
+#include <math.h>
+
+#include "game_data.h"
+#include "rng.h"
+#include "array/array.h"
+
+static i32 random_column(Rng *rng, i32 len);
+
+EncounterTable encounter_table_new(const EncounterData *data) {
+	EncounterTable table = {};
+	if (data == nil || data->len == 0) { return table; }
+	panicIf(data->len > MAX_ENCOUNTER_SPECIES, "encounter table has %d species, max is %d", data->len, MAX_ENCOUNTER_SPECIES);
+
+	table.len = data->len;
+	f32 totalWeight = 0;
+	for (i32 i = 0; i < data->len; i++) {
+		panicIf(data->entries[i].weight <= 0, "encounter weights must be positive");
+		table.entries[i] = data->entries[i];
+		totalWeight += data->entries[i].weight;
+	}
+
+	// every column holds 1/len of the probability. Columns below that get
+	// topped up by one above it, which becomes their alias.
+	f32 scaled[MAX_ENCOUNTER_SPECIES];
+	i32 small[MAX_ENCOUNTER_SPECIES];
+	i32 large[MAX_ENCOUNTER_SPECIES];
+	i32 smallLen = 0;
+	i32 largeLen = 0;
+	for (i32 i = 0; i < table.len; i++) {
+		scaled[i] = table.entries[i].weight * (f32)table.len / totalWeight;
+		if (scaled[i] < 1.f) {
+			small[smallLen++] = i;
+		} else {
+			large[largeLen++] = i;
+		}
+	}
+	while (smallLen > 0 && largeLen > 0) {
+		const i32 less = small[--smallLen];
+		const i32 more = large[--largeLen];
+		table.probability[less] = scaled[less];
+		table.alias[less] = more;
+
+		scaled[more] = (scaled[more] + scaled[less]) - 1.f;
+		if (scaled[more] < 1.f) {
+			small[smallLen++] = more;
+		} else {
+			large[largeLen++] = more;
+		}
+	}
+	// whatever is left is 1 give or take float error.
+	while (largeLen > 0) {
+		const i32 i = large[--largeLen];
+		table.probability[i] = 1.f;
+		table.alias[i] = i;
+	}
+	while (smallLen > 0) {
+		const i32 i = small[--smallLen];
+		table.probability[i] = 1.f;
+		table.alias[i] = i;
+	}
+	return table;
+}
+
+bool encounter_table_matches(const EncounterTable *table, const EncounterData *data) {
+	if (table->len != data->len) { return false; }
+
+	for (i32 i = 0; i < table->len; i++) {
+		const EncounterEntry *entryA = &table->entries[i];
+		const EncounterEntry *entryB = &data->entries[i];
+		if (entryA->monster != entryB->monster ||
+			entryA->weight != entryB->weight ||
+			entryA->minLevel != entryB->minLevel ||
+			entryA->maxLevel != entryB->maxLevel) {
+			return false;
+		}
+	}
+	return true;
+}
+
+i32 encounter_table_pick(const EncounterTable *table, const i32 column, const f32 coin) {
+	return coin < table->probability[column] ? column : table->alias[column];
+}
+
+bool encounter_table_roll(const EncounterTable *table, Monster *outMonster) {
+	if (table->len == 0) { return false; }
+
+	Rng *rng = rng_game();
+	const EncounterEntry entry = table->entries[encounter_table_pick(table, random_column(rng, table->len), rng_float(rng))];
+	*outMonster = monster_new(entry.monster, (u8)rng_range(rng, entry.minLevel, entry.maxLevel));
+	return true;
+}
+
+void encounter_tables_bench(const EncounterData *data, const i32 rolls) {
+	panicIf(rolls <= 0, "benchmark needs at least one roll");
+
+	// the same rolls on every run.
+	Rng rng = rng_new(1, 0);
+	array_range(data, t) {
+		const EncounterTable table = encounter_table_new(&data[t]);
+		i64 counts[MAX_ENCOUNTER_SPECIES] = {};
+
+		const clock_t start = clock();
+		for (i32 r = 0; r < rolls; r++) {
+			counts[encounter_table_pick(&table, random_column(&rng, table.len), rng_float(&rng))]++;
+		}
+		const f64 elapsedNs = ((f64)(clock() - start) / CLOCKS_PER_SEC) * 1e9;
+
+		f32 totalWeight = 0;
+		for (i32 i = 0; i < table.len; i++) {
+			totalWeight += table.entries[i].weight;
+		}
+
+		printfln(
+			"%s/%s: %d species, %d rolls, %.1f ns per roll",
+			data[t].map,
+			biome_string(data[t].biome),
+			table.len,
+			rolls,
+			elapsedNs / rolls
+		);
+		printfln("%-14s %10s %10s %10s", "monster", "expected", "sampled", "error");
+		f64 worstError = 0;
+		for (i32 i = 0; i < table.len; i++) {
+			const f64 expected = table.entries[i].weight / totalWeight;
+			const f64 sampled = (f64)counts[i] / rolls;
+			worstError = fmax(worstError, fabs(sampled - expected));
+			printfln(
+				"%-14s %9.3f%% %9.3f%% %9.3f%%",
+				game_data_for_monster_id(table.entries[i].monster)->name,
+				expected * 100.0,
+				sampled * 100.0,
+				(sampled - expected) * 100.0
+			);
+		}
+		printfln("worst error %.3f%%\n", worstError * 100.0);
+	}
+}
+
+static i32 random_column(Rng *rng, const i32 len) {
+	return rng_range(rng, 0, len - 1);
+}
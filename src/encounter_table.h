@@ -0,0 +1,83 @@
+//
+// Created by Hector Mejia on 10/17/26.
+//
+
+#ifndef RAYLIB_POKEMON_CLONE_ENCOUNTER_TABLE_H
+#define RAYLIB_POKEMON_CLONE_ENCOUNTER_TABLE_H
+
+#include "common.h"
+#include "monsters.h"
+#include "biome_grid.h"
+
+#define MAX_ENCOUNTER_SPECIES 16
+#define MAX_ENCOUNTER_MAP_NAME_LEN 32
+// how far from its level property a patch's monsters can be.
+#define ENCOUNTER_PATCH_LEVEL_SPREAD 3
+
+typedef struct EncounterEntry {
+	MonsterID monster;
+	f32 weight;
+	u8 minLevel;
+	u8 maxLevel;
+} EncounterEntry;
+
+// What can show up in one biome of one map, as read from encounter_data.json.
+typedef struct EncounterData {
+	char map[MAX_ENCOUNTER_MAP_NAME_LEN];
+	Biome biome;
+	i32 len;
+	EncounterEntry entries[MAX_ENCOUNTER_SPECIES];
+} EncounterData;
+
+// One object of a map's Monsters layer. A patch with a monsters property rolls
+// the species it lists, all equally likely, around its level property. One
+// without rolls from the table encounter_data.json has for its biome.
+typedef struct EncounterPatch {
+	Rectangle area;
+	Biome biome;
+	EncounterData encounters; // len 0 when the patch lists no monsters
+} EncounterPatch;
+
+// The entries of an EncounterData plus Walker's alias tables over their
+// weights. A roll picks a column uniformly, then keeps it with the column's
+// probability or takes its alias, so it costs the same however many species
+// the table has.
+typedef struct EncounterTable {
+	i32 len;
+	EncounterEntry entries[MAX_ENCOUNTER_SPECIES];
+	f32 probability[MAX_ENCOUNTER_SPECIES];
+	i32 alias[MAX_ENCOUNTER_SPECIES];
+} EncounterTable;
+
+/**
+ * Builds the alias tables for the given entries (Vose's version, linear in the
+ * number of entries).
+ * @param data the species and their weights, weights must be positive
+ * @return a table with len 0 if data is nil
+ */
+EncounterTable encounter_table_new(const EncounterData *data);
+
+// true if the table was built from the same species, weights and levels.
+bool encounter_table_matches(const EncounterTable *table, const EncounterData *data);
+
+/**
+ * Picks an entry index with the probability of its weight.
+ * @param table a table with at least one entry
+ * @param column uniform in [0, len)
+ * @param coin uniform in [0, 1)
+ */
+i32 encounter_table_pick(const EncounterTable *table, i32 column, f32 coin);
+
+/**
+ * Rolls a wild monster, species by weight and level uniform in its range.
+ * @return false if the table is empty
+ */
+bool encounter_table_roll(const EncounterTable *table, Monster *outMonster);
+
+/**
+ * Rolls every table many times and prints the share each species got next to
+ * the share its weight asks for, and how long a roll takes.
+ */
+void encounter_tables_bench(const EncounterData *data, i32 rolls);
+
+#endif //RAYLIB_POKEMON_CLONE_ENCOUNTER_TABLE_H
@@ -0,0 +1,212 @@
+//
+// Created by Hector Mejia on 10/17/26.
+//
+
+#include "frame_stats.h"
+
+#include <math.h>
+
+#include "profiler.h"
+
+#define SUB_BUCKETS (1 << FRAME_STATS_SUB_BUCKET_BITS)
+#define HISTOGRAM_BUCKETS ((FRAME_STATS_MAX_US_BITS - FRAME_STATS_SUB_BUCKET_BITS + 1) << FRAME_STATS_SUB_BUCKET_BITS)
+#define MAX_US ((1ull << FRAME_STATS_MAX_US_BITS) - 1)
+
+static const char *phaseNames[FrameStatsPhaseCount] = {
+	[FrameStatsPhaseInput] = "input",
+	[FrameStatsPhaseUpdate] = "update",
+	[FrameStatsPhaseDraw] = "draw",
+	[FrameStatsPhasePresent] = "present",
+	[FrameStatsPhaseTotal] = "total",
+};
+
+// perf_counter_name has spaces in it.
+static const char *perfCounterColumns[PerfCounterCount] = {
+	[PerfCounterCycles] = "cycles",
+	[PerfCounterInstructions] = "instructions",
+	[PerfCounterCacheMisses] = "cache_misses",
+	[PerfCounterBranchMisses] = "branch_misses",
+	[PerfCounterPageFaults] = "page_faults",
+};
+
+static struct {
+	FrameSample history[FRAME_STATS_HISTORY_LEN];
+	i32 next;
+	i32 len;
+	u64 frames;
+	u32 buckets[FrameStatsPhaseCount][HISTOGRAM_BUCKETS];
+	u64 sumUs[FrameStatsPhaseCount];
+	u64 lastPushNs;
+} frameStats = {};
+
+static u64 ms_to_us(f32 ms);
+static i32 bucket_index(u64 us);
+static u64 bucket_top(i32 index);
+static void histogram_update(const FrameSample *sample, bool adding);
+
+void frame_stats_push(FrameSample sample) {
+	const u64 now = profiler_now_ns();
+	if (sample.ms[FrameStatsPhaseTotal] == 0) {
+		if (frameStats.lastPushNs != 0) {
+			sample.ms[FrameStatsPhaseTotal] = (f32)((f64)(now - frameStats.lastPushNs) / 1e6);
+		} else {
+			for (i32 phase = 0; phase < FrameStatsPhaseTotal; phase++) {
+				sample.ms[FrameStatsPhaseTotal] += sample.ms[phase];
+			}
+		}
+	}
+	frameStats.lastPushNs = now;
+
+	if (frameStats.len == FRAME_STATS_HISTORY_LEN) {
+		histogram_update(&frameStats.history[frameStats.next], false);
+	} else {
+		frameStats.len++;
+	}
+	frameStats.history[frameStats.next] = sample;
+	histogram_update(&sample, true);
+	frameStats.next = (frameStats.next + 1) % FRAME_STATS_HISTORY_LEN;
+	frameStats.frames++;
+}
+
+void frame_stats_reset() {
+	frameStats = (typeof(frameStats)){};
+}
+
+i32 frame_stats_len() {
+	return frameStats.len;
+}
+
+u64 frame_stats_frames() {
+	return frameStats.frames;
+}
+
+FrameSample frame_stats_sample(const i32 age) {
+	panicIf(age < 0 || age >= frameStats.len, "frame stats sample %d out of %d", age, frameStats.len);
+	const i32 index = (frameStats.next - 1 - age + FRAME_STATS_HISTORY_LEN) % FRAME_STATS_HISTORY_LEN;
+	return frameStats.history[index];
+}
+
+f64 frame_stats_percentile(const FrameStatsPhase phase, const f64 percentile) {
+	if (frameStats.len == 0) { return 0; }
+
+	// the smallest time with at least percentile% of the frames at or below it.
+	const u64 target = max((u64)ceil(min(max(percentile, 0.0), 100.0) / 100.0 * frameStats.len), 1ull);
+	const u32 *buckets = frameStats.buckets[phase];
+	u64 seen = 0;
+	for (i32 i = 0; i < HISTOGRAM_BUCKETS; i++) {
+		seen += buckets[i];
+		if (seen >= target) {
+			return (f64)bucket_top(i) / 1000.0;
+		}
+	}
+	return (f64)MAX_US / 1000.0;
+}
+
+FrameStatsSummary frame_stats_summary(const FrameStatsPhase phase) {
+	if (frameStats.len == 0) { return (FrameStatsSummary){}; }
+
+	// the max is read from the frames themselves, the histogram would round it
+	// up, and it caps the percentiles so the top bucket can't go over it.
+	f64 maxMs = 0;
+	for (i32 i = 0; i < frameStats.len; i++) {
+		maxMs = max(maxMs, (f64)frameStats.history[i].ms[phase]);
+	}
+	return (FrameStatsSummary){
+		.p50 = min(frame_stats_percentile(phase, 50), maxMs),
+		.p95 = min(frame_stats_percentile(phase, 95), maxMs),
+		.p99 = min(frame_stats_percentile(phase, 99), maxMs),
+		.max = maxMs,
+		.mean = (f64)frameStats.sumUs[phase] / frameStats.len / 1000.0,
+	};
+}
+
+const char *frame_stats_phase_name(const FrameStatsPhase phase) {
+	return phaseNames[phase];
+}
+
+bool frame_stats_export_csv(const char *path) {
+	FILE *file = fopen(path, "w");
+	if (file == nil) {
+		slogw("could not open %s for writing", path);
+		return false;
+	}
+
+	fprintf(file, "frame,map,ticks");
+	for (i32 phase = 0; phase < FrameStatsPhaseCount; phase++) {
+		fprintf(file, ",%s_ms", phaseNames[phase]);
+	}
+	for (i32 counter = 0; counter < PerfCounterCount; counter++) {
+		if (perf_counters_available(counter)) {
+			fprintf(file, ",%s", perfCounterColumns[counter]);
+		}
+	}
+	fprintf(file, "\n");
+
+	const u64 firstFrame = frameStats.frames - frameStats.len;
+	for (i32 age = frameStats.len - 1; age >= 0; age--) {
+		const FrameSample sample = frame_stats_sample(age);
+		fprintf(
+			file,
+			"%llu,%d,%d",
+			(unsigned long long)(firstFrame + (frameStats.len - 1 - age)),
+			sample.mapID,
+			sample.simulationTicks
+		);
+		for (i32 phase = 0; phase < FrameStatsPhaseCount; phase++) {
+			fprintf(file, ",%.4f", sample.ms[phase]);
+		}
+		for (i32 counter = 0; counter < PerfCounterCount; counter++) {
+			if (perf_counters_available(counter)) {
+				fprintf(file, ",%llu", (unsigned long long)sample.perf.counts[counter]);
+			}
+		}
+		fprintf(file, "\n");
+	}
+
+	if (fclose(file) != 0) {
+		slogw("failed to write frame stats %s", path);
+		return false;
+	}
+	slogi("wrote %d frames of stats to %s", frameStats.len, path);
+	return true;
+}
+
+static u64 ms_to_us(const f32 ms) {
+	if (ms <= 0) { return 0; }
+	return min((u64)llround((f64)ms * 1000.0), MAX_US);
+}
+
+// below SUB_BUCKETS every microsecond has a bucket, above it every power of
+// two is split into SUB_BUCKETS buckets by the bits under the top one.
+static i32 bucket_index(const u64 us) {
+	if (us < SUB_BUCKETS) { return (i32)us; }
+
+	const i32 topBit = 63 - __builtin_clzll(us);
+	const i32 shift = topBit - FRAME_STATS_SUB_BUCKET_BITS;
+	const i32 sub = (i32)((us >> shift) & (SUB_BUCKETS - 1));
+	return ((shift + 1) << FRAME_STATS_SUB_BUCKET_BITS) + sub;
+}
+
+// the largest time that lands in the bucket.
+static u64 bucket_top(const i32 index) {
+	if (index < SUB_BUCKETS) { return (u64)index; }
+
+	const i32 shift = (index >> FRAME_STATS_SUB_BUCKET_BITS) - 1;
+	const u64 sub = (u64)(index & (SUB_BUCKETS - 1));
+	const u64 bottom = (SUB_BUCKETS + sub) << shift;
+	return bottom + (1ull << shift) - 1;
+}
+
+// adds the frame when adding, takes it back out otherwise.
+static void histogram_update(const FrameSample *sample, const bool adding) {
+	for (i32 phase = 0; phase < FrameStatsPhaseCount; phase++) {
+		const u64 us = ms_to_us(sample->ms[phase]);
+		if (adding) {
+			frameStats.buckets[phase][bucket_index(us)]++;
+			frameStats.sumUs[phase] += us;
+		} else {
+			frameStats.buckets[phase][bucket_index(us)]--;
+			frameStats.sumUs[phase] -= us;
+		}
+	}
+}
@@ -0,0 +1,87 @@
+//
+// Created by Hector Mejia on 10/17/26.
+//
+
+#ifndef RAYLIB_POKEMON_CLONE_FRAME_STATS_H
+#define RAYLIB_POKEMON_CLONE_FRAME_STATS_H
+
+#include "common.h"
+#include "perf_counters.h"
+
+// The last FRAME_STATS_HISTORY_LEN frames, one time per phase, with a
+// histogram of the same frames kept next to them so percentiles don't need a
+// sort. The histogram buckets are log-linear over microseconds (HdrHistogram
+// style): exact below 2^FRAME_STATS_SUB_BUCKET_BITS us, then that many buckets
+// per power of two, which keeps every bucket within ~3% of the times in it.
+// A frame that falls out of the history is taken back out of the histogram,
+// so the percentiles are always of the frames still in the history.
+#define FRAME_STATS_HISTORY_LEN 4096
+#define FRAME_STATS_SUB_BUCKET_BITS 5
+// anything longer than ~67s goes into the last bucket.
+#define FRAME_STATS_MAX_US_BITS 26
+#define FRAME_STATS_CSV_PATH "./frame_stats.csv"
+
+typedef enum FrameStatsPhase {
+	FrameStatsPhaseInput = 0,
+	FrameStatsPhaseUpdate,
+	FrameStatsPhaseDraw,
+	// EndDrawing, the buffer swap and whatever vsync waits.
+	FrameStatsPhasePresent,
+	// from the end of the last frame to the end of this one, everything
+	// outside the phases too (polling events, replay waits).
+	FrameStatsPhaseTotal,
+
+	FrameStatsPhaseCount,
+} FrameStatsPhase;
+
+typedef struct FrameSample {
+	f32 ms[FrameStatsPhaseCount];
+	i32 simulationTicks;
+	i32 mapID;
+	// input, update and draw together, zeros unless perf counters are on.
+	PerfCounterValues perf;
+} FrameSample;
+
+typedef struct FrameStatsSummary {
+	f64 p50;
+	f64 p95;
+	f64 p99;
+	f64 max;
+	f64 mean;
+} FrameStatsSummary;
+
+/**
+ * Adds a frame to the history, overwriting the oldest one when it is full.
+ * The total is filled in here when it is 0, with the time since the last call
+ * (or the sum of the phases on the first one).
+ */
+void frame_stats_push(FrameSample sample);
+void frame_stats_reset();
+i32 frame_stats_len();
+// frames pushed since the last reset, including the ones that fell out.
+u64 frame_stats_frames();
+
+/**
+ * Returns a frame from the history.
+ * @param age 0 for the last frame pushed, up to frame_stats_len() - 1
+ */
+FrameSample frame_stats_sample(i32 age);
+
+/**
+ * Reads a percentile out of the histogram, as the top of the bucket it falls
+ * into so it never comes out better than the frames were.
+ * @param percentile from 0 to 100
+ * @return the time in ms, 0 with no frames
+ */
+f64 frame_stats_percentile(FrameStatsPhase phase, f64 percentile);
+FrameStatsSummary frame_stats_summary(FrameStatsPhase phase);
+const char *frame_stats_phase_name(FrameStatsPhase phase);
+
+/**
+ * Writes the history as CSV, one row per frame from the oldest, with the
+ * counters of the perf counters that are open.
+ * @return false if the file could not be written
+ */
+bool frame_stats_export_csv(const char *path);
+
+#endif //RAYLIB_POKEMON_CLONE_FRAME_STATS_H
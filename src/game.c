@@ -5,6 +5,7 @@
 #include "game.h"
 
 #include <tmx_utils.h>
+#include <math.h>
 #include <raymath.h>
 
 #include "common.h"
@@ -12,23 +13,46 @@
 #include "maps_manager.h"
 #include "assets.h"
 #include "colors.h"
+#include "draw_buffer.h"
+#include "frame_stats.h"
+#include "gpu_stats.h"
+#include "map_cache.h"
+#include "texture_cache.h"
 #include "game_data.h"
 #include "settings.h"
+#include "input.h"
+#include "platform.h"
+#include "profiler.h"
+#include "replay.h"
+#include "sampler.h"
+#include "watchdog.h"
+#include "rng.h"
 #include "array/array.h"
 #include "monster_battle.h"
 #include "raylib_extras.h"
 
 //
 static void setup_game(MapID mapID);
-static void update_camera();
+static void update_camera(Vector2 target);
 static void game_draw_dialog_box();
 static void game_draw_debug_camera();
 static void game_draw_debug_screen();
+static void game_draw_debug_profiler_zones();
+static void append_perf_counters(char *text, usize size);
+static void append_frame_stats(char *text, usize size);
+static void append_gpu_stats(char *text, usize size);
+static void game_draw_debug_frame_graph();
+static void push_frame_stats();
+static const char *game_mode_string(GameModeState mode);
 static void do_map_transition_check();
+static void prefetch_nearby_maps();
 static void handle_screen_transition(f32 dt);
+static Map *wait_for_map(MapID mapID);
+static f64 ms_since(u64 startNs);
 static void game_draw_fade_transition();
-static void game_load_map(MapID mapID);
+static void game_set_map(Map *map);
 static void game_over_draw();
+static void game_draw_window();
 
 MapID startingMap = MapIDWorld;
 
@@ -50,12 +74,15 @@ void game_init() {
 }
 
 void game_shutdown() {
+	map_cache_shutdown();
 	map_free(game.currentMap);
 	game.currentMap = nil;
 
 	unload_assets();
 	unload_shaders();
+	texture_cache_shutdown();
 	game_data_free();
+	draw_buffer_free();
 
 	if (IsMusicStreamPlaying(assets.music.overWorld)) {
 		StopMusicStream(assets.music.overWorld);
@@ -63,18 +90,51 @@ void game_shutdown() {
 }
 
 static void do_game_handle_input() {
-	if (game.isDebug && IsKeyPressed(KEY_F1)) {
+	if (game.isDebug && input_key_pressed(KEY_F1)) {
 		frameStepMode = !frameStepMode;
 		shouldRenderFrame = false;
 		return;
 	}
 
-	if (game.isDebug && frameStepMode && IsKeyPressed(KEY_SPACE)) {
+	if (game.isDebug && input_key_pressed(KEY_F3)) {
+		settings.bakeTerrainChunks = !settings.bakeTerrainChunks;
+		return;
+	}
+
+	if (game.isDebug && input_key_pressed(KEY_F4)) {
+		profiler_export_chrome_trace(PROFILER_TRACE_PATH);
+		return;
+	}
+
+	if (game.isDebug && input_key_pressed(KEY_F6)) {
+		if (perf_counters_enabled()) {
+			perf_counters_shutdown();
+		} else {
+			perf_counters_init();
+		}
+		return;
+	}
+
+	if (game.isDebug && input_key_pressed(KEY_F5)) {
+		if (sampler_running()) {
+			sampler_stop(SAMPLER_FOLDED_PATH);
+		} else {
+			sampler_start(SAMPLER_DEFAULT_HZ);
+		}
+		return;
+	}
+
+	if (game.isDebug && input_key_pressed(KEY_F7)) {
+		frame_stats_export_csv(FRAME_STATS_CSV_PATH);
+		return;
+	}
+
+	if (game.isDebug && frameStepMode && input_key_pressed(KEY_SPACE)) {
 		shouldRenderFrame = true;
 		return;
 	}
 
-	if (IsKeyPressed(KEY_F2)) {
+	if (input_key_pressed(KEY_F2)) {
 		game.isDebug = !game.isDebug;
 		frameStepMode = false;
 		shouldRenderFrame = true;
@@ -94,7 +154,7 @@ static void do_game_handle_input() {
 			//  instead. add the key press to the global event
 			//  https://github.com/raysan5/raylib/blob/52f2a10db610d0e9f619fd7c521db08a876547d0/src/rcore.c#L297
 			player_input(&game.player);
-			if (IsKeyPressed(KEY_ENTER)) {
+			if (input_key_pressed(KEY_ENTER)) {
 				game.gameModeState = GameModeMonsterIndex;
 				game.monsterIndex.state.partyLength = player_party_length();
 
@@ -121,39 +181,39 @@ static void do_game_handle_input() {
 void game_handle_input() {
 	static i32 screenHeight = 0;
 	static i32 screenWidth = 0;
-	if (GetScreenHeight() != screenHeight || GetScreenWidth() != screenWidth) {
-		screenHeight = GetScreenHeight();
-		screenWidth = GetScreenWidth();
+	if (platform_screen_height() != screenHeight || platform_screen_width() != screenWidth) {
+		screenHeight = platform_screen_height();
+		screenWidth = platform_screen_width();
 		printf("screen size changed to %dx%d\n", screenWidth, screenHeight);
 	}
-	const clock_t now = clock();
+	PROFILE_FUNCTION();
+	const u64 start = profiler_now_ns();
+	const PerfCounterValues perfStart = perf_counters_read();
+	input_begin_frame();
 	do_game_handle_input();
-	game.gameMetrics.timeInInput = ((double)(clock() - now)) / (CLOCKS_PER_SEC / 1000);
+	game.gameMetrics.timeInInput = ms_since(start);
+	game.gameMetrics.perfInput = perf_counters_since(perfStart);
+}
+
+static BattleStageBackground battle_background_for_biome(const Biome biome) {
+	switch (biome) {
+		case BiomeIce:
+			return BattleStageBackgroundIce;
+		case BiomeSand:
+			return BattleStageBackgroundSand;
+		default:
+			return BattleStageBackgroundForest;
+	}
 }
 
 static void check_player_random_encounter(void) {
 	// monster patches
-	bool walkingOnGrass = false;
+	Biome biome = BiomeNone;
+	const EncounterTable *encounters = nil;
 	if (game.gameModeState == GameModePlaying) {
-		array_range(game.currentMap->mainSprites, i) {
-			const StaticSprite sprite = game.currentMap->mainSprites[i];
-			const Rectangle box = rectangle_at(sprite.sourceFrame, sprite.entity.position);
-			if (sprite.type == StaticSpriteTypeMonsterEncounter &&
-				CheckCollisionRecs(game.player.characterComponent.hitBox, box)) {
-				walkingOnGrass = true;
-				break;
-			}
-		}
-		array_range(game.currentMap->backgroundSprites, i) {
-			const StaticSprite sprite = game.currentMap->backgroundSprites[i];
-			const Rectangle box = rectangle_at(sprite.sourceFrame, sprite.entity.position);
-			if (sprite.type == StaticSpriteTypeMonsterEncounter &&
-				CheckCollisionRecs(game.player.characterComponent.hitBox, box)) {
-				walkingOnGrass = true;
-				break;
-			}
-		}
+		biome = map_biome_under(game.currentMap, game.player.characterComponent.hitBox, &encounters);
 	}
+	const bool walkingOnGrass = biome != BiomeNone;
 	if (!walkingOnGrass && timer_is_valid(game.timers.monsterEncounterTimer)) {
 		timer_stop(&game.timers.monsterEncounterTimer);
 	} else if (walkingOnGrass && !timer_is_valid(game.timers.monsterEncounterTimer)) {
@@ -164,20 +224,20 @@ static void check_player_random_encounter(void) {
 		timer_stop(&game.timers.monsterEncounterTimer);
 #define randomMonstersLen 3
 
-		// todo get the monsters from Tiled
-		const MonsterID monster = (rand() % MonsterIDCount) + 1;
-		Monster monsters[randomMonstersLen] = {
-			monster_new(monster, 10),
-		};
-		game_start_battle(BattleTypeWildEncounter, BattleStageBackgroundForest, monsters, randomMonstersLen);
+		Monster monsters[randomMonstersLen] = {};
+		if (encounters == nil || !encounter_table_roll(encounters, &monsters[0])) {
+			slogw("no encounter table for %s on map %d", biome_string(biome), game.currentMap->id);
+			return;
+		}
+		game_start_battle(BattleTypeWildEncounter, battle_background_for_biome(biome), monsters, randomMonstersLen);
 	}
 }
 
 static void do_game_update(const f32 deltaTime) {
+	PROFILE_ZONE("tick");
 	if (frameStepMode && !shouldRenderFrame) {
 		return;
 	}
-	UpdateMusicStream(assets.music.overWorld);
 	do_map_transition_check();
 	map_update(game.currentMap, deltaTime);
 	player_update(&game.player, deltaTime);
@@ -185,45 +245,337 @@ static void do_game_update(const f32 deltaTime) {
 	monster_index_update(deltaTime);
 	monster_battle_update(deltaTime);
 
-	update_camera();
+	update_camera(player_get_center(&game.player));
 	handle_screen_transition(deltaTime);
 }
 
-void game_update(const f32 deltaTime) {
-	const clock_t now = clock();
-	do_game_update(deltaTime);
-	game.gameMetrics.timeInUpdate = ((double)(clock() - now)) / (CLOCKS_PER_SEC / 1000);
+// the frame time goes into an accumulator that is spent in fixed ticks, so
+// movement, timers and animations come out the same at any frame rate, and a
+// long frame (a map load) can't move anyone through a wall in one step.
+void game_update(const f32 frameTime) {
+	static f64 accumulator = 0;
+	const f64 tick = 1.0 / settings.simulationTickRate;
+
+	PROFILE_FUNCTION();
+	const u64 start = profiler_now_ns();
+	const PerfCounterValues perfStart = perf_counters_read();
+	accumulator += frameTime;
+	i32 ticks = 0;
+	while (accumulator >= tick && ticks < settings.maxTicksPerFrame) {
+		do_game_update((f32)tick);
+		accumulator -= tick;
+		ticks++;
+	}
+	// too far behind to catch up, drop the whole ticks we couldn't run instead
+	// of making the next frames even longer.
+	if (accumulator >= tick) {
+		accumulator = fmod(accumulator, tick);
+	}
+	game.interpolation = (f32)(accumulator / tick);
+
+	// once a frame whatever the ticks, the upload budget is per frame and a
+	// frame catching up on ticks is already late.
+	UpdateMusicStream(assets.music.overWorld);
+	prefetch_nearby_maps();
+	map_cache_update(settings.mapUploadBudgetSecs);
+
+	game.gameMetrics.simulationTicks = ticks;
+	game.gameMetrics.timeInUpdate = ms_since(start);
+	game.gameMetrics.perfUpdate = perf_counters_since(perfStart);
+}
+
+// follows the player where it is drawn, between ticks.
+static void update_camera_for_draw() {
+	const Rectangle playerFrame = game.player.characterComponent.frame;
+	update_camera(Vector2Add(
+		character_render_position(&game.player.characterComponent),
+		(Vector2){playerFrame.width / 2, playerFrame.height / 2}
+	));
+}
+
+// what a frame adds up to without a window, for the headless benchmark.
+static struct {
+	DrawBufferStats drawBuffer;
+	GpuStats gpu;
+	i64 drawnSprites;
+	i64 visitedChunks;
+} headlessDrawTotals = {};
+
+// the map goes through the draw buffer like always, so its traversal, culling
+// and sorting are all there, it is only never submitted. The UI is skipped,
+// it is raylib text and shapes all the way down.
+static void game_draw_headless() {
+	update_camera_for_draw();
+	gpu_stats_set_subsystem(GpuSubsystemMap);
+	map_prepare_draw(game.currentMap);
+	map_draw(game.currentMap);
+	gpu_stats_set_subsystem(GpuSubsystemUi);
+
+	const DrawBufferStats stats = draw_buffer_stats();
+	headlessDrawTotals.drawBuffer.commands += stats.commands;
+	headlessDrawTotals.drawBuffer.textureSwitches += stats.textureSwitches;
+	headlessDrawTotals.drawBuffer.unsortedTextureSwitches += stats.unsortedTextureSwitches;
+	headlessDrawTotals.drawBuffer.batchFlushes += stats.batchFlushes;
+	headlessDrawTotals.drawnSprites += game.gameMetrics.drawnSprites;
+	headlessDrawTotals.visitedChunks += game.gameMetrics.visitedChunks;
 }
 
 void game_draw() {
-	const clock_t now = clock();
+	// closed by hand, the frame ends right after it.
+	profiler_begin("game_draw");
+	const u64 start = profiler_now_ns();
+	const PerfCounterValues perfStart = perf_counters_read();
+	if (platform_is_headless()) {
+		game_draw_headless();
+	} else {
+		game_draw_window();
+	}
+	game.gameMetrics.timeInDraw = ms_since(start) - game.gameMetrics.timeInPresent;
+	game.gameMetrics.perfDraw = perf_counters_since(perfStart);
+	profiler_end();
+	profiler_frame_end();
+	push_frame_stats();
+	watchdog_end_frame(
+		game_mode_string(game.gameModeState),
+		game.currentMap != nil ? (i32)game.currentMap->id : -1
+	);
+	game.gameMetrics.drawnSprites = 0;
+	game.gameMetrics.drawCalls = 0;
+	game.gameMetrics.visitedChunks = 0;
+	game.gameMetrics.collisionCandidates = 0;
+	draw_buffer_reset_stats();
+	gpu_stats_frame_end();
+}
+
+// every draw is counted against the subsystem set before it, the ui unless
+// something else says so.
+static void game_draw_window() {
 	BeginDrawing();
 	{
 		ClearBackground(DARKGRAY);
-		BeginMode2D(game.camera);
+		update_camera_for_draw();
+		gpu_stats_set_subsystem(GpuSubsystemMap);
+		map_prepare_draw(game.currentMap);
+		gpu_stats_set_subsystem(GpuSubsystemUi);
+		gpu_begin_mode_2d(game.camera);
 		{
+			gpu_stats_set_subsystem(GpuSubsystemMap);
 			map_draw(game.currentMap);
 			// player_draw(game.player);
+			gpu_stats_set_subsystem(GpuSubsystemUi);
 			game_draw_dialog_box();
+			gpu_stats_set_subsystem(GpuSubsystemDebug);
 			game_draw_debug_camera();
+			gpu_stats_set_subsystem(GpuSubsystemUi);
 		}
-		EndMode2D();
+		gpu_end_mode_2d();
 
 		game_draw_fade_transition();
+		gpu_stats_set_subsystem(GpuSubsystemMonsterIndex);
 		monster_index_draw();
+		gpu_stats_set_subsystem(GpuSubsystemBattle);
 		monster_battle_draw();
+		gpu_stats_set_subsystem(GpuSubsystemUi);
 
 		game_over_draw();
 
 		// last thing we draw
+		gpu_stats_set_subsystem(GpuSubsystemDebug);
 		game_draw_debug_screen();
+		gpu_stats_set_subsystem(GpuSubsystemUi);
 	}
-	EndDrawing();
+	const u64 presentStart = profiler_now_ns();
+	gpu_end_drawing();
+	game.gameMetrics.timeInPresent = ms_since(presentStart);
 	if (frameStepMode) {
 		shouldRenderFrame = false;
 	}
-	game.gameMetrics.timeInDraw = ((double)(clock() - now)) / (CLOCKS_PER_SEC / 1000);
-	game.gameMetrics.drawnSprites = 0;
+}
+
+// walks a square around the start of the world map, long enough to cross a
+// few chunks on every side.
+static const InputScriptStep headlessBenchScript[] = {
+	{.keys = {KEY_RIGHT}, .frames = 120},
+	{.keys = {KEY_DOWN}, .frames = 120},
+	{.keys = {KEY_LEFT}, .frames = 120},
+	{.keys = {KEY_UP}, .frames = 120},
+	{.keys = {KEY_NULL}, .frames = 30},
+};
+#define HEADLESS_BENCH_FRAME_TIME (1.0 / 60.0)
+
+void game_bench_headless(const i32 frames, const char *replayPath) {
+	panicIf(!platform_is_headless(), "the headless benchmark needs platform_init_headless");
+	panicIf(replayPath == nil && frames <= 0, "benchmark needs at least one frame");
+
+	// baking draws into render textures.
+	settings.bakeTerrainChunks = false;
+	if (replayPath != nil) {
+		if (!replay_play(replayPath)) { return; }
+	} else {
+		input_set_script(headlessBenchScript, comptime_array_len(headlessBenchScript));
+	}
+	game_init();
+	headlessDrawTotals = (typeof(headlessDrawTotals)){};
+	frame_stats_reset();
+	// opened after the load, so the counts are the frames alone.
+	const bool perfCounters = perf_counters_init();
+
+	f64 inputMs = 0;
+	f64 updateMs = 0;
+	f64 drawMs = 0;
+	PerfCounterValues inputPerf = {};
+	PerfCounterValues updatePerf = {};
+	PerfCounterValues drawPerf = {};
+	i32 played = 0;
+	const u64 start = profiler_now_ns();
+	// a replay plays to the end unless frames asks for less.
+	for (; frames <= 0 || played < frames; played++) {
+		f32 frameTime = (f32)HEADLESS_BENCH_FRAME_TIME;
+		if (replayPath != nil) {
+			if (!replay_begin_frame(&frameTime)) { break; }
+		} else {
+			platform_advance_time(frameTime);
+		}
+		game_handle_input();
+		game_update(frameTime);
+		replay_end_frame(game_state_hash());
+		game_draw();
+		inputMs += game.gameMetrics.timeInInput;
+		updateMs += game.gameMetrics.timeInUpdate;
+		drawMs += game.gameMetrics.timeInDraw;
+		perf_counters_add(&inputPerf, game.gameMetrics.perfInput);
+		perf_counters_add(&updatePerf, game.gameMetrics.perfUpdate);
+		perf_counters_add(&drawPerf, game.gameMetrics.perfDraw);
+		const GpuStats gpuStats = gpu_stats_frame();
+		gpu_stats_add(&headlessDrawTotals.gpu, &gpuStats);
+	}
+	const f64 totalSecs = ms_since(start) / 1000.0;
+
+	if (played > 0) {
+		printfln("%d frames in %.3fs, %.1f frames/s", played, totalSecs, played / totalSecs);
+		const struct {
+			const char *name;
+			f64 ms;
+			PerfCounterValues perf;
+		} phases[] = {
+			{"input", inputMs, inputPerf},
+			{"update", updateMs, updatePerf},
+			{"draw", drawMs, drawPerf},
+		};
+		printf("%-8s %12s %14s", "phase", "total (ms)", "per frame (ms)");
+		if (perfCounters) {
+			printf(" %6s %17s %17s %12s", "IPC", "cache miss/frame", "branch miss/frame", "faults/frame");
+		}
+		printf("\n");
+		for (usize i = 0; i < comptime_array_len(phases); i++) {
+			printf("%-8s %12.3f %14.4f", phases[i].name, phases[i].ms, phases[i].ms / played);
+			if (perfCounters) {
+				const u64 *counts = phases[i].perf.counts;
+				printf(
+					" %6.2f %17.1f %17.1f %12.1f",
+					perf_counters_ipc(phases[i].perf),
+					(f64)counts[PerfCounterCacheMisses] / played,
+					(f64)counts[PerfCounterBranchMisses] / played,
+					(f64)counts[PerfCounterPageFaults] / played
+				);
+			}
+			printf("\n");
+		}
+		printfln(
+			"per frame: %.1f sprites, %.1f draw commands, %.1f texture switches (unsorted %.1f), %.1f batch flushes, %.1f chunks",
+			(f64)headlessDrawTotals.drawnSprites / played,
+			(f64)headlessDrawTotals.drawBuffer.commands / played,
+			(f64)headlessDrawTotals.drawBuffer.textureSwitches / played,
+			(f64)headlessDrawTotals.drawBuffer.unsortedTextureSwitches / played,
+			(f64)headlessDrawTotals.drawBuffer.batchFlushes / played,
+			(f64)headlessDrawTotals.visitedChunks / played
+		);
+		printfln(
+			"%-11s %12s %12s %12s %12s %12s %12s",
+			"gpu/frame",
+			"primitives",
+			"vertices",
+			"draw calls",
+			"tex switches",
+			"shader sw.",
+			"flushes"
+		);
+		for (i32 i = 0; i < GpuSubsystemCount; i++) {
+			const GpuSubsystemStats gpuStats = headlessDrawTotals.gpu.subsystems[i];
+			if (gpuStats.primitives == 0 && gpuStats.batchFlushes == 0) { continue; }
+
+			printfln(
+				"%-11s %12.1f %12.1f %12.1f %12.1f %12.1f %12.1f",
+				gpu_subsystem_name(i),
+				(f64)gpuStats.primitives / played,
+				(f64)gpuStats.vertices / played,
+				(f64)gpuStats.drawCalls / played,
+				(f64)gpuStats.textureSwitches / played,
+				(f64)gpuStats.shaderSwitches / played,
+				(f64)gpuStats.batchFlushes / played
+			);
+		}
+
+		// a bench longer than the history only has its last frames here.
+		printfln("%-8s %10s %10s %10s %10s %10s", "phase", "p50 (ms)", "p95 (ms)", "p99 (ms)", "max (ms)", "mean (ms)");
+		for (i32 phase = 0; phase < FrameStatsPhaseCount; phase++) {
+			const FrameStatsSummary summary = frame_stats_summary(phase);
+			printfln(
+				"%-8s %10.4f %10.4f %10.4f %10.4f %10.4f",
+				frame_stats_phase_name(phase),
+				summary.p50,
+				summary.p95,
+				summary.p99,
+				summary.max,
+				summary.mean
+			);
+		}
+		frame_stats_export_csv(FRAME_STATS_CSV_PATH);
+	}
+	profiler_export_chrome_trace(PROFILER_TRACE_PATH);
+	if (replayPath != nil) {
+		const ReplayStats stats = replay_stats();
+		printfln("replay: %lld frames, %lld diverged", (long long)stats.frames, (long long)stats.divergedFrames);
+		replay_stop();
+	}
+
+	perf_counters_shutdown();
+	input_set_script(nil, 0);
+	game_shutdown();
+}
+
+// everything a playback has to match for the simulation to be where the
+// recording was, the parts of the state the rest is derived from.
+u64 game_state_hash() {
+	u64 hash = REPLAY_HASH_START;
+	hash = replay_hash(hash, &game.gameModeState, sizeof(game.gameModeState));
+	hash = replay_hash(hash, &game.transition.mode, sizeof(game.transition.mode));
+	hash = replay_hash(hash, &game.gameOver, sizeof(game.gameOver));
+
+	const Rng *rng = rng_game();
+	hash = replay_hash(hash, &rng->state, sizeof(rng->state));
+
+	const Character *player = &game.player.characterComponent;
+	hash = replay_hash(hash, &player->frame, sizeof(player->frame));
+	hash = replay_hash(hash, &player->direction, sizeof(player->direction));
+	if (game.currentMap != nil) {
+		hash = replay_hash(hash, &game.currentMap->id, sizeof(game.currentMap->id));
+		array_range(game.currentMap->overWorldCharacters, i) {
+			const Character *character = &game.currentMap->overWorldCharacters[i];
+			hash = replay_hash(hash, &character->frame, sizeof(character->frame));
+			hash = replay_hash(hash, &character->direction, sizeof(character->direction));
+		}
+	}
+
+	for (i32 i = 0; i < MAX_PARTY_MONSTERS_LEN; i++) {
+		const Monster *monster = &game.playerMonsters[i];
+		hash = replay_hash(hash, &monster->id, sizeof(monster->id));
+		hash = replay_hash(hash, &monster->level, sizeof(monster->level));
+		hash = replay_hash(hash, &monster->xp, sizeof(monster->xp));
+		hash = replay_hash(hash, &monster->health, sizeof(monster->health));
+		hash = replay_hash(hash, &monster->energy, sizeof(monster->energy));
+	}
+	return hash;
 }
 
 static void game_over_draw() {
@@ -239,8 +591,8 @@ static void game_over_draw() {
 	Vector2 textSize = MeasureTextEx(assets.fonts.bold.rFont, gameOverText, assets.fonts.bold.size * 2, 1.f);
 
 	// background
-	DrawRectangleRec(rect, c);
-	DrawTextPro(
+	gpu_draw_rectangle_rec(rect, c);
+	gpu_draw_text_pro(
 		assets.fonts.bold.rFont,
 		gameOverText,
 		rectangle_center(rect),
@@ -266,32 +618,261 @@ i32 player_party_length() {
 static void game_draw_debug_screen() {
 	if (!game.isDebug) { return; }
 
-	DrawFPS(10, 10);
+	gpu_draw_fps(10, 10);
 
 	const i32 fontSize = 20;
 	const size_t textBufSize = 1024;
 	char mousePosText[textBufSize];
 	const Vector2 mousePos = GetScreenToWorld2D(GetMousePosition(), game.camera);
 	snprintf(mousePosText, textBufSize, "Mouse %dx%d", (i32)mousePos.x, (i32)mousePos.y);
-	DrawText(mousePosText, 12, 30, fontSize, DARKGREEN);
+	gpu_draw_text(mousePosText, 12, 30, fontSize, DARKGREEN);
 
+	const DrawBufferStats drawBufferStats = draw_buffer_stats();
+	const MapCacheStats mapCacheStats = map_cache_stats();
+	const TextureCacheStats textureCacheStats = texture_cache_stats();
 	char gameMetricsText[textBufSize * 3];
 	snprintf(
 		gameMetricsText,
 		textBufSize * 3,
 		"Time in input: %0.4f\n"
-		"Time in update: %0.4f\n"
+		"Time in update: %0.4f (%d ticks at %.0f Hz)\n"
 		"Time in draw: %0.4f\n"
-		"Sprites Drawn: %lld/%lld",
+		"Sprites Drawn: %lld/%lld\n"
+		"Draw Calls: %lld\n"
+		"Draw Commands: %lld\n"
+		"Texture Switches: %lld (unsorted %lld)\n"
+		"Batch Flushes: %lld\n"
+		"Chunks Visited: %lld\n"
+		"Collision Candidates: %lld/%lld\n"
+		"Terrain Chunks Baked: %d (%s)\n"
+		"Cached Maps: %d (%zu KiB, hits %lld, loads %lld, evictions %lld)\n"
+		"Textures: %d (%llu KiB VRAM, hits %lld, misses %lld)",
 		game.gameMetrics.timeInInput,
 		// todo make this static variables inside the functions instead.
 		game.gameMetrics.timeInUpdate,
+		game.gameMetrics.simulationTicks,
+		settings.simulationTickRate,
 		game.gameMetrics.timeInDraw,
-		game.gameMetrics.drawnSprites,
-		game.gameMetrics.totalSprites
+		(long long)game.gameMetrics.drawnSprites,
+		(long long)game.gameMetrics.totalSprites,
+		(long long)game.gameMetrics.drawCalls,
+		(long long)drawBufferStats.commands,
+		(long long)drawBufferStats.textureSwitches,
+		(long long)drawBufferStats.unsortedTextureSwitches,
+		(long long)drawBufferStats.batchFlushes,
+		(long long)game.gameMetrics.visitedChunks,
+		(long long)game.gameMetrics.collisionCandidates,
+		(long long)game.gameMetrics.collisionColliders,
+		game.currentMap != nil ? game.currentMap->terrainChunks.bakedChunks : 0,
+		settings.bakeTerrainChunks ? "on" : "off",
+		mapCacheStats.residentMaps,
+		mapCacheStats.residentBytes / 1024,
+		(long long)mapCacheStats.hits,
+		(long long)mapCacheStats.loads,
+		(long long)mapCacheStats.evictions,
+		textureCacheStats.residentTextures,
+		(unsigned long long)(textureCacheStats.residentBytes / 1024),
+		(long long)textureCacheStats.hits,
+		(long long)textureCacheStats.misses
 	);
+	usize metricsLen = strlen(gameMetricsText);
+	append_perf_counters(gameMetricsText + metricsLen, sizeof(gameMetricsText) - metricsLen);
+	metricsLen = strlen(gameMetricsText);
+	append_gpu_stats(gameMetricsText + metricsLen, sizeof(gameMetricsText) - metricsLen);
+	metricsLen = strlen(gameMetricsText);
+	append_frame_stats(gameMetricsText + metricsLen, sizeof(gameMetricsText) - metricsLen);
 	const Vector2 textSize = MeasureTextEx(GetFontDefault(), gameMetricsText, (f32)fontSize, 1);
-	DrawText(gameMetricsText, 12, (i32)(30.f + textSize.y), 20, DARKBLUE);
+	gpu_draw_text(gameMetricsText, 12, (i32)(30.f + textSize.y), 20, DARKBLUE);
+
+	game_draw_debug_profiler_zones();
+	game_draw_debug_frame_graph();
+}
+
+// what the last frame handed rlgl, one line per subsystem that drew anything.
+static void append_gpu_stats(char *text, const usize size) {
+	const GpuStats stats = gpu_stats_frame();
+	const GpuSubsystemStats total = gpu_stats_sum(&stats);
+	usize len = snprintf(
+		text,
+		size,
+		"\nGPU: %lld primitives, %lld vertices, %lld draw calls, %lld texture switches, %lld shader switches, %lld flushes",
+		(long long)total.primitives,
+		(long long)total.vertices,
+		(long long)total.drawCalls,
+		(long long)total.textureSwitches,
+		(long long)total.shaderSwitches,
+		(long long)total.batchFlushes
+	);
+	for (i32 i = 0; i < GpuSubsystemCount && len < size; i++) {
+		const GpuSubsystemStats subsystem = stats.subsystems[i];
+		if (subsystem.primitives == 0 && subsystem.batchFlushes == 0) { continue; }
+
+		len += snprintf(
+			text + len,
+			size - len,
+			"\n  %s: %lld prims, %lld verts, %lld draws, %lld tex, %lld shaders, %lld flushes",
+			gpu_subsystem_name(i),
+			(long long)subsystem.primitives,
+			(long long)subsystem.vertices,
+			(long long)subsystem.drawCalls,
+			(long long)subsystem.textureSwitches,
+			(long long)subsystem.shaderSwitches,
+			(long long)subsystem.batchFlushes
+		);
+	}
+}
+
+// percentiles of the frames in the history, which is the last minute or so.
+static void append_frame_stats(char *text, const usize size) {
+	usize len = snprintf(
+		text,
+		size,
+		"\nFrames: %d (F7 writes %s)",
+		frame_stats_len(),
+		FRAME_STATS_CSV_PATH
+	);
+	for (i32 phase = 0; phase < FrameStatsPhaseCount && len < size; phase++) {
+		const FrameStatsSummary summary = frame_stats_summary(phase);
+		len += snprintf(
+			text + len,
+			size - len,
+			"\n%s: p50 %.2f, p95 %.2f, p99 %.2f, max %.2f ms",
+			frame_stats_phase_name(phase),
+			summary.p50,
+			summary.p95,
+			summary.p99,
+			summary.max
+		);
+	}
+	if (len >= size) { return; }
+
+	if (settings.frameBudgetMs <= 0) {
+		snprintf(text + len, size - len, "\nWatchdog: off (--watchdog <ms>)");
+		return;
+	}
+	const WatchdogStats watchdogStats = watchdog_stats();
+	snprintf(
+		text + len,
+		size - len,
+		"\nWatchdog: %.2f ms budget, %lld over (last %.2f ms), %lld captured%s%s",
+		settings.frameBudgetMs,
+		(long long)watchdogStats.spikes,
+		watchdogStats.lastSpikeMs,
+		(long long)watchdogStats.captures,
+		watchdogStats.captures > 0 ? ", last to " : "",
+		watchdogStats.lastCapture
+	);
+}
+
+#define FRAME_GRAPH_FRAMES 240
+#define FRAME_GRAPH_BAR_WIDTH 2
+#define FRAME_GRAPH_HEIGHT 120
+#define FRAME_GRAPH_MAX_MS 50.f
+
+// the last frames along the bottom, newest on the right, every bar split into
+// the phases with whatever the frame spent outside them on top. The lines are
+// 60 fps and the p99 of the whole frame.
+static void game_draw_debug_frame_graph() {
+	static const Color phaseColors[FrameStatsPhaseTotal] = {
+		[FrameStatsPhaseInput] = PURPLE,
+		[FrameStatsPhaseUpdate] = BLUE,
+		[FrameStatsPhaseDraw] = ORANGE,
+		[FrameStatsPhasePresent] = GREEN,
+	};
+	const f32 pixelsPerMs = FRAME_GRAPH_HEIGHT / FRAME_GRAPH_MAX_MS;
+	const i32 x = 12;
+	const i32 bottom = platform_screen_height() - 12;
+	const i32 width = FRAME_GRAPH_FRAMES * FRAME_GRAPH_BAR_WIDTH;
+	gpu_draw_rectangle(x, bottom - FRAME_GRAPH_HEIGHT, width, FRAME_GRAPH_HEIGHT, Fade(BLACK, 0.5f));
+
+	const i32 framesLen = min(frame_stats_len(), FRAME_GRAPH_FRAMES);
+	for (i32 age = 0; age < framesLen; age++) {
+		const FrameSample sample = frame_stats_sample(age);
+		const i32 barX = x + width - ((age + 1) * FRAME_GRAPH_BAR_WIDTH);
+		f32 barMs = 0;
+		for (i32 phase = 0; phase < FrameStatsPhaseTotal && barMs < FRAME_GRAPH_MAX_MS; phase++) {
+			const f32 ms = min(sample.ms[phase], FRAME_GRAPH_MAX_MS - barMs);
+			const i32 top = bottom - (i32)((barMs + ms) * pixelsPerMs);
+			gpu_draw_rectangle(barX, top, FRAME_GRAPH_BAR_WIDTH, bottom - (i32)(barMs * pixelsPerMs) - top, phaseColors[phase]);
+			barMs += ms;
+		}
+		const f32 totalMs = min(sample.ms[FrameStatsPhaseTotal], FRAME_GRAPH_MAX_MS);
+		if (totalMs > barMs) {
+			const i32 top = bottom - (i32)(totalMs * pixelsPerMs);
+			gpu_draw_rectangle(barX, top, FRAME_GRAPH_BAR_WIDTH, bottom - (i32)(barMs * pixelsPerMs) - top, LIGHTGRAY);
+		}
+	}
+
+	const i32 targetY = bottom - (i32)(1000.f / 60.f * pixelsPerMs);
+	gpu_draw_line(x, targetY, x + width, targetY, DARKGREEN);
+	const f32 p99Ms = min((f32)frame_stats_percentile(FrameStatsPhaseTotal, 99), FRAME_GRAPH_MAX_MS);
+	const i32 p99Y = bottom - (i32)(p99Ms * pixelsPerMs);
+	gpu_draw_line(x, p99Y, x + width, p99Y, RED);
+}
+
+// one line per phase, F6 opens and closes the counters.
+static void append_perf_counters(char *text, const usize size) {
+	if (!perf_counters_enabled()) {
+		snprintf(text, size, "\nPerf Counters: off (F6)");
+		return;
+	}
+
+	const struct {
+		const char *phase;
+		PerfCounterValues values;
+	} phases[] = {
+		{"Input", game.gameMetrics.perfInput},
+		{"Update", game.gameMetrics.perfUpdate},
+		{"Draw", game.gameMetrics.perfDraw},
+	};
+	usize len = 0;
+	for (usize i = 0; i < comptime_array_len(phases) && len < size; i++) {
+		const u64 *counts = phases[i].values.counts;
+		len += snprintf(
+			text + len,
+			size - len,
+			"\n%s: IPC %.2f, %llu cache misses, %llu branch misses, %llu faults",
+			phases[i].phase,
+			perf_counters_ipc(phases[i].values),
+			(unsigned long long)counts[PerfCounterCacheMisses],
+			(unsigned long long)counts[PerfCounterBranchMisses],
+			(unsigned long long)counts[PerfCounterPageFaults]
+		);
+	}
+}
+
+// the zones of the last frame down the right side, children indented under
+// their parents. F4 writes the whole capture out as a Chrome trace.
+static void game_draw_debug_profiler_zones() {
+	const i32 fontSize = 20;
+	const i32 lineHeight = fontSize + 2;
+	const i32 x = platform_screen_width() - 460;
+	i32 y = 10;
+	gpu_draw_text(
+		sampler_running() ? "Zones (F4 exports a trace, F5 stops sampling)" : "Zones (F4 exports a trace, F5 samples)",
+		x,
+		y,
+		fontSize,
+		DARKGREEN
+	);
+
+	const ProfilerZoneStats *zones = nil;
+	const i32 zonesLen = profiler_frame_zones(&zones);
+	for (i32 i = 0; i < zonesLen; i++) {
+		y += lineHeight;
+		char line[128];
+		snprintf(
+			line,
+			sizeof(line),
+			"%*s%s: %0.3f ms (%d)",
+			zones[i].depth * 2,
+			"",
+			zones[i].name,
+			zones[i].ms,
+			zones[i].calls
+		);
+		gpu_draw_text(line, x, y, fontSize, DARKBLUE);
+	}
 }
 
 static void do_map_transition_check() {
@@ -307,6 +888,77 @@ static void do_map_transition_check() {
 	}
 }
 
+// starts loading the maps the player can walk into soon, so by the time the
+// screen fades out they are usually resident already.
+static void prefetch_nearby_maps() {
+	if (game.transition.mode != TransitionModeNone) { return; }
+
+	const f32 distance = settings.mapPrefetchDistanceTiles * TILE_SIZE;
+	const Rectangle hitBox = game.player.characterComponent.hitBox;
+	array_range(game.currentMap->transitionBoxes, i) {
+		const Rectangle box = game.currentMap->transitionBoxes[i].box;
+		const Rectangle area = {
+			.x = box.x - distance,
+			.y = box.y - distance,
+			.width = box.width + (distance * 2),
+			.height = box.height + (distance * 2),
+		};
+		if (!CheckCollisionRecs(area, hitBox)) { continue; }
+
+		const MapID mapID = map_id_for_name(game.currentMap->transitionBoxes[i].destination);
+		if (mapID != game.currentMap->id) {
+			map_cache_prefetch(mapID);
+		}
+	}
+}
+
+// only a replay can get here with the map still loading, the recording had
+// it by now so the playback waits for it.
+static Map *wait_for_map(const MapID mapID) {
+	Map *map = map_cache_take(mapID);
+	while (map == nil) {
+		map_cache_prefetch(mapID);
+		map_cache_update(settings.mapUploadBudgetSecs);
+		map = map_cache_take(mapID);
+		if (map == nil) { WaitTime(0.001); }
+	}
+	return map;
+}
+
+// the frame ends with the draw, present and all.
+static void push_frame_stats() {
+	FrameSample sample = {
+		.ms = {
+			[FrameStatsPhaseInput] = (f32)game.gameMetrics.timeInInput,
+			[FrameStatsPhaseUpdate] = (f32)game.gameMetrics.timeInUpdate,
+			[FrameStatsPhaseDraw] = (f32)game.gameMetrics.timeInDraw,
+			[FrameStatsPhasePresent] = (f32)game.gameMetrics.timeInPresent,
+		},
+		.simulationTicks = game.gameMetrics.simulationTicks,
+		.mapID = game.currentMap != nil ? (i32)game.currentMap->id : -1,
+	};
+	perf_counters_add(&sample.perf, game.gameMetrics.perfInput);
+	perf_counters_add(&sample.perf, game.gameMetrics.perfUpdate);
+	perf_counters_add(&sample.perf, game.gameMetrics.perfDraw);
+	frame_stats_push(sample);
+}
+
+static const char *game_mode_string(const GameModeState mode) {
+	switch (mode) {
+		case GameModeNone: return "none";
+		case GameModeLoading: return "loading";
+		case GameModePlaying: return "playing";
+		case GameModeMonsterIndex: return "monster index";
+		case GameModeBattle: return "battle";
+		case GameModeCount: break;
+	}
+	return "invalid";
+}
+
+static f64 ms_since(const u64 startNs) {
+	return (f64)(profiler_now_ns() - startNs) / 1e6;
+}
+
 static void handle_screen_transition(const f32 dt) {
 	switch (game.transition.mode) {
 		case TransitionModeFadeOut: {
@@ -314,9 +966,22 @@ static void handle_screen_transition(const f32 dt) {
 			player_block(&game.player);
 			game.transition.progress += game.transition.speed * dt;
 			if (game.transition.progress >= 255) {
+				game.transition.progress = 255;
+				game.transition.mode = TransitionModeLoading;
+			}
+			break;
+		}
+		case TransitionModeLoading: {
+			// asked every frame, the loader could still be busy with a map
+			// prefetched for another transition.
+			// when the load finishes is up to the loader thread, a replay
+			// plays back the tick it finished on the recording.
+			const MapID nextMapID = map_id_for_name(game.transition.target->destination);
+			if (replay_outcome(map_cache_is_resident(nextMapID))) {
+				game_set_map(wait_for_map(nextMapID));
 				game.transition.mode = TransitionModeFadeIn;
-				const MapID nextMapID = map_id_for_name(game.transition.target->destination);
-				game_load_map(nextMapID);
+			} else {
+				map_cache_prefetch(nextMapID);
 			}
 			break;
 		}
@@ -340,7 +1005,7 @@ static void game_draw_debug_camera() {
 	if (!game.isDebug) { return; }
 
 	// Draw camera anchor
-	DrawCircleV(game.camera.target, 5.f, BLUE);
+	gpu_draw_circle_v(game.camera.target, 5.f, BLUE);
 }
 
 static void game_draw_fade_transition() {
@@ -355,12 +1020,15 @@ static void game_draw_fade_transition() {
 	};
 	const f32 a = clamp(game.transition.progress, 0, 255);
 	const Color c = {0, 0, 0, (u8)a};
-	DrawRectangleRec(screen, c);
+	gpu_draw_rectangle_rec(screen, c);
 }
 
-void game_load_map(const MapID mapID) {
-	map_free(game.currentMap);
-	game.currentMap = load_map(mapID);
+static void game_set_map(Map *map) {
+	map_cache_put(game.currentMap);
+	game.currentMap = map;
+	game.currentMap->wasShown = true;
+	map_start_patrols(game.currentMap);
+	game.gameMetrics.totalSprites = map->totalSprites;
 	character_set_center_at(&game.player.characterComponent, game.currentMap->playerStartingPosition);
 }
 
@@ -393,8 +1061,8 @@ static void game_draw_dialog_box() {
 		.width = bubbleWidth,
 	};
 
-	DrawRectangleRounded(frame, radius, 0, gameColors[ColorsWhite]);
-	DrawTextEx(
+	gpu_draw_rectangle_rounded(frame, radius, 0, gameColors[ColorsWhite]);
+	gpu_draw_text_ex(
 		assets.fonts.dialog.rFont,
 		msg,
 		(Vector2){frame.x + textPadding, frame.y + textPadding},
@@ -408,6 +1076,9 @@ static void setup_game(const MapID mapID) {
 	Map *map = load_map(mapID);
 	game.gameModeState = GameModeLoading;
 	game.currentMap = map;
+	game.currentMap->wasShown = true;
+	map_start_patrols(game.currentMap);
+	game.gameMetrics.totalSprites = map->totalSprites;
 	game.player = player_new(map->playerStartingPosition);
 	game.playerMonsters[0] = monster_new(MonsterIDCharmadillo, 30);
 	game.playerMonsters[1] = monster_new(MonsterIDFriolera, 29);
@@ -421,7 +1092,7 @@ static void setup_game(const MapID mapID) {
 
 	// camera
 	game.camera = (Camera2D){0};
-	update_camera();
+	update_camera(player_get_center(&game.player));
 
 	// dialog
 	const DialogBubble dialog = {
@@ -436,20 +1107,20 @@ static void setup_game(const MapID mapID) {
 	game.gameModeState = GameModePlaying;
 }
 
-static void update_camera() {
-	game.camera.target = player_get_center(&game.player);
+static void update_camera(const Vector2 target) {
+	game.camera.target = target;
 	game.camera.offset = (Vector2){
-		.x = ((f32)GetScreenWidth() / 2.0f),
-		.y = ((f32)GetScreenHeight() / 2.0f),
+		.x = ((f32)platform_screen_width() / 2.0f),
+		.y = ((f32)platform_screen_height() / 2.0f),
 	};
-	game.camera.zoom = (f32)GetScreenHeight() / PixelWindowHeight;
+	game.camera.zoom = (f32)platform_screen_height() / PixelWindowHeight;
 	game.camera.rotation = 0.0f;
 
 	game.cameraBoundingBox = (Rectangle){
 		game.camera.target.x - game.camera.offset.x / game.camera.zoom,
 		game.camera.target.y - game.camera.offset.y / game.camera.zoom,
-		(f32)GetScreenWidth() / game.camera.zoom,
-		(f32)GetScreenHeight() / game.camera.zoom
+		(f32)platform_screen_width() / game.camera.zoom,
+		(f32)platform_screen_height() / game.camera.zoom
 	};
 }
 
@@ -10,13 +10,26 @@
 #include "monsters.h"
 #include "monster_index.h"
 #include "monster_battle.h"
+#include "perf_counters.h"
 
 typedef struct GameMetrics {
 	f64 timeInInput;
 	f64 timeInUpdate;
+	i32 simulationTicks;
 	f64 timeInDraw;
+	// EndDrawing, not part of timeInDraw.
+	f64 timeInPresent;
 	i64 totalSprites;
 	i64 drawnSprites;
+	i64 drawCalls;
+	i64 visitedChunks;
+	// colliders tested by map_collides this frame, against all the map has.
+	i64 collisionCandidates;
+	i64 collisionColliders;
+	// hardware counters per phase, zeros unless perf counters are on.
+	PerfCounterValues perfInput;
+	PerfCounterValues perfUpdate;
+	PerfCounterValues perfDraw;
 } GameMetrics;
 
 typedef struct DialogBubble {
@@ -29,6 +42,7 @@ typedef struct DialogBubble {
 typedef enum TransitionMode {
 	TransitionModeNone = 0,
 	TransitionModeFadeOut,
+	TransitionModeLoading, // screen stays black until the next map is ready
 	TransitionModeFadeIn,
 
 	TransitionModeCount,
@@ -55,6 +69,9 @@ typedef struct Game {
 	Rectangle cameraBoundingBox;
 	GameMetrics gameMetrics;
 	DialogBubble dialogBubble;
+	// how far the frame being drawn is between the last two simulation ticks,
+	// from 0 to 1.
+	f32 interpolation;
 
 	// transitions
 	struct {
@@ -72,6 +89,7 @@ typedef struct Game {
 		CharacterData *characterData;
 		MonsterData *monsterData;
 		MonsterAbilityData *attackData;
+		EncounterData *encounterData;
 	} data;
 	bool gameOver;
 
@@ -85,8 +103,15 @@ extern Game game;
 void game_init();
 void game_handle_input();
 void game_shutdown();
-void game_update(f32 deltaTime);
+// advances the simulation by the frame time, in fixed ticks.
+void game_update(f32 frameTime);
 void game_draw();
+// runs the game for the given frames and prints how long each phase took,
+// needs platform_init_headless. The input comes from a replay when there is
+// one, played to the end when frames is 0, or else from a walk around the map.
+void game_bench_headless(i32 frames, const char *replayPath);
+// a hash of the simulation state, for replays to check a playback against.
+u64 game_state_hash();
 void game_start_battle(BattleType battleType, BattleStageBackground bg, Monster *monsters, usize monstersLen);
 
 // general stuff
@@ -280,6 +280,42 @@ static void init_monster_data() {
 	cJSON_free(json);
 }
 
+static void init_encounter_data() {
+	if (game.data.encounterData != nil) {
+		array_free(game.data.encounterData);
+	}
+
+	cJSON *json = load_json_for_data("./data/game/encounter_data.json");
+	const cJSON *mapJSON = nil;
+	cJSON_ArrayForEach(mapJSON, json) {
+		const cJSON *biomeJSON = nil;
+		cJSON_ArrayForEach(biomeJSON, mapJSON) {
+			panicIf(!cJSON_IsArray(biomeJSON), "invalid %s field", biomeJSON->string);
+
+			EncounterData data = {
+				.biome = biome_from_str(biomeJSON->string),
+			};
+			strncpy(data.map, mapJSON->string, MAX_ENCOUNTER_MAP_NAME_LEN - 1);
+
+			const cJSON *entryJSON = nil;
+			cJSON_ArrayForEach(entryJSON, biomeJSON) {
+				panicIf(data.len >= MAX_ENCOUNTER_SPECIES, "found more encounters than the max allowed");
+				const EncounterEntry entry = {
+					.monster = monster_name_from_str(get_string(entryJSON, "monster")->valuestring),
+					.weight = (f32)get_number(entryJSON, "weight")->valuedouble,
+					.minLevel = (u8)get_number(entryJSON, "min_level")->valueint,
+					.maxLevel = (u8)get_number(entryJSON, "max_level")->valueint,
+				};
+				panicIf(entry.weight <= 0, "encounter weight for %s must be positive", data.map);
+				panicIf(entry.minLevel > entry.maxLevel, "encounter levels for %s are backwards", data.map);
+				data.entries[data.len++] = entry;
+			}
+			array_push(game.data.encounterData, data);
+		}
+	}
+	cJSON_free(json);
+}
+
 void game_data_init() {
 	cJSON_Hooks hook = {
 		.malloc_fn = json_malloc,
@@ -290,12 +326,14 @@ void game_data_init() {
 	init_character_data();
 	init_monster_data();
 	init_monster_attack_data();
+	init_encounter_data();
 }
 
 void game_data_free() {
 	array_free(game.data.characterData);
 	array_free(game.data.monsterData);
 	array_free(game.data.attackData);
+	array_free(game.data.encounterData);
 }
 
 CharacterData *game_data_for_character_id(const char *characterID) {
@@ -318,6 +356,16 @@ MonsterData *game_data_for_monster_id(MonsterID monsterID) {
 	panic("unknown monster ID %d\n", monsterID);
 }
 
+EncounterData *game_data_for_encounters(const char *mapName, const Biome biome) {
+	array_range(game.data.encounterData, i) {
+		EncounterData *data = &game.data.encounterData[i];
+		if (data->biome == biome && streq(data->map, mapName)) {
+			return data;
+		}
+	}
+	return nil;
+}
+
 MonsterAbilityData *game_data_for_monster_attack_id(MonsterAbilityID abilityID) {
 	array_range(game.data.attackData, i) {
 		const MonsterAbilityData data = game.data.attackData[i];
@@ -6,6 +6,7 @@
 #define GAME_DATA_H
 #include "character_entity.h"
 #include "monsters.h"
+#include "encounter_table.h"
 
 void game_data_init();
 void game_data_free();
@@ -13,5 +14,7 @@ void game_data_free();
 CharacterData* game_data_for_character_id(const char *characterID);
 MonsterData* game_data_for_monster_id(MonsterID monsterID);
 MonsterAbilityData *game_data_for_monster_attack_id(MonsterAbilityID abilityID);
+// nil if the map has no encounters in that biome.
+EncounterData *game_data_for_encounters(const char *mapName, Biome biome);
 
 #endif //GAME_DATA_H
@@ -0,0 +1,331 @@
+//
+// Created by Hector Mejia on 10/17/26.
+//
+
+#include "gpu_stats.h"
+
+#include <math.h>
+
+#include "rlgl.h"
+#include "platform.h"
+
+// rlgl's default batch, RL_DEFAULT_BATCH_BUFFER_ELEMENTS quads of vertices
+// and RL_DEFAULT_BATCH_DRAWCALLS draw calls.
+#define BATCH_VERTICES (8192 * 4)
+#define BATCH_DRAW_CALLS 256
+#define QUAD_VERTICES 4
+#define LINE_VERTICES 2
+// DrawCircle is a 36 segment sector, drawn 2 segments per quad.
+#define CIRCLE_QUADS 18
+// what DrawRectangleRounded picks its segments with when it gets less than 4.
+#define SMOOTH_CIRCLE_ERROR_RATE 0.5f
+
+typedef enum PrimitiveMode {
+	PrimitiveModeQuads = 0,
+	PrimitiveModeLines,
+} PrimitiveMode;
+
+static const char *subsystemNames[GpuSubsystemCount] = {
+	[GpuSubsystemMap] = "map",
+	[GpuSubsystemCharacters] = "characters",
+	[GpuSubsystemBattle] = "battle",
+	[GpuSubsystemMonsterIndex] = "index",
+	[GpuSubsystemUi] = "ui",
+	[GpuSubsystemDebug] = "debug",
+};
+
+static struct {
+	GpuSubsystem subsystem;
+	GpuStats frame;
+	GpuStats lastFrame;
+	// the batch as rlgl has it.
+	struct {
+		i32 drawCalls;
+		i32 vertices;
+		u32 texture;
+		PrimitiveMode mode;
+	} batch;
+	// the texture the last draw used, whatever batch it went into.
+	u32 lastTexture;
+	u32 shader;
+} gpuStats = {};
+
+static void add_subsystem_stats(GpuSubsystemStats *total, const GpuSubsystemStats *stats);
+static void count_primitives(u32 texture, PrimitiveMode mode, i32 primitives, i32 verticesEach);
+static void flush_batch();
+static void set_shader(u32 shader);
+static u32 shapes_texture_id();
+static i32 visible_glyphs(const char *text);
+static i32 rounded_rectangle_quads(Rectangle rec, f32 roundness, i32 segments);
+
+GpuSubsystem gpu_stats_set_subsystem(const GpuSubsystem subsystem) {
+	panicIf(subsystem < 0 || subsystem >= GpuSubsystemCount, "invalid gpu subsystem %d", subsystem);
+	const GpuSubsystem previous = gpuStats.subsystem;
+	gpuStats.subsystem = subsystem;
+	return previous;
+}
+
+GpuSubsystem gpu_stats_subsystem() {
+	return gpuStats.subsystem;
+}
+
+void gpu_stats_frame_end() {
+	// headless nothing ends the drawing, the batch would carry over.
+	flush_batch();
+	gpuStats.lastFrame = gpuStats.frame;
+	gpuStats.frame = (GpuStats){};
+}
+
+GpuStats gpu_stats_frame() {
+	return gpuStats.lastFrame;
+}
+
+void gpu_stats_add(GpuStats *total, const GpuStats *stats) {
+	for (i32 i = 0; i < GpuSubsystemCount; i++) {
+		add_subsystem_stats(&total->subsystems[i], &stats->subsystems[i]);
+	}
+}
+
+GpuSubsystemStats gpu_stats_sum(const GpuStats *stats) {
+	GpuSubsystemStats sum = {};
+	for (i32 i = 0; i < GpuSubsystemCount; i++) {
+		add_subsystem_stats(&sum, &stats->subsystems[i]);
+	}
+	return sum;
+}
+
+const char *gpu_subsystem_name(const GpuSubsystem subsystem) {
+	return subsystemNames[subsystem];
+}
+
+void gpu_draw_texture(const Texture2D texture, const i32 x, const i32 y, const Color tint) {
+	count_primitives(texture.id, PrimitiveModeQuads, 1, QUAD_VERTICES);
+	if (!platform_is_headless()) { DrawTexture(texture, x, y, tint); }
+}
+
+void gpu_draw_texture_v(const Texture2D texture, const Vector2 position, const Color tint) {
+	count_primitives(texture.id, PrimitiveModeQuads, 1, QUAD_VERTICES);
+	if (!platform_is_headless()) { DrawTextureV(texture, position, tint); }
+}
+
+void gpu_draw_texture_rec(const Texture2D texture, const Rectangle source, const Vector2 position, const Color tint) {
+	count_primitives(texture.id, PrimitiveModeQuads, 1, QUAD_VERTICES);
+	if (!platform_is_headless()) { DrawTextureRec(texture, source, position, tint); }
+}
+
+void gpu_draw_texture_pro(
+	const Texture2D texture,
+	const Rectangle source,
+	const Rectangle dest,
+	const Vector2 origin,
+	const f32 rotation,
+	const Color tint
+) {
+	count_primitives(texture.id, PrimitiveModeQuads, 1, QUAD_VERTICES);
+	if (!platform_is_headless()) { DrawTexturePro(texture, source, dest, origin, rotation, tint); }
+}
+
+// DrawText is DrawTextEx with the default font.
+void gpu_draw_text(const char *text, const i32 x, const i32 y, const i32 fontSize, const Color color) {
+	count_primitives(GetFontDefault().texture.id, PrimitiveModeQuads, visible_glyphs(text), QUAD_VERTICES);
+	if (!platform_is_headless()) { DrawText(text, x, y, fontSize, color); }
+}
+
+void gpu_draw_text_ex(
+	const Font font,
+	const char *text,
+	const Vector2 position,
+	const f32 fontSize,
+	const f32 spacing,
+	const Color tint
+) {
+	count_primitives(font.texture.id, PrimitiveModeQuads, visible_glyphs(text), QUAD_VERTICES);
+	if (!platform_is_headless()) { DrawTextEx(font, text, position, fontSize, spacing, tint); }
+}
+
+void gpu_draw_text_pro(
+	const Font font,
+	const char *text,
+	const Vector2 position,
+	const Vector2 origin,
+	const f32 rotation,
+	const f32 fontSize,
+	const f32 spacing,
+	const Color tint
+) {
+	count_primitives(font.texture.id, PrimitiveModeQuads, visible_glyphs(text), QUAD_VERTICES);
+	if (!platform_is_headless()) { DrawTextPro(font, text, position, origin, rotation, fontSize, spacing, tint); }
+}
+
+void gpu_draw_fps(const i32 x, const i32 y) {
+	count_primitives(GetFontDefault().texture.id, PrimitiveModeQuads, visible_glyphs(TextFormat("%2i FPS", GetFPS())), QUAD_VERTICES);
+	if (!platform_is_headless()) { DrawFPS(x, y); }
+}
+
+void gpu_draw_rectangle(const i32 x, const i32 y, const i32 width, const i32 height, const Color color) {
+	count_primitives(shapes_texture_id(), PrimitiveModeQuads, 1, QUAD_VERTICES);
+	if (!platform_is_headless()) { DrawRectangle(x, y, width, height, color); }
+}
+
+void gpu_draw_rectangle_rec(const Rectangle rec, const Color color) {
+	count_primitives(shapes_texture_id(), PrimitiveModeQuads, 1, QUAD_VERTICES);
+	if (!platform_is_headless()) { DrawRectangleRec(rec, color); }
+}
+
+void gpu_draw_rectangle_rounded(const Rectangle rec, const f32 roundness, const i32 segments, const Color color) {
+	count_primitives(shapes_texture_id(), PrimitiveModeQuads, rounded_rectangle_quads(rec, roundness, segments), QUAD_VERTICES);
+	if (!platform_is_headless()) { DrawRectangleRounded(rec, roundness, segments, color); }
+}
+
+// a rectangle per side.
+void gpu_draw_rectangle_lines_ex(const Rectangle rec, const f32 lineThick, const Color color) {
+	count_primitives(shapes_texture_id(), PrimitiveModeQuads, 4, QUAD_VERTICES);
+	if (!platform_is_headless()) { DrawRectangleLinesEx(rec, lineThick, color); }
+}
+
+void gpu_draw_circle(const i32 centerX, const i32 centerY, const f32 radius, const Color color) {
+	count_primitives(shapes_texture_id(), PrimitiveModeQuads, CIRCLE_QUADS, QUAD_VERTICES);
+	if (!platform_is_headless()) { DrawCircle(centerX, centerY, radius, color); }
+}
+
+void gpu_draw_circle_v(const Vector2 center, const f32 radius, const Color color) {
+	count_primitives(shapes_texture_id(), PrimitiveModeQuads, CIRCLE_QUADS, QUAD_VERTICES);
+	if (!platform_is_headless()) { DrawCircleV(center, radius, color); }
+}
+
+// lines keep whatever texture was bound, only the mode changes.
+void gpu_draw_line(const i32 startX, const i32 startY, const i32 endX, const i32 endY, const Color color) {
+	count_primitives(gpuStats.lastTexture, PrimitiveModeLines, 1, LINE_VERTICES);
+	if (!platform_is_headless()) { DrawLine(startX, startY, endX, endY, color); }
+}
+
+void gpu_draw_line_v(const Vector2 start, const Vector2 end, const Color color) {
+	count_primitives(gpuStats.lastTexture, PrimitiveModeLines, 1, LINE_VERTICES);
+	if (!platform_is_headless()) { DrawLineV(start, end, color); }
+}
+
+void gpu_begin_shader_mode(const Shader shader) {
+	set_shader(shader.id);
+	if (!platform_is_headless()) { BeginShaderMode(shader); }
+}
+
+void gpu_end_shader_mode() {
+	set_shader(0);
+	if (!platform_is_headless()) { EndShaderMode(); }
+}
+
+// every mode change draws whatever is in the batch first.
+void gpu_begin_mode_2d(const Camera2D camera) {
+	flush_batch();
+	if (!platform_is_headless()) { BeginMode2D(camera); }
+}
+
+void gpu_end_mode_2d() {
+	flush_batch();
+	if (!platform_is_headless()) { EndMode2D(); }
+}
+
+void gpu_begin_texture_mode(const RenderTexture2D target) {
+	flush_batch();
+	if (!platform_is_headless()) { BeginTextureMode(target); }
+}
+
+void gpu_end_texture_mode() {
+	flush_batch();
+	if (!platform_is_headless()) { EndTextureMode(); }
+}
+
+void gpu_end_drawing() {
+	flush_batch();
+	if (!platform_is_headless()) { EndDrawing(); }
+}
+
+static void add_subsystem_stats(GpuSubsystemStats *total, const GpuSubsystemStats *stats) {
+	total->primitives += stats->primitives;
+	total->vertices += stats->vertices;
+	total->drawCalls += stats->drawCalls;
+	total->textureSwitches += stats->textureSwitches;
+	total->shaderSwitches += stats->shaderSwitches;
+	total->batchFlushes += stats->batchFlushes;
+}
+
+// what rlCheckRenderBatchLimit, rlSetTexture and rlBegin do with the batch
+// for every primitive.
+static void count_primitives(const u32 texture, const PrimitiveMode mode, const i32 primitives, const i32 verticesEach) {
+	if (primitives <= 0) { return; }
+
+	GpuSubsystemStats *stats = &gpuStats.frame.subsystems[gpuStats.subsystem];
+	if (texture != gpuStats.lastTexture) {
+		stats->textureSwitches++;
+		gpuStats.lastTexture = texture;
+	}
+
+	for (i32 i = 0; i < primitives; i++) {
+		if (gpuStats.batch.vertices + verticesEach >= BATCH_VERTICES) {
+			flush_batch();
+		}
+		if (gpuStats.batch.drawCalls == 0 || texture != gpuStats.batch.texture || mode != gpuStats.batch.mode) {
+			if (gpuStats.batch.drawCalls >= BATCH_DRAW_CALLS) {
+				flush_batch();
+			}
+			gpuStats.batch.drawCalls++;
+			gpuStats.batch.texture = texture;
+			gpuStats.batch.mode = mode;
+			stats->drawCalls++;
+		}
+		gpuStats.batch.vertices += verticesEach;
+	}
+	stats->primitives += primitives;
+	stats->vertices += (i64)primitives * verticesEach;
+}
+
+static void flush_batch() {
+	if (gpuStats.batch.vertices == 0) { return; }
+
+	gpuStats.frame.subsystems[gpuStats.subsystem].batchFlushes++;
+	gpuStats.batch.drawCalls = 0;
+	gpuStats.batch.vertices = 0;
+}
+
+// rlSetShader draws the batch before switching.
+static void set_shader(const u32 shader) {
+	if (shader == gpuStats.shader) { return; }
+
+	flush_batch();
+	gpuStats.frame.subsystems[gpuStats.subsystem].shaderSwitches++;
+	gpuStats.shader = shader;
+}
+
+// raylib draws shapes with the white rectangle of the default font when it
+// has one, so they batch with text.
+static u32 shapes_texture_id() {
+	const u32 fontTexture = GetFontDefault().texture.id;
+	return fontTexture != 0 ? fontTexture : rlGetTextureIdDefault();
+}
+
+// a quad per codepoint, spaces, tabs and new lines aside.
+static i32 visible_glyphs(const char *text) {
+	i32 glyphs = 0;
+	for (const char *c = text; *c != '\0'; c++) {
+		const bool continuation = ((u8)*c & 0xC0) == 0x80;
+		if (!continuation && *c != ' ' && *c != '\t' && *c != '\n') {
+			glyphs++;
+		}
+	}
+	return glyphs;
+}
+
+// the middle and the four sides are a quad each, every corner is a sector
+// drawn 2 segments per quad.
+static i32 rounded_rectangle_quads(const Rectangle rec, const f32 roundness, i32 segments) {
+	if (roundness <= 0 || rec.width < 1 || rec.height < 1) { return 1; }
+
+	if (segments < 4) {
+		const f32 radius = min(rec.width, rec.height) * min(roundness, 1.f) / 2;
+		const f32 th = acosf((2 * powf(1 - (SMOOTH_CIRCLE_ERROR_RATE / radius), 2)) - 1);
+		// corners too small for the formula get the minimum, same as raylib.
+		segments = th > 0 ? (i32)(ceilf(2 * PI / th) / 4.f) : 0;
+		if (segments <= 0) { segments = 4; }
+	}
+	return (4 * ((segments + 1) / 2)) + 5;
+}
@@ -0,0 +1,91 @@
+//
+// Created by Hector Mejia on 10/17/26.
+//
+
+#ifndef RAYLIB_POKEMON_CLONE_GPU_STATS_H
+#define RAYLIB_POKEMON_CLONE_GPU_STATS_H
+
+#include "raylib.h"
+#include "common.h"
+
+// The raylib draw functions the game uses, wrapped so every one of them is
+// counted against the subsystem drawing it. rlgl keeps its batch to itself,
+// so the wrappers replay what it does with its default one: a new draw call
+// when the texture or the primitive mode changes, a flush when it runs out of
+// draw calls or vertices, when the shader changes and when a mode begins or
+// ends. Shapes and text are counted as the quads raylib breaks them into.
+//
+// Without a window the wrappers only count, so the headless benchmark gets
+// the same numbers for the map without a GPU.
+typedef enum GpuSubsystem {
+	GpuSubsystemMap = 0,
+	GpuSubsystemCharacters,
+	GpuSubsystemBattle,
+	GpuSubsystemMonsterIndex,
+	GpuSubsystemUi,
+	GpuSubsystemDebug,
+
+	GpuSubsystemCount,
+} GpuSubsystem;
+
+typedef struct GpuSubsystemStats {
+	i64 primitives;
+	i64 vertices;
+	// draw calls the batch had when it was flushed, counted against whoever
+	// started them.
+	i64 drawCalls;
+	i64 textureSwitches;
+	i64 shaderSwitches;
+	// rlDrawRenderBatch calls with something in the batch, counted against
+	// whoever made it flush.
+	i64 batchFlushes;
+} GpuSubsystemStats;
+
+typedef struct GpuStats {
+	GpuSubsystemStats subsystems[GpuSubsystemCount];
+} GpuStats;
+
+/**
+ * Makes the draws that follow count against a subsystem.
+ * @return the subsystem they counted against before, to put back after
+ */
+GpuSubsystem gpu_stats_set_subsystem(GpuSubsystem subsystem);
+GpuSubsystem gpu_stats_subsystem();
+
+/**
+ * Ends the frame, its counts become the ones gpu_stats_frame returns and the
+ * next frame starts from zero. Meant to be called after EndDrawing.
+ */
+void gpu_stats_frame_end();
+// the counts of the last frame gpu_stats_frame_end ended.
+GpuStats gpu_stats_frame();
+void gpu_stats_add(GpuStats *total, const GpuStats *stats);
+GpuSubsystemStats gpu_stats_sum(const GpuStats *stats);
+const char *gpu_subsystem_name(GpuSubsystem subsystem);
+
+void gpu_draw_texture(Texture2D texture, i32 x, i32 y, Color tint);
+void gpu_draw_texture_v(Texture2D texture, Vector2 position, Color tint);
+void gpu_draw_texture_rec(Texture2D texture, Rectangle source, Vector2 position, Color tint);
+void gpu_draw_texture_pro(Texture2D texture, Rectangle source, Rectangle dest, Vector2 origin, f32 rotation, Color tint);
+void gpu_draw_text(const char *text, i32 x, i32 y, i32 fontSize, Color color);
+void gpu_draw_text_ex(Font font, const char *text, Vector2 position, f32 fontSize, f32 spacing, Color tint);
+void gpu_draw_text_pro(Font font, const char *text, Vector2 position, Vector2 origin, f32 rotation, f32 fontSize, f32 spacing, Color tint);
+void gpu_draw_fps(i32 x, i32 y);
+void gpu_draw_rectangle(i32 x, i32 y, i32 width, i32 height, Color color);
+void gpu_draw_rectangle_rec(Rectangle rec, Color color);
+void gpu_draw_rectangle_rounded(Rectangle rec, f32 roundness, i32 segments, Color color);
+void gpu_draw_rectangle_lines_ex(Rectangle rec, f32 lineThick, Color color);
+void gpu_draw_circle(i32 centerX, i32 centerY, f32 radius, Color color);
+void gpu_draw_circle_v(Vector2 center, f32 radius, Color color);
+void gpu_draw_line(i32 startX, i32 startY, i32 endX, i32 endY, Color color);
+void gpu_draw_line_v(Vector2 start, Vector2 end, Color color);
+
+void gpu_begin_shader_mode(Shader shader);
+void gpu_end_shader_mode();
+void gpu_begin_mode_2d(Camera2D camera);
+void gpu_end_mode_2d();
+void gpu_begin_texture_mode(RenderTexture2D target);
+void gpu_end_texture_mode();
+void gpu_end_drawing();
+
+#endif //RAYLIB_POKEMON_CLONE_GPU_STATS_H
@@ -0,0 +1,123 @@
+//
+// Created by Hector Mejia on 10/17/26.
+//
+
+#include "input.h"
+
+// every raylib key code fits under this.
+#define MAX_KEY_CODE 512
+#define KEY_WORDS (MAX_KEY_CODE / 64)
+
+typedef struct KeySet {
+	u64 words[KEY_WORDS];
+} KeySet;
+
+static struct {
+	const InputScriptStep *steps;
+	i32 len;
+	i32 step;
+	i32 frame; // frames played of the current step
+} script = {};
+
+// the keys every input_key_* call this frame is answered from, whatever they
+// came from, so a recording of them plays back exactly as it was played.
+static struct {
+	KeySet down;
+	KeySet previousDown;
+	bool queued;
+	KeySet queuedDown;
+} keys = {};
+
+static void advance_script(KeySet *outDown);
+static void sample_keyboard(KeySet *outDown);
+static bool key_set_has(const KeySet *set, KeyboardKey key);
+static void key_set_add(KeySet *set, KeyboardKey key);
+
+void input_set_script(const InputScriptStep *steps, const i32 len) {
+	panicIf(steps != nil && len <= 0, "input script needs at least one step");
+
+	script = (typeof(script)){
+		.steps = steps,
+		.len = len,
+		// the first input_begin_frame moves to step 0.
+		.step = len - 1,
+		.frame = steps != nil ? steps[len - 1].frames : 0,
+	};
+}
+
+void input_queue_frame(const KeyboardKey *down, const i32 len) {
+	keys.queued = true;
+	keys.queuedDown = (KeySet){};
+	for (i32 i = 0; i < len; i++) {
+		key_set_add(&keys.queuedDown, down[i]);
+	}
+}
+
+void input_begin_frame() {
+	keys.previousDown = keys.down;
+	keys.down = (KeySet){};
+
+	if (keys.queued) {
+		keys.down = keys.queuedDown;
+		keys.queued = false;
+	} else if (script.steps != nil) {
+		advance_script(&keys.down);
+	} else {
+		sample_keyboard(&keys.down);
+	}
+}
+
+bool input_key_down(const KeyboardKey key) {
+	return key_set_has(&keys.down, key);
+}
+
+bool input_key_pressed(const KeyboardKey key) {
+	return key_set_has(&keys.down, key) && !key_set_has(&keys.previousDown, key);
+}
+
+i32 input_keys_down(KeyboardKey *outKeys, const i32 max) {
+	i32 len = 0;
+	for (i32 word = 0; word < KEY_WORDS; word++) {
+		u64 bits = keys.down.words[word];
+		while (bits != 0 && len < max) {
+			outKeys[len++] = (KeyboardKey)((word * 64) + __builtin_ctzll(bits));
+			bits &= bits - 1;
+		}
+	}
+	return len;
+}
+
+static void advance_script(KeySet *outDown) {
+	script.frame++;
+	while (script.frame > script.steps[script.step].frames) {
+		script.step = (script.step + 1) % script.len;
+		script.frame = 1;
+	}
+
+	const InputScriptStep *step = &script.steps[script.step];
+	for (i32 i = 0; i < MAX_INPUT_SCRIPT_KEYS && step->keys[i] != KEY_NULL; i++) {
+		key_set_add(outDown, step->keys[i]);
+	}
+}
+
+// same answers IsKeyDown and IsKeyPressed would give, pressed is down now and
+// not down the frame before, exactly what raylib compares.
+static void sample_keyboard(KeySet *outDown) {
+	for (i32 key = KEY_NULL + 1; key < MAX_KEY_CODE; key++) {
+		if (IsKeyDown(key)) {
+			key_set_add(outDown, key);
+		}
+	}
+}
+
+static bool key_set_has(const KeySet *set, const KeyboardKey key) {
+	if (key <= KEY_NULL || key >= MAX_KEY_CODE) { return false; }
+
+	return (set->words[key / 64] >> (key % 64)) & 1;
+}
+
+static void key_set_add(KeySet *set, const KeyboardKey key) {
+	panicIf(key <= KEY_NULL || key >= MAX_KEY_CODE, "invalid key %d", key);
+
+	set->words[key / 64] |= (u64)1 << (key % 64);
+}
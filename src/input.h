@@ -0,0 +1,48 @@
+//
+// Created by Hector Mejia on 10/17/26.
+//
+
+#ifndef RAYLIB_POKEMON_CLONE_INPUT_H
+#define RAYLIB_POKEMON_CLONE_INPUT_H
+
+#include "raylib.h"
+#include "common.h"
+
+#define MAX_INPUT_SCRIPT_KEYS 4
+
+// A run of frames with the same keys held, for driving the game without a
+// keyboard. Keys after the first KEY_NULL are ignored.
+typedef struct InputScriptStep {
+	KeyboardKey keys[MAX_INPUT_SCRIPT_KEYS];
+	i32 frames;
+} InputScriptStep;
+
+/**
+ * Replaces the keyboard with a script, played from the start and looped when
+ * it runs out.
+ * @param steps the script, it must outlive the run, nil goes back to the keyboard
+ * @param len how many steps the script has
+ */
+void input_set_script(const InputScriptStep *steps, i32 len);
+
+/**
+ * Sets the keys held in the next frame, taking the place of the keyboard or the
+ * script for that one frame. Used to play back recorded input.
+ */
+void input_queue_frame(const KeyboardKey *down, i32 len);
+
+// takes this frame's keys from the queue, the script or the keyboard, called
+// once a frame before any input is read.
+void input_begin_frame();
+
+// IsKeyDown and IsKeyPressed, answered from the keys taken this frame.
+bool input_key_down(KeyboardKey key);
+bool input_key_pressed(KeyboardKey key);
+
+/**
+ * Lists the keys held this frame, lowest key code first.
+ * @return how many keys were written, at most max
+ */
+i32 input_keys_down(KeyboardKey *outKeys, i32 max);
+
+#endif //RAYLIB_POKEMON_CLONE_INPUT_H
@@ -2,15 +2,27 @@
 #include "raylib.h"
 #include "common.h"
 #include "game.h"
+#include "assets.h"
+#include "frame_stats.h"
+#include "game_data.h"
+#include "maps_manager.h"
+#include "platform.h"
+#include "profiler.h"
+#include "replay.h"
+#include "sampler.h"
+#include "settings.h"
+#include "rng.h"
+#include "texture_cache.h"
 #include "memory/memory.h"
 
 #define DUAL_SCREENS true
 
 static void init() {
-	srand(time(nil));
+	rng_seed_game((u64)time(nil));
 
 	initialize_memory();
 	initLogger();
+	profiler_init();
 	InitWindow(ScreenWidth, ScreenHeight, "Monster Taming RPG");
 	panicIf(!IsWindowReady(), "Window failed to initialize");
 
@@ -31,17 +43,125 @@ static void init() {
 	InitAudioDevice();
 }
 
-int main() {
+// offline tools that need the window (textures) and the game data, but not
+// the game itself.
+static i32 run_tool(const char *tool, const char *arg) {
+	maps_manager_init();
+	load_assets();
+	game_data_init();
+
+	i32 exitCode = 0;
+	if (streq(tool, "--compile-maps")) {
+		exitCode = maps_manager_compile_all() ? 0 : 1;
+	} else if (streq(tool, "--bench-map-load")) {
+		const i32 iterations = arg != nil ? atoi(arg) : 20;
+		maps_manager_bench_load(iterations > 0 ? iterations : 20);
+	} else if (streq(tool, "--bench-encounters")) {
+		const i32 rolls = arg != nil ? atoi(arg) : 1000000;
+		encounter_tables_bench(game.data.encounterData, rolls > 0 ? rolls : 1000000);
+	} else if (streq(tool, "--bench-line-of-sight")) {
+		const i32 npcs = arg != nil ? atoi(arg) : 10000;
+		maps_manager_bench_line_of_sight(npcs > 0 ? npcs : 10000);
+	}
+
+	game_data_free();
+	unload_assets();
+	texture_cache_shutdown();
+	return exitCode;
+}
+
+// runs the game without a window or an audio device, the frames still go
+// through input, update and draw but nothing reaches the GPU.
+static i32 run_headless_bench(const char *arg, const char *replayPath) {
+	rng_seed_game((u64)time(nil));
+	initialize_memory();
+	initLogger();
+	profiler_init();
+	platform_init_headless(ScreenWidth, ScreenHeight);
+
+	if (replayPath != nil) {
+		game_bench_headless(arg != nil ? max(atoi(arg), 0) : 0, replayPath);
+	} else {
+		const i32 frames = arg != nil ? atoi(arg) : 600;
+		game_bench_headless(frames > 0 ? frames : 600, nil);
+	}
+
+	profiler_shutdown();
+	shutdown_memory();
+	return 0;
+}
+
+int main(const int argc, char **argv) {
+	if (argc > 1 && streq(argv[1], "--bench-headless")) {
+		return run_headless_bench(argc > 2 ? argv[2] : nil, nil);
+	}
+	if (argc > 2 && streq(argv[1], "--bench-replay")) {
+		return run_headless_bench(argc > 3 ? argv[3] : nil, argv[2]);
+	}
+
+	const char *tool = nil;
+	if (argc > 1 && (streq(argv[1], "--compile-maps") ||
+					 streq(argv[1], "--bench-map-load") ||
+					 streq(argv[1], "--bench-line-of-sight") ||
+					 streq(argv[1], "--bench-encounters"))) {
+		tool = argv[1];
+		SetConfigFlags(FLAG_WINDOW_HIDDEN);
+	}
+
 	init();
+	if (tool != nil) {
+		const i32 exitCode = run_tool(tool, argc > 2 ? argv[2] : nil);
+		CloseWindow();
+		CloseAudioDevice();
+		profiler_shutdown();
+		shutdown_memory();
+		return exitCode;
+	}
+	// --record <file> plays as usual and writes the session down, --replay
+	// <file> plays one back in the window and --sample <file> writes folded
+	// stacks of the whole session. --frame-stats <file> writes the frame times
+	// out on exit and --watchdog <ms> captures the frames before any that takes
+	// longer than that. These last three go with either of the first two.
+	const char *samplesPath = nil;
+	const char *frameStatsPath = nil;
+	for (i32 i = 1; i + 1 < argc; i += 2) {
+		if (streq(argv[i], "--record")) {
+			replay_record(argv[i + 1], true);
+		} else if (streq(argv[i], "--replay")) {
+			replay_play(argv[i + 1]);
+		} else if (streq(argv[i], "--sample")) {
+			samplesPath = argv[i + 1];
+		} else if (streq(argv[i], "--frame-stats")) {
+			frameStatsPath = argv[i + 1];
+		} else if (streq(argv[i], "--watchdog")) {
+			settings.frameBudgetMs = (f32)atof(argv[i + 1]);
+		}
+	}
 	game_init();
+	if (samplesPath != nil) {
+		sampler_start(SAMPLER_DEFAULT_HZ);
+	}
 
 	while (!WindowShouldClose()) {
-		const f32 deltaTime = GetFrameTime();
+		f32 deltaTime = GetFrameTime();
+		if (!replay_begin_frame(&deltaTime)) { break; }
 		game_handle_input();
 		game_update(deltaTime);
+		// hashing walks the whole state, only pay for it when a replay wants it.
+		if (replay_is_recording() || replay_is_playing()) {
+			replay_end_frame(game_state_hash());
+		}
 		game_draw();
 	}
 
+	// still running if F5 started it and nobody stopped it.
+	if (sampler_running()) {
+		sampler_stop(samplesPath != nil ? samplesPath : SAMPLER_FOLDED_PATH);
+	}
+	if (frameStatsPath != nil) {
+		frame_stats_export_csv(frameStatsPath);
+	}
+	replay_stop();
 	game_shutdown();
 
 	CloseWindow();
@@ -50,6 +170,7 @@ int main() {
 	char *memUsage = get_memory_usage_str();
 	slogi(memUsage);
 	free(memUsage);
+	profiler_shutdown();
 	shutdown_memory();
 
 	return 0;
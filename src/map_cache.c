@@ -0,0 +1,126 @@
+//
+// Created by Hector Mejia on 10/17/26.
+//
+
+#include "map_cache.h"
+
+#include "map_loader.h"
+#include "settings.h"
+
+typedef struct MapCacheEntry {
+	Map *map;
+	usize bytes;
+	u64 lastUsed;
+} MapCacheEntry;
+
+typedef struct MapCache {
+	// indexed by MapID, there are only a handful of maps.
+	MapCacheEntry entries[MapIDMax];
+	MapID loadingMapID;
+	bool loading;
+	u64 clock;
+	MapCacheStats stats;
+} MapCache;
+
+static MapCache cache = {};
+
+static void evict_over_budget();
+
+Map *map_cache_take(const MapID mapID) {
+	panicIf(mapID < 0 || mapID >= MapIDMax, "invalid map id %d", mapID);
+
+	MapCacheEntry *entry = &cache.entries[mapID];
+	if (entry->map == nil) { return nil; }
+
+	Map *map = entry->map;
+	cache.stats.hits++;
+	cache.stats.residentMaps--;
+	cache.stats.residentBytes -= entry->bytes;
+	*entry = (MapCacheEntry){};
+
+	// a map prefetched and never shown still has its npcs where they spawned.
+	if (map->wasShown) {
+		map_reset_characters(map);
+	}
+	return map;
+}
+
+void map_cache_put(Map *map) {
+	if (map == nil) { return; }
+
+	MapCacheEntry *entry = &cache.entries[map->id];
+	if (entry->map != nil) {
+		// a second copy of the same map, keep the newest one.
+		cache.stats.residentMaps--;
+		cache.stats.residentBytes -= entry->bytes;
+		map_free(entry->map);
+	}
+
+	*entry = (MapCacheEntry){
+		.map = map,
+		.bytes = map_memory_size(map),
+		.lastUsed = ++cache.clock,
+	};
+	cache.stats.residentMaps++;
+	cache.stats.residentBytes += entry->bytes;
+	evict_over_budget();
+}
+
+void map_cache_prefetch(const MapID mapID) {
+	if (map_cache_is_resident(mapID) || map_loader_is_busy()) { return; }
+
+	map_loader_start(mapID);
+	cache.stats.loads++;
+	cache.loadingMapID = mapID;
+	cache.loading = true;
+}
+
+bool map_cache_is_resident(const MapID mapID) {
+	panicIf(mapID < 0 || mapID >= MapIDMax, "invalid map id %d", mapID);
+	return cache.entries[mapID].map != nil;
+}
+
+void map_cache_update(const f64 budgetSecs) {
+	if (!cache.loading) { return; }
+
+	Map *map = map_loader_poll(budgetSecs);
+	if (map == nil) { return; }
+
+	panicIf(map->id != cache.loadingMapID, "loaded map %d while waiting for %d", map->id, cache.loadingMapID);
+	cache.loading = false;
+	map_cache_put(map);
+}
+
+MapCacheStats map_cache_stats() {
+	return cache.stats;
+}
+
+void map_cache_shutdown() {
+	map_loader_shutdown();
+	for (i32 i = 0; i < MapIDMax; i++) {
+		if (cache.entries[i].map != nil) {
+			map_free(cache.entries[i].map);
+		}
+	}
+	cache = (MapCache){};
+}
+
+static void evict_over_budget() {
+	while (cache.stats.residentBytes > settings.mapCacheBudgetBytes) {
+		MapCacheEntry *oldest = nil;
+		for (i32 i = 0; i < MapIDMax; i++) {
+			MapCacheEntry *entry = &cache.entries[i];
+			if (entry->map != nil && (oldest == nil || entry->lastUsed < oldest->lastUsed)) {
+				oldest = entry;
+			}
+		}
+		if (oldest == nil) { return; }
+
+		slogi("map cache over budget, freeing map %d (%zu bytes)", oldest->map->id, oldest->bytes);
+		cache.stats.residentMaps--;
+		cache.stats.residentBytes -= oldest->bytes;
+		cache.stats.evictions++;
+		map_free(oldest->map);
+		*oldest = (MapCacheEntry){};
+	}
+}
@@ -0,0 +1,60 @@
+//
+// Created by Hector Mejia on 10/17/26.
+//
+
+#ifndef RAYLIB_POKEMON_CLONE_MAP_CACHE_H
+#define RAYLIB_POKEMON_CLONE_MAP_CACHE_H
+
+#include "common.h"
+#include "maps_manager.h"
+
+// Maps the player left recently, kept loaded so going back is a lookup instead
+// of a load. The maps in here are the ones not being played, once the resident
+// ones go over settings.mapCacheBudgetBytes the least recently used get freed.
+// Maps can also be loaded ahead of time with map_cache_prefetch, they land in
+// the cache when map_cache_update finishes them.
+
+typedef struct MapCacheStats {
+	i32 residentMaps;
+	usize residentBytes;
+	i64 hits;  // maps taken out of the cache
+	i64 loads; // maps that had to be loaded from disk
+	i64 evictions;
+} MapCacheStats;
+
+/**
+ * Takes a map out of the cache, the characters in it are back at their spawns.
+ * @param mapID the map to take
+ * @return the map, owned by the caller, or nil if it is not resident
+ */
+Map *map_cache_take(MapID mapID);
+
+/**
+ * Hands a map over to the cache, freeing the least recently used maps if that
+ * goes over the budget.
+ * @param map the map to keep, can be nil
+ */
+void map_cache_put(Map *map);
+
+/**
+ * Starts loading a map in the background unless it is resident or already
+ * loading. Only one map loads at a time, so this does nothing while another
+ * one is loading and has to be asked again later.
+ * @param mapID the map to load
+ */
+void map_cache_prefetch(MapID mapID);
+
+bool map_cache_is_resident(MapID mapID);
+
+/**
+ * Moves the background load forward, meant to be called once a frame.
+ * @param budgetSecs how long this call can spend uploading textures
+ */
+void map_cache_update(f64 budgetSecs);
+
+MapCacheStats map_cache_stats();
+
+// frees every resident map and whatever is loading.
+void map_cache_shutdown();
+
+#endif //RAYLIB_POKEMON_CLONE_MAP_CACHE_H
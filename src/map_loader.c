@@ -0,0 +1,88 @@
+//
+// Created by Hector Mejia on 10/17/26.
+//
+
+#include "map_loader.h"
+
+#include <pthread.h>
+#include <stdatomic.h>
+
+#include "profiler.h"
+
+typedef enum MapLoaderState {
+	MapLoaderStateIdle = 0,
+	MapLoaderStateLoading,   // the worker is building the map
+	MapLoaderStateUploading, // the worker is done, textures go up a few at a time
+} MapLoaderState;
+
+static struct {
+	MapLoaderState state;
+	MapID mapID;
+	pthread_t worker;
+	atomic_bool workerDone;
+	Map *map;
+} loader = {};
+
+static void *map_loader_worker(void *arg);
+
+void map_loader_start(const MapID mapID) {
+	panicIf(loader.state != MapLoaderStateIdle, "map loader is already loading map %d", loader.mapID);
+
+	loader.mapID = mapID;
+	loader.map = nil;
+	atomic_store(&loader.workerDone, false);
+	const i32 err = pthread_create(&loader.worker, nil, map_loader_worker, nil);
+	panicIf(err != 0, "failed to start the map loader thread: %d", err);
+	loader.state = MapLoaderStateLoading;
+}
+
+Map *map_loader_poll(const f64 budgetSecs) {
+	switch (loader.state) {
+		case MapLoaderStateIdle:
+			return nil;
+		case MapLoaderStateLoading:
+			if (!atomic_load(&loader.workerDone)) {
+				return nil;
+			}
+			pthread_join(loader.worker, nil);
+			loader.state = MapLoaderStateUploading;
+			// the rest of the budget can go to the first uploads.
+			[[fallthrough]];
+		case MapLoaderStateUploading:
+			if (!map_upload_textures(loader.map, budgetSecs)) {
+				return nil;
+			}
+			loader.state = MapLoaderStateIdle;
+			Map *map = loader.map;
+			loader.map = nil;
+			return map;
+	}
+
+	panic("invalid map loader state %d", loader.state);
+	return nil;
+}
+
+bool map_loader_is_busy() {
+	return loader.state != MapLoaderStateIdle;
+}
+
+void map_loader_shutdown() {
+	if (loader.state == MapLoaderStateLoading) {
+		pthread_join(loader.worker, nil);
+	}
+	if (loader.map != nil) {
+		map_free(loader.map);
+	}
+	loader.map = nil;
+	loader.state = MapLoaderStateIdle;
+}
+
+static void *map_loader_worker(void *arg) {
+	(void)arg;
+	profiler_thread_begin("map loader");
+	loader.map = load_map_deferred(loader.mapID);
+	profiler_thread_end();
+	// publishes loader.map to the main thread.
+	atomic_store(&loader.workerDone, true);
+	return nil;
+}
@@ -0,0 +1,35 @@
+//
+// Created by Hector Mejia on 10/17/26.
+//
+
+#ifndef RAYLIB_POKEMON_CLONE_MAP_LOADER_H
+#define RAYLIB_POKEMON_CLONE_MAP_LOADER_H
+
+#include "common.h"
+#include "maps_manager.h"
+
+// Loads one map at a time in the background. Parsing and building the map
+// happen on a worker thread, the texture uploads are left for map_loader_poll
+// to spread over as many frames as the budget needs.
+
+/**
+ * Starts loading a map on a worker thread, only one map can be loading at a time.
+ * @param mapID the map to load
+ */
+void map_loader_start(MapID mapID);
+
+/**
+ * Moves the current load forward, meant to be called once a frame on the main
+ * thread.
+ * @param budgetSecs how long this call can spend uploading textures
+ * @return the loaded map once it is ready to be drawn, nil until then. The
+ * caller owns the map.
+ */
+Map *map_loader_poll(f64 budgetSecs);
+
+bool map_loader_is_busy();
+
+// waits for the worker and frees whatever it was loading.
+void map_loader_shutdown();
+
+#endif //RAYLIB_POKEMON_CLONE_MAP_LOADER_H
@@ -6,11 +6,22 @@
 #include "array/array.h"
 #include "assets.h"
 #include "common.h"
+#include "compiled_map.h"
+#include "draw_buffer.h"
+#include "gpu_stats.h"
+#include "memory/arena.h"
 #include "memory/memory.h"
+#include "platform.h"
+#include "profiler.h"
+#include "rng.h"
 #include "settings.h"
 #include "sprites.h"
+#include "texture_cache.h"
 
+#include <libxml/parser.h>
+#include <math.h>
 #include <raylib.h>
+#include <rlgl.h>
 #include <tmx.h>
 
 #include "game.h"
@@ -67,34 +78,112 @@ static MapInfo mapAtlas[MapIDMax] = {
 
 static bool loaded = false;
 
+// the GL context belongs to the main thread, textures loaded while building a
+// deferred map get an id with this bit set plus their index in the pending
+// list, and are swapped for the real ones once uploaded.
+#define PLACEHOLDER_TEXTURE_BIT 0x80000000u
+static _Thread_local bool deferTextureUploads = false;
+static _Thread_local PendingTexture *deferredTextures = nil;
+static _Thread_local usize loadedTextureBytes = 0;
+
+// maps are built inside their own arena. While one is loading on a thread,
+// everything it allocates (libtmx's nodes included) comes out of this one, and
+// every texture it loads is kept to hand over to the map.
+#define MAP_ARENA_CHUNK_SIZE (1 * MiB)
+static _Thread_local Arena *loadingArena = nil;
+static _Thread_local Texture2D *loadingTextures = nil;
+// libtmx reallocs without saying how big the block was, arena blocks handed
+// to it keep their size in front.
+#define TMX_BLOCK_HEADER_SIZE 16
+// scratch list of the sprites around the camera, refilled by every query.
+static i32 *visibleSprites = nil;
+
 // private funcs
 static void *texture_loader_callback(const char *path);
-static void texture_free_callback(void *ptr);
 static void *map_alloc_callback(void *ptr, size_t len);
 static void map_free_callback(void *ptr);
 static void print_map_total_memory();
+static Texture2D load_map_texture(const char *path);
+static void resolve_placeholder(Texture2D *texture, const Texture2D *uploaded);
+static void resolve_map_placeholders(Map *map);
+
+static void begin_map_load(Arena *arena, const MapInfo *mapInfo);
+static Map *end_map_load(Map *map);
+static void abort_map_load();
+static Arena *loading_arena();
+static Map *load_tmx_map(const MapInfo *mapInfo, tmx_map *tiledMap);
+static Map *load_compiled_map(const MapInfo *mapInfo);
+static void finish_map_load(Map *map);
+static void init_sorted_characters(Map *map);
+static void init_static_colliders(Map *map);
+static void init_biome_grid(Map *map);
+static u8 patch_table_for(Map *map, const EncounterData *encounters);
+static void init_encounter_tables(Map *map);
+static void init_character_colliders(Map *map);
+static void free_character_colliders(Map *map);
+static bool line_intersects_rect(Vector2 p1, Vector2 p2, Rectangle r);
+static void compiled_map_path(const MapInfo *mapInfo, char *outPath, usize len);
+static void compiled_map_item_sizes(u32 *outSizes);
+static Texture2D resolve_compiled_texture(const Texture2D *resolved, Texture2D texture);
+static void *copy_compiled_section(const CompiledMapFile *file, CompiledMapSection section);
+static TileLayer copy_compiled_tile_layer(
+	const CompiledMapFile *file,
+	CompiledMapTileLayerInfo info,
+	CompiledMapSection gidsSection,
+	CompiledMapSection tilesSection,
+	const Texture2D *resolved
+);
+static const char *find_missing_layer(const tmx_map *tiledMap);
+static u32 compiled_texture_ref(CompiledMapTexture **table, Texture2D texture);
+static StaticSprite *compiled_static_sprites(CompiledMapTexture **table, const StaticSprite *sprites);
+static TileLayerTile *compiled_tiles(CompiledMapTexture **table, const TileLayer *layer);
+static CompiledMapTileLayerInfo compiled_tile_layer_info(const TileLayer *layer);
+static bool compile_map(const MapInfo *mapInfo);
 static bool collidesWithCamera(Rectangle rect);
 static Color int_to_color(u32 color);
 
 static AnimatedTexturesSprite *init_water_sprites(const tmx_layer *layer);
+static Rectangle *init_water_regions(const AnimatedTexturesSprite *waterSprites);
 static AnimatedTiledSprite *init_coast_line_sprites(const tmx_layer *layer);
 static void init_monster_encounter_sprites(Map *map, const tmx_layer *layer);
+static EncounterData patch_encounters(const Map *map, Biome biome, const tmx_object *object);
 static void init_object_sprites(Map *map, const tmx_layer *layer);
-static void init_terrain_sprites(Map *map, const tmx_layer *layer, bool isTopLayer);
-Character *init_over_world_characters(const tmx_layer *layer);
+static TileLayer init_tile_layer(const Map *map, const tmx_layer *layer);
+static TerrainChunkCache init_terrain_chunks(const Map *map);
+static void free_terrain_chunks(TerrainChunkCache *cache);
+static void bake_terrain_chunk(Map *map, i32 col, i32 row);
+static CharacterSpawn *init_character_spawns(const tmx_layer *layer);
+static TileMap character_tile_map(const char *graphic);
+static Character *build_over_world_characters(const Map *map);
 static void init_collision_sprites(Map *map, const tmx_layer *layer);
 static void init_transition_sprites(Map *map, const tmx_layer *layer);
+static void init_sprite_chunks(Map *map);
 _comptime_unused_ static Vector2 find_player_position(const tmx_layer *layer);
 
-static void draw_static_sprite(StaticSprite sprite);
-static void draw_animated_textures_sprites(AnimatedTexturesSprite *waterSprites);
-static void draw_animated_tiled_sprites(AnimatedTiledSprite *coastLineSprites);
-static void draw_tile(void *imageTexture2D, Rectangle sourceRec, Vector2 destination, f32 opacity);
+static void draw_static_sprite(StaticSprite sprite, DrawLayer layer, f32 depth);
+static void draw_main_layer(const Map *map);
+static void sort_characters(Map *map);
+static void bake_visible_terrain_chunks(Map *map);
+static void draw_tile_layer(const TileLayer *layer, DrawLayer drawLayer);
+static i32 draw_tile_layer_area(const TileLayer *layer, DrawLayer drawLayer, Rectangle area, Vector2 offset, bool debugFrames);
+static void draw_terrain_chunks(const Map *map);
+static Rectangle terrain_chunk_rect(const Map *map, i32 col, i32 row);
+static void draw_static_sprites(const StaticSprite *sprites, const SpatialGrid *chunks, DrawLayer layer);
+static void draw_animated_textures_sprites(AnimatedTexturesSprite *waterSprites, const SpatialGrid *chunks);
+static bool water_shader_ready();
+static void draw_water_regions(const Map *map);
+static void draw_animated_tiled_sprites(AnimatedTiledSprite *coastLineSprites, const SpatialGrid *chunks);
+static const i32 *query_visible_sprites(const SpatialGrid *chunks);
+static void draw_tile(void *imageTexture2D, DrawLayer layer, Rectangle sourceRec, Vector2 destination, f32 opacity);
 
 void maps_manager_init() {
+	// the textures are unloaded by map_free, libtmx never frees its maps.
 	tmx_img_load_func = texture_loader_callback;
-	tmx_img_free_func = texture_free_callback;
 
+	// libtmx hands these to libxml2 through xmlMemSetup, so libxml2's own
+	// globals would land in whatever map arena is loading when it first sets
+	// them up. set them up now, before any loading arena exists.
+	xmlInitParser();
 	tmx_alloc_func = map_alloc_callback;
 	tmx_free_func = map_free_callback;
 
@@ -117,38 +206,255 @@ static Color int_to_color(const u32 color) {
 	// return *((Color*)&res);
 }
 
+// total order for anything drawn, layer first, then y-sort. The rest of the
+// fields only break ties, so sprites at the same height never swap places
+// between loads (or between frames, for the characters).
 static int compare_entities(const void *a, const void *b) {
-	const Entity entityA = *((Entity *)a);
-	const Entity entityB = *((Entity *)b);
+	const Entity *entityA = a;
+	const Entity *entityB = b;
 
-	if (entityA.ySort == entityB.ySort && entityA.layer == entityB.layer) {
-		return 0;
+	if (entityA->layer != entityB->layer) {
+		return entityA->layer < entityB->layer ? -1 : 1;
 	}
-
-	// the layer check is a hack to make up for the inconsistent map design
-	if (entityA.ySort < entityB.ySort || entityA.layer < entityB.layer) {
-		return -1;
+	if (entityA->ySort != entityB->ySort) {
+		return entityA->ySort < entityB->ySort ? -1 : 1;
 	}
-
-	return 1;
+	if (entityA->position.y != entityB->position.y) {
+		return entityA->position.y < entityB->position.y ? -1 : 1;
+	}
+	if (entityA->position.x != entityB->position.x) {
+		return entityA->position.x < entityB->position.x ? -1 : 1;
+	}
+	return (entityA->id > entityB->id) - (entityA->id < entityB->id);
 }
 
 Map *load_map(const MapID mapID) {
+	PROFILE_FUNCTION();
 	panicIf(!loaded, "maps_manager was initialize, forgot to call maps_manager_init()?");
 	panicIf(mapID >= MapIDMax, "map ID provided is invalid");
 	const MapInfo mapInfo = mapAtlas[mapID];
 
-	Map *map = mallocate(sizeof(*map), MemoryTagGame);
-	panicIfNil(map, "failed to alloc map");
+	Arena arena;
+	begin_map_load(&arena, &mapInfo);
+	Map *map = load_compiled_map(&mapInfo);
+	if (map == nil) {
+		tmx_map *tiledMap = tmx_load(mapInfo.mapFilePath);
+		panicIfNil(tiledMap, "tmx_error: %s", tmx_strerr());
+		map = load_tmx_map(&mapInfo, tiledMap);
+	}
+	return end_map_load(map);
+}
+
+usize map_memory_size(const Map *map) {
+	usize size = map->arena.capacity + map->textureBytes;
+	size += sizeof(*map->overWorldCharacters) * array_cap(map->overWorldCharacters);
+	size += sizeof(*map->sortedCharacters) * array_cap(map->sortedCharacters);
+	size += sizeof(*map->colliders.characterBounds) * array_cap(map->colliders.characterBounds);
+
+	const TerrainChunkCache *cache = &map->terrainChunks;
+	for (i32 i = 0; i < cache->columns * cache->rows; i++) {
+		const Texture2D chunk = cache->chunks[i].texture;
+		if (chunk.id == 0) { continue; }
+		size += GetPixelDataSize(chunk.width, chunk.height, chunk.format);
+	}
+	return size;
+}
+
+void map_reset_characters(Map *map) {
+	array_range(map->overWorldCharacters, i) {
+		character_free(&map->overWorldCharacters[i]);
+	}
+	if (map->overWorldCharacters != nil) {
+		array_free(map->overWorldCharacters);
+	}
+	map->overWorldCharacters = build_over_world_characters(map);
+	init_sorted_characters(map);
+	free_character_colliders(map);
+	init_character_colliders(map);
+}
+
+void map_start_patrols(Map *map) {
+	array_range(map->overWorldCharacters, i) {
+		Timer *patrolTimer = &map->overWorldCharacters[i].patrolTimer;
+		timer_start(patrolTimer, patrolTimer->lifeTime);
+	}
+}
+
+static void init_sorted_characters(Map *map) {
+	array_clear(map->sortedCharacters);
+	array_range(map->overWorldCharacters, i) {
+		array_push(map->sortedCharacters, &map->overWorldCharacters[i]);
+	}
+	array_push(map->sortedCharacters, &game.player.characterComponent);
+}
+
+Map *load_map_deferred(const MapID mapID) {
+	deferTextureUploads = true;
+	deferredTextures = nil;
+	Map *map = load_map(mapID);
+	map->pendingTextures = deferredTextures;
+	deferTextureUploads = false;
+	deferredTextures = nil;
+	return map;
+}
+
+bool map_upload_textures(Map *map, const f64 budgetSecs) {
+	const f64 start = platform_time();
+	while (array_length(map->uploadedTextures) < array_length(map->pendingTextures)) {
+		if (array_length(map->uploadedTextures) > 0 && platform_time() - start >= budgetSecs) {
+			return false;
+		}
+
+		PendingTexture *pending = &map->pendingTextures[array_length(map->uploadedTextures)];
+		const Texture2D texture = texture_cache_insert(pending->path, platform_load_texture_from_image(pending->image));
+		UnloadImage(pending->image);
+		pending->image = (Image){};
+		if (pending->target != nil) {
+			*pending->target = texture;
+		}
+		array_push(map->uploadedTextures, texture);
+	}
+
+	if (map->pendingTextures != nil) {
+		resolve_map_placeholders(map);
+		array_free(map->pendingTextures);
+		map->pendingTextures = nil;
+	}
+	if (map->uploadedTextures != nil) {
+		array_free(map->uploadedTextures);
+		map->uploadedTextures = nil;
+	}
+	return true;
+}
+
+// every copy of a texture in the map still has the placeholder id.
+static void resolve_map_placeholders(Map *map) {
+	const Texture2D *uploaded = map->uploadedTextures;
+	StaticSprite *staticSprites[] = {map->backgroundSprites, map->mainSprites, map->foregroundSprites};
+	for (usize l = 0; l < comptime_array_len(staticSprites); l++) {
+		array_range(staticSprites[l], i) {
+			StaticSprite *sprite = &staticSprites[l][i];
+			if ((sprite->texture.id & PLACEHOLDER_TEXTURE_BIT) == 0) { continue; }
+			resolve_placeholder(&sprite->texture, uploaded);
+			sprite->entity.id = sprite->texture.id;
+		}
+	}
+	array_range(map->coastLineSpritesList, i) {
+		resolve_placeholder(&map->coastLineSpritesList[i].texture, uploaded);
+	}
+
+	TileLayer *layers[] = {&map->terrainLayer, &map->terrainTopLayer};
+	for (usize l = 0; l < comptime_array_len(layers); l++) {
+		for (i32 i = 0; i < layers[l]->tilesLen; i++) {
+			resolve_placeholder(&layers[l]->tiles[i].texture, uploaded);
+		}
+	}
+	array_range(map->textures, i) {
+		resolve_placeholder(&map->textures[i], uploaded);
+	}
+}
+
+static void resolve_placeholder(Texture2D *texture, const Texture2D *uploaded) {
+	if ((texture->id & PLACEHOLDER_TEXTURE_BIT) == 0) { return; }
+
+	const u32 index = texture->id & ~PLACEHOLDER_TEXTURE_BIT;
+	panicIf((i32)index >= array_length(uploaded), "texture placeholder %d was never uploaded", index);
+	*texture = uploaded[index];
+}
+
+// textures already in the texture cache are shared, anything else is loaded
+// right away on the main thread, or decoded into a placeholder when building a
+// deferred map. Only what the map brings in counts as its texture memory.
+static Texture2D load_map_texture(const char *path) {
+	Texture2D texture = {};
+	if (texture_cache_acquire(path, &texture)) {
+		array_push(loadingTextures, texture);
+		return texture;
+	}
+
+	if (!deferTextureUploads) {
+		texture = platform_load_texture(path);
+		panicIf(!IsTextureReady(texture), "failed to load texture %s", path);
+		texture = texture_cache_insert(path, texture);
+		loadedTextureBytes += GetPixelDataSize(texture.width, texture.height, texture.format);
+		array_push(loadingTextures, texture);
+		return texture;
+	}
+
+	const Image image = LoadImage(path);
+	panicIf(!IsImageReady(image), "failed to load image %s", path);
+	loadedTextureBytes += GetPixelDataSize(image.width, image.height, image.format);
+	const Texture2D placeholder = {
+		.id = PLACEHOLDER_TEXTURE_BIT | (u32)array_length(deferredTextures),
+		.width = image.width,
+		.height = image.height,
+		.mipmaps = image.mipmaps,
+		.format = image.format,
+	};
+	PendingTexture pending = {.image = image};
+	snprintf(pending.path, sizeof(pending.path), "%s", path);
+	array_push(deferredTextures, pending);
+	array_push(loadingTextures, placeholder);
+	return placeholder;
+}
+
+static void begin_map_load(Arena *arena, const MapInfo *mapInfo) {
+	panicIf(loadingArena != nil, "already loading a map on this thread");
+
+	*arena = arena_new(mapInfo->name, MAP_ARENA_CHUNK_SIZE, MemoryTagMap);
+	loadingArena = arena;
+	loadingTextures = nil;
+	loadedTextureBytes = 0;
+}
+
+// the arena is moved into the map it holds, from here on map->arena is the
+// only copy.
+static Map *end_map_load(Map *map) {
+	map->textures = loadingTextures;
+	map->textureBytes = loadedTextureBytes;
+	map->arena = *loadingArena;
+	memory_track_arena(&map->arena);
+
+	loadingArena = nil;
+	loadingTextures = nil;
+	return map;
+}
+
+// for loads given up halfway, whatever was built is dropped with the arena.
+static void abort_map_load() {
+	array_range(loadingTextures, i) {
+		if ((loadingTextures[i].id & PLACEHOLDER_TEXTURE_BIT) == 0) {
+			texture_cache_release(loadingTextures[i]);
+		}
+	}
+	if (loadingTextures != nil) {
+		array_free(loadingTextures);
+	}
+	arena_free(loadingArena);
+
+	loadingArena = nil;
+	loadingTextures = nil;
+}
+
+static Arena *loading_arena() {
+	panicIfNil(loadingArena, "map memory requested outside of a map load");
+	return loadingArena;
+}
+
+static Map *load_tmx_map(const MapInfo *mapInfo, tmx_map *tiledMap) {
+	PROFILE_FUNCTION();
+	Map *map = arena_alloc(loading_arena(), sizeof(*map));
 
-	map->id = mapID;
+	map->id = mapInfo->id;
 	map->backgroundSprites = nil;
 	map->mainSprites = nil;
 	map->foregroundSprites = nil;
 	map->transitionBoxes = nil;
 
-	map->tiledMap = tmx_load(mapInfo.mapFilePath);
-	panicIfNil(map->tiledMap, "tmx_error: %s", tmx_strerr());
+	map->tiledMap = tiledMap;
+	map->backgroundColor = int_to_color(tiledMap->backgroundcolor);
+	map->width = (f32)(tiledMap->width * tiledMap->tile_width);
+	map->height = (f32)(tiledMap->height * tiledMap->tile_height);
 
 	// in a real game, this wouldn't work? The way the maps are set up, every map
 	// has the same layers, so it works, in a real game, that may or may not
@@ -193,22 +499,16 @@ Map *load_map(const MapID mapID) {
 	// sprites
 	map->waterSpritesList = init_water_sprites(waterLayer);
 	map->coastLineSpritesList = init_coast_line_sprites(coastLineLayer);
-	map->overWorldCharacters = init_over_world_characters(entitiesLayer);
+	map->characterSpawns = init_character_spawns(entitiesLayer);
+
+	map->terrainLayer = init_tile_layer(map, terrainLayer);
+	map->terrainTopLayer = init_tile_layer(map, terrainTopLayer);
 
 	init_monster_encounter_sprites(map, monsterEncounterLayer);
-	init_terrain_sprites(map, terrainLayer, false);
-	init_terrain_sprites(map, terrainTopLayer, true);
 	init_object_sprites(map, objectsLayer);
 	init_collision_sprites(map, collisionsLayer);
 	init_transition_sprites(map, transitionsLayer);
 
-	game.gameMetrics.totalSprites += array_length(map->waterSpritesList) +
-									 array_length(map->coastLineSpritesList) +
-									 array_length(map->overWorldCharacters) +
-									 array_length(map->backgroundSprites) +
-									 array_length(map->mainSprites) +
-									 array_length(map->foregroundSprites);
-
 	// y-sort sprites
 	// (todo) - this is potentially bad, if the sprites structs change, this would
 	//  blow up and im too lazy to make generic structs
@@ -232,41 +532,605 @@ Map *load_map(const MapID mapID) {
 	);
 
 	// get player starting position
-	const tmx_object *startingPlayerObject = tmx_find_object_by_id(map->tiledMap, mapInfo.startingPositionObjectID);
+	const tmx_object *startingPlayerObject = tmx_find_object_by_id(map->tiledMap, mapInfo->startingPositionObjectID);
 	panicIfNil(startingPlayerObject);
 	map->playerStartingPosition = (Vector2){
 		.x = (f32)startingPlayerObject->x,
 		.y = (f32)startingPlayerObject->y,
 	};
 	// map->playerStartingPosition = find_player_position(entitiesLayer);
+
+	finish_map_load(map);
 	return map;
 }
 
-void map_free(Map *map) {
-	// todo(hector) - free new generic sprites array
-	array_free(map->transitionBoxes);
-	array_free(map->collisionBoxes);
-	array_free(map->backgroundSprites);
-	array_free(map->mainSprites);
-	array_free(map->foregroundSprites);
+// everything derived from the map data, shared by the .tmx and compiled paths.
+static void finish_map_load(Map *map) {
+	PROFILE_FUNCTION();
+	Arena *arena = loading_arena();
+	map->waterSpritesList = array_freeze(map->waterSpritesList, arena);
+	map->waterRegions = array_freeze(init_water_regions(map->waterSpritesList), arena);
+	map->coastLineSpritesList = array_freeze(map->coastLineSpritesList, arena);
+	map->characterSpawns = array_freeze(map->characterSpawns, arena);
+	map->encounterPatches = array_freeze(map->encounterPatches, arena);
+	map->backgroundSprites = array_freeze(map->backgroundSprites, arena);
+	map->mainSprites = array_freeze(map->mainSprites, arena);
+	map->foregroundSprites = array_freeze(map->foregroundSprites, arena);
+	map->collisionBoxes = array_freeze(map->collisionBoxes, arena);
+	map->transitionBoxes = array_freeze(map->transitionBoxes, arena);
+
+	// clocks are runtime handles, compiled maps come with whatever was written.
+	array_range(map->waterSpritesList, i) {
+		AnimatedTexturesSprite *sprite = &map->waterSpritesList[i];
+		sprite->clock = animation_clock_for(sprite->animationSpeed, sprite->framesLen);
+	}
+	array_range(map->coastLineSpritesList, i) {
+		AnimatedTiledSprite *sprite = &map->coastLineSpritesList[i];
+		sprite->clock = animation_clock_for(sprite->animationSpeed, sprite->framesLen);
+	}
 
-	array_free(map->waterSpritesList);
-	map->waterSpritesList = nil;
+	map->overWorldCharacters = build_over_world_characters(map);
+	map->terrainChunks = init_terrain_chunks(map);
+	init_sprite_chunks(map);
+	init_static_colliders(map);
+	init_biome_grid(map);
+	init_encounter_tables(map);
+	init_sorted_characters(map);
+	init_character_colliders(map);
+
+	map->totalSprites = map->terrainLayer.usedCells +
+									 map->terrainTopLayer.usedCells +
+									 array_length(map->waterSpritesList) +
+									 array_length(map->coastLineSpritesList) +
+									 array_length(map->overWorldCharacters) +
+									 array_length(map->backgroundSprites) +
+									 array_length(map->mainSprites) +
+									 array_length(map->foregroundSprites);
+}
+
+static void compiled_map_path(const MapInfo *mapInfo, char *outPath, const usize len) {
+	snprintf(outPath, len, maps_dir "%s" COMPILED_MAP_EXTENSION, mapInfo->name);
+}
+
+// the item size of every section, a compiled file with different sizes was
+// written by a build with different structs and can't be used.
+static void compiled_map_item_sizes(u32 *outSizes) {
+	outSizes[CompiledMapSectionTextures] = sizeof(CompiledMapTexture);
+	outSizes[CompiledMapSectionBackgroundSprites] = sizeof(StaticSprite);
+	outSizes[CompiledMapSectionMainSprites] = sizeof(StaticSprite);
+	outSizes[CompiledMapSectionForegroundSprites] = sizeof(StaticSprite);
+	outSizes[CompiledMapSectionWaterSprites] = sizeof(AnimatedTexturesSprite);
+	outSizes[CompiledMapSectionCoastLineSprites] = sizeof(AnimatedTiledSprite);
+	outSizes[CompiledMapSectionCollisionBoxes] = sizeof(Rectangle);
+	outSizes[CompiledMapSectionTransitionBoxes] = sizeof(TransitionSprite);
+	outSizes[CompiledMapSectionCharacterSpawns] = sizeof(CharacterSpawn);
+	outSizes[CompiledMapSectionTerrainGids] = sizeof(u16);
+	outSizes[CompiledMapSectionTerrainTiles] = sizeof(TileLayerTile);
+	outSizes[CompiledMapSectionTerrainTopGids] = sizeof(u16);
+	outSizes[CompiledMapSectionTerrainTopTiles] = sizeof(TileLayerTile);
+	outSizes[CompiledMapSectionEncounterPatches] = sizeof(EncounterPatch);
+}
+
+static Map *load_compiled_map(const MapInfo *mapInfo) {
+	PROFILE_FUNCTION();
+	char path[256];
+	compiled_map_path(mapInfo, path, sizeof(path));
+	u32 itemSizes[CompiledMapSectionCount];
+	compiled_map_item_sizes(itemSizes);
+
+	CompiledMapFile file = {};
+	if (!compiled_map_open(path, mapInfo->mapFilePath, itemSizes, &file)) {
+		return nil;
+	}
+	const CompiledMapHeader *header = file.header;
+
+	Map *map = arena_alloc(loading_arena(), sizeof(*map));
+	map->id = mapInfo->id;
+	map->backgroundColor = header->backgroundColor;
+	map->width = header->width;
+	map->height = header->height;
+	map->playerStartingPosition = header->playerStartingPosition;
+
+	// texture table, files are loaded by the map, the rest are shared assets.
+	u32 texturesLen = 0;
+	const CompiledMapTexture *textureTable = compiled_map_section(&file, CompiledMapSectionTextures, &texturesLen);
+	Texture2D *resolved = nil;
+	for (u32 i = 0; i < texturesLen; i++) {
+		Texture2D texture = {};
+		switch (textureTable[i].source) {
+			case CompiledMapTextureSourceFile:
+				texture = load_map_texture(textureTable[i].path);
+				panicIf(texture.id == 0, "failed to load %s for compiled map", textureTable[i].path);
+				break;
+			case CompiledMapTextureSourceGrass:
+				texture = assets.grassTexture;
+				break;
+			case CompiledMapTextureSourceIceGrass:
+				texture = assets.iceGrassTexture;
+				break;
+			case CompiledMapTextureSourceSand:
+				texture = assets.sandTexture;
+				break;
+			case CompiledMapTextureSourceCoastLine:
+				texture = assets.tileMaps.coastLine.texture;
+				break;
+			case CompiledMapTextureSourceCount:
+			default:
+				panic("unknown compiled map texture source %d", textureTable[i].source);
+		}
+		array_push(resolved, texture);
+	}
+
+	map->backgroundSprites = copy_compiled_section(&file, CompiledMapSectionBackgroundSprites);
+	map->mainSprites = copy_compiled_section(&file, CompiledMapSectionMainSprites);
+	map->foregroundSprites = copy_compiled_section(&file, CompiledMapSectionForegroundSprites);
+	StaticSprite *staticSprites[] = {map->backgroundSprites, map->mainSprites, map->foregroundSprites};
+	for (usize l = 0; l < comptime_array_len(staticSprites); l++) {
+		array_range(staticSprites[l], i) {
+			StaticSprite *sprite = &staticSprites[l][i];
+			sprite->texture = resolve_compiled_texture(resolved, sprite->texture);
+			sprite->entity.id = sprite->texture.id;
+		}
+	}
+
+	map->waterSpritesList = copy_compiled_section(&file, CompiledMapSectionWaterSprites);
+	array_range(map->waterSpritesList, i) {
+		map->waterSpritesList[i].textures = assets.waterTextures.texturesList;
+	}
+	map->coastLineSpritesList = copy_compiled_section(&file, CompiledMapSectionCoastLineSprites);
+	array_range(map->coastLineSpritesList, i) {
+		AnimatedTiledSprite *sprite = &map->coastLineSpritesList[i];
+		sprite->texture = resolve_compiled_texture(resolved, sprite->texture);
+	}
 
-	array_free(map->coastLineSpritesList);
-	map->coastLineSpritesList = nil;
+	map->collisionBoxes = copy_compiled_section(&file, CompiledMapSectionCollisionBoxes);
+	map->transitionBoxes = copy_compiled_section(&file, CompiledMapSectionTransitionBoxes);
+	map->characterSpawns = copy_compiled_section(&file, CompiledMapSectionCharacterSpawns);
+	map->encounterPatches = copy_compiled_section(&file, CompiledMapSectionEncounterPatches);
+
+	map->terrainLayer = copy_compiled_tile_layer(
+		&file,
+		header->terrain,
+		CompiledMapSectionTerrainGids,
+		CompiledMapSectionTerrainTiles,
+		resolved
+	);
+	map->terrainTopLayer = copy_compiled_tile_layer(
+		&file,
+		header->terrainTop,
+		CompiledMapSectionTerrainTopGids,
+		CompiledMapSectionTerrainTopTiles,
+		resolved
+	);
+
+	if (resolved != nil) { array_free(resolved); }
+	compiled_map_close(&file);
+
+	finish_map_load(map);
+	return map;
+}
+
+// compiled textures keep their index in the texture table plus one in the id.
+static Texture2D resolve_compiled_texture(const Texture2D *resolved, const Texture2D texture) {
+	if (texture.id == 0) { return (Texture2D){}; }
+
+	panicIf((i32)texture.id > array_length(resolved), "compiled map texture %d is out of range", texture.id);
+	return resolved[texture.id - 1];
+}
+
+// copies a section into an array in the map arena, the same kind of array the
+// .tmx path ends up with.
+static void *copy_compiled_section(const CompiledMapFile *file, const CompiledMapSection section) {
+	u32 count = 0;
+	const void *data = compiled_map_section(file, section, &count);
+	if (count == 0) { return nil; }
+
+	const u32 itemSize = file->header->sections[section].itemSize;
+	void *array = array_arena_hold(loading_arena(), (i32)count, (i32)itemSize);
+	memcpy(array, data, (usize)count * itemSize);
+	return array;
+}
+
+static TileLayer copy_compiled_tile_layer(
+	const CompiledMapFile *file,
+	const CompiledMapTileLayerInfo info,
+	const CompiledMapSection gidsSection,
+	const CompiledMapSection tilesSection,
+	const Texture2D *resolved
+) {
+	u32 gidsLen = 0;
+	u32 tilesLen = 0;
+	const u16 *gids = compiled_map_section(file, gidsSection, &gidsLen);
+	const TileLayerTile *tiles = compiled_map_section(file, tilesSection, &tilesLen);
+	if (gidsLen == 0) { return (TileLayer){}; }
+	panicIf(gidsLen != (u32)(info.columns * info.rows), "compiled tile layer has %d cells, expected %d", gidsLen, info.columns * info.rows);
+
+	TileLayer layer = {
+		.columns = info.columns,
+		.rows = info.rows,
+		.tileWidth = info.tileWidth,
+		.tileHeight = info.tileHeight,
+		.tilesLen = (i32)tilesLen,
+		.usedCells = info.usedCells,
+	};
+	layer.gids = arena_alloc(loading_arena(), sizeof(*layer.gids) * gidsLen);
+	memcpy(layer.gids, gids, sizeof(*layer.gids) * gidsLen);
+
+	layer.tiles = arena_alloc(loading_arena(), sizeof(*layer.tiles) * tilesLen);
+	for (u32 i = 0; i < tilesLen; i++) {
+		layer.tiles[i] = tiles[i];
+		layer.tiles[i].texture = resolve_compiled_texture(resolved, tiles[i].texture);
+	}
+	return layer;
+}
+
+// the layers load_tmx_map can't do without.
+static const char *find_missing_layer(const tmx_map *tiledMap) {
+	const char *requiredLayers[] = {
+		"Terrain", "Terrain Top", "Monsters", "Entities", "Objects", "Collisions", "Transition", "Water", "Coast",
+	};
+	for (usize i = 0; i < comptime_array_len(requiredLayers); i++) {
+		if (tmx_find_layer_by_name(tiledMap, requiredLayers[i]) == nil) {
+			return requiredLayers[i];
+		}
+	}
+	return nil;
+}
+
+// finds the texture in the table, adding it when missing, and returns what
+// goes in the texture id of the compiled sprite.
+static u32 compiled_texture_ref(CompiledMapTexture **table, const Texture2D texture) {
+	if (texture.id == 0) { return 0; }
+
+	CompiledMapTexture entry = {};
+	if (texture.id == assets.grassTexture.id) {
+		entry.source = CompiledMapTextureSourceGrass;
+	} else if (texture.id == assets.iceGrassTexture.id) {
+		entry.source = CompiledMapTextureSourceIceGrass;
+	} else if (texture.id == assets.sandTexture.id) {
+		entry.source = CompiledMapTextureSourceSand;
+	} else if (texture.id == assets.tileMaps.coastLine.texture.id) {
+		entry.source = CompiledMapTextureSourceCoastLine;
+	} else {
+		const bool cached = texture_cache_path(texture.id, entry.path, sizeof(entry.path));
+		panicIf(!cached, "texture %d was not loaded by the map", texture.id);
+		entry.source = CompiledMapTextureSourceFile;
+	}
+
+	array_range(*table, i) {
+		const CompiledMapTexture *existing = &(*table)[i];
+		if (existing->source == entry.source && streq(existing->path, entry.path)) {
+			return (u32)i + 1;
+		}
+	}
+	array_push(*table, entry);
+	return (u32)array_length(*table);
+}
+
+static StaticSprite *compiled_static_sprites(CompiledMapTexture **table, const StaticSprite *sprites) {
+	StaticSprite *compiled = nil;
+	array_range(sprites, i) {
+		StaticSprite sprite = sprites[i];
+		sprite.texture.id = compiled_texture_ref(table, sprite.texture);
+		array_push(compiled, sprite);
+	}
+	return compiled;
+}
+
+static TileLayerTile *compiled_tiles(CompiledMapTexture **table, const TileLayer *layer) {
+	TileLayerTile *compiled = nil;
+	for (i32 i = 0; i < layer->tilesLen; i++) {
+		TileLayerTile tile = layer->tiles[i];
+		tile.texture.id = compiled_texture_ref(table, tile.texture);
+		array_push(compiled, tile);
+	}
+	return compiled;
+}
+
+static CompiledMapTileLayerInfo compiled_tile_layer_info(const TileLayer *layer) {
+	return (CompiledMapTileLayerInfo){
+		.columns = layer->columns,
+		.rows = layer->rows,
+		.tileWidth = layer->tileWidth,
+		.tileHeight = layer->tileHeight,
+		.usedCells = layer->usedCells,
+	};
+}
+
+static bool compile_map(const MapInfo *mapInfo) {
+	Arena arena;
+	begin_map_load(&arena, mapInfo);
+	tmx_map *tiledMap = tmx_load(mapInfo->mapFilePath);
+	if (tiledMap == nil) {
+		slogw("could not load %s: %s", mapInfo->mapFilePath, tmx_strerr());
+		abort_map_load();
+		return false;
+	}
+	const char *missingLayer = find_missing_layer(tiledMap);
+	if (missingLayer != nil) {
+		slogw("skipping %s, it has no '%s' layer", mapInfo->mapFilePath, missingLayer);
+		abort_map_load();
+		return true;
+	}
+
+	CompiledMapHeader header = {};
+	if (!compiled_map_source_info(mapInfo->mapFilePath, &header.sourceSize, &header.sourceModifiedTime)) {
+		abort_map_load();
+		return false;
+	}
+	for (const tmx_tileset_list *tileset = tiledMap->ts_head; tileset != nil; tileset = tileset->next) {
+		if (tileset->is_embedded) { continue; }
+
+		if (!compiled_map_add_tileset(&header, mapInfo->mapFilePath, tileset->source)) {
+			abort_map_load();
+			return false;
+		}
+	}
+
+	Map *map = end_map_load(load_tmx_map(mapInfo, tiledMap));
+	header.backgroundColor = map->backgroundColor;
+	header.playerStartingPosition = map->playerStartingPosition;
+	header.width = map->width;
+	header.height = map->height;
+	header.terrain = compiled_tile_layer_info(&map->terrainLayer);
+	header.terrainTop = compiled_tile_layer_info(&map->terrainTopLayer);
+
+	CompiledMapTexture *textures = nil;
+	StaticSprite *backgroundSprites = compiled_static_sprites(&textures, map->backgroundSprites);
+	StaticSprite *mainSprites = compiled_static_sprites(&textures, map->mainSprites);
+	StaticSprite *foregroundSprites = compiled_static_sprites(&textures, map->foregroundSprites);
+	TileLayerTile *terrainTiles = compiled_tiles(&textures, &map->terrainLayer);
+	TileLayerTile *terrainTopTiles = compiled_tiles(&textures, &map->terrainTopLayer);
+
+	AnimatedTiledSprite *coastLineSprites = nil;
+	array_range(map->coastLineSpritesList, i) {
+		AnimatedTiledSprite sprite = map->coastLineSpritesList[i];
+		sprite.texture.id = compiled_texture_ref(&textures, sprite.texture);
+		array_push(coastLineSprites, sprite);
+	}
+	// the water frames always come from the assets, the pointer is set on load.
+	AnimatedTexturesSprite *waterSprites = nil;
+	array_range(map->waterSpritesList, i) {
+		AnimatedTexturesSprite sprite = map->waterSpritesList[i];
+		panicIf(sprite.textures != assets.waterTextures.texturesList, "water sprite with unexpected textures");
+		sprite.textures = nil;
+		array_push(waterSprites, sprite);
+	}
+
+	u32 itemSizes[CompiledMapSectionCount];
+	compiled_map_item_sizes(itemSizes);
+	const void *sectionsData[CompiledMapSectionCount] = {
+		[CompiledMapSectionTextures] = textures,
+		[CompiledMapSectionBackgroundSprites] = backgroundSprites,
+		[CompiledMapSectionMainSprites] = mainSprites,
+		[CompiledMapSectionForegroundSprites] = foregroundSprites,
+		[CompiledMapSectionWaterSprites] = waterSprites,
+		[CompiledMapSectionCoastLineSprites] = coastLineSprites,
+		[CompiledMapSectionCollisionBoxes] = map->collisionBoxes,
+		[CompiledMapSectionTransitionBoxes] = map->transitionBoxes,
+		[CompiledMapSectionCharacterSpawns] = map->characterSpawns,
+		[CompiledMapSectionTerrainGids] = map->terrainLayer.gids,
+		[CompiledMapSectionTerrainTiles] = terrainTiles,
+		[CompiledMapSectionTerrainTopGids] = map->terrainTopLayer.gids,
+		[CompiledMapSectionTerrainTopTiles] = terrainTopTiles,
+		[CompiledMapSectionEncounterPatches] = map->encounterPatches,
+	};
+	const u32 sectionsLen[CompiledMapSectionCount] = {
+		[CompiledMapSectionTextures] = array_length(textures),
+		[CompiledMapSectionBackgroundSprites] = array_length(backgroundSprites),
+		[CompiledMapSectionMainSprites] = array_length(mainSprites),
+		[CompiledMapSectionForegroundSprites] = array_length(foregroundSprites),
+		[CompiledMapSectionWaterSprites] = array_length(waterSprites),
+		[CompiledMapSectionCoastLineSprites] = array_length(coastLineSprites),
+		[CompiledMapSectionCollisionBoxes] = array_length(map->collisionBoxes),
+		[CompiledMapSectionTransitionBoxes] = array_length(map->transitionBoxes),
+		[CompiledMapSectionCharacterSpawns] = array_length(map->characterSpawns),
+		[CompiledMapSectionTerrainGids] = map->terrainLayer.gids != nil ? map->terrainLayer.columns * map->terrainLayer.rows : 0,
+		[CompiledMapSectionTerrainTiles] = array_length(terrainTiles),
+		[CompiledMapSectionTerrainTopGids] = map->terrainTopLayer.gids != nil ? map->terrainTopLayer.columns * map->terrainTopLayer.rows : 0,
+		[CompiledMapSectionTerrainTopTiles] = array_length(terrainTopTiles),
+		[CompiledMapSectionEncounterPatches] = array_length(map->encounterPatches),
+	};
+	CompiledMapSectionData sections[CompiledMapSectionCount];
+	for (i32 i = 0; i < CompiledMapSectionCount; i++) {
+		sections[i] = (CompiledMapSectionData){
+			.data = sectionsData[i],
+			.count = sectionsLen[i],
+			.itemSize = itemSizes[i],
+		};
+	}
+
+	char path[256];
+	compiled_map_path(mapInfo, path, sizeof(path));
+	const bool ok = compiled_map_write(path, header, sections);
+	if (ok) {
+		slogi("compiled %s into %s, %d textures", mapInfo->mapFilePath, path, array_length(textures));
+	}
+
+	void *compiledArrays[] = {
+		textures, backgroundSprites, mainSprites, foregroundSprites, terrainTiles, terrainTopTiles, coastLineSprites,
+		waterSprites,
+	};
+	for (usize i = 0; i < comptime_array_len(compiledArrays); i++) {
+		if (compiledArrays[i] != nil) { array_free(compiledArrays[i]); }
+	}
+	map_free(map);
+	return ok;
+}
+
+bool maps_manager_compile_all() {
+	panicIf(!loaded, "maps_manager was initialize, forgot to call maps_manager_init()?");
+
+	bool ok = true;
+	for (usize i = 0; i < comptime_array_len(mapAtlas); i++) {
+		ok = compile_map(&mapAtlas[i]) && ok;
+	}
+	return ok;
+}
+
+void maps_manager_bench_load(const i32 iterations) {
+	panicIf(!loaded, "maps_manager was initialize, forgot to call maps_manager_init()?");
+	panicIf(iterations <= 0, "benchmark needs at least one iteration");
+
+	printfln("%-10s %14s %14s %8s", "map", "tmx (ms)", "compiled (ms)", "speedup");
+	for (usize m = 0; m < comptime_array_len(mapAtlas); m++) {
+		const MapInfo *mapInfo = &mapAtlas[m];
+
+		f64 start = GetTime();
+		bool skipped = false;
+		for (i32 i = 0; i < iterations && !skipped; i++) {
+			Arena arena;
+			begin_map_load(&arena, mapInfo);
+			tmx_map *tiledMap = tmx_load(mapInfo->mapFilePath);
+			panicIfNil(tiledMap, "tmx_error: %s", tmx_strerr());
+			if (find_missing_layer(tiledMap) != nil) {
+				abort_map_load();
+				skipped = true;
+				break;
+			}
+			map_free(end_map_load(load_tmx_map(mapInfo, tiledMap)));
+		}
+		if (skipped) {
+			printfln("%-10s %14s", mapInfo->name, "skipped");
+			continue;
+		}
+		const f64 tmxMs = (GetTime() - start) * 1000.0 / iterations;
+
+		start = GetTime();
+		for (i32 i = 0; i < iterations && !skipped; i++) {
+			Arena arena;
+			begin_map_load(&arena, mapInfo);
+			Map *map = load_compiled_map(mapInfo);
+			if (map == nil) {
+				abort_map_load();
+				skipped = true;
+				break;
+			}
+			map_free(end_map_load(map));
+		}
+		if (skipped) {
+			printfln("%-10s %14.3f %14s", mapInfo->name, tmxMs, "not compiled");
+			continue;
+		}
+		const f64 compiledMs = (GetTime() - start) * 1000.0 / iterations;
+		printfln("%-10s %14.3f %14.3f %7.1fx", mapInfo->name, tmxMs, compiledMs, tmxMs / compiledMs);
+	}
+}
+
+// every npc looks at a point somewhere within the range, the same npcs and
+// points on every run.
+#define BENCH_LINE_OF_SIGHT_RANGE (TILE_SIZE * 8)
+#define BENCH_LINE_OF_SIGHT_REPEATS 20
+
+void maps_manager_bench_line_of_sight(const i32 npcs) {
+	panicIf(!loaded, "maps_manager was initialize, forgot to call maps_manager_init()?");
+	panicIf(npcs <= 0, "benchmark needs at least one npc");
+
+	Map *map = load_map(MapIDWorld);
+	SetRandomSeed(1);
+	Vector2 *from = nil;
+	Vector2 *to = nil;
+	for (i32 i = 0; i < npcs; i++) {
+		const Vector2 npc = {
+			.x = (f32)GetRandomValue(0, (i32)map->width),
+			.y = (f32)GetRandomValue(0, (i32)map->height),
+		};
+		const f32 angle = (f32)GetRandomValue(0, 359) * DEG2RAD;
+		const f32 distance = (f32)GetRandomValue(0, BENCH_LINE_OF_SIGHT_RANGE);
+		array_push(from, npc);
+		array_push(to, ((Vector2){npc.x + (cosf(angle) * distance), npc.y + (sinf(angle) * distance)}));
+	}
+
+	i64 exactBlocked = 0;
+	f64 start = GetTime();
+	for (i32 r = 0; r < BENCH_LINE_OF_SIGHT_REPEATS; r++) {
+		array_range(from, i) {
+			exactBlocked += !map_line_of_sight_exact(map, from[i], to[i]);
+		}
+	}
+	const f64 exactMs = (GetTime() - start) * 1000.0;
+
+	i64 gridBlocked = 0;
+	start = GetTime();
+	for (i32 r = 0; r < BENCH_LINE_OF_SIGHT_REPEATS; r++) {
+		array_range(from, i) {
+			gridBlocked += !map_line_of_sight(map, from[i], to[i]);
+		}
+	}
+	const f64 gridMs = (GetTime() - start) * 1000.0;
+
+	i32 disagreements = 0;
+	array_range(from, i) {
+		disagreements += map_line_of_sight_exact(map, from[i], to[i]) != map_line_of_sight(map, from[i], to[i]);
+	}
+
+	const i64 rays = (i64)npcs * BENCH_LINE_OF_SIGHT_REPEATS;
+	printfln(
+		"%d npcs, %d collision boxes, %dx%d occupancy grid",
+		npcs,
+		array_length(map->collisionBoxes),
+		map->colliders.occupancy.columns,
+		map->colliders.occupancy.rows
+	);
+	printfln("%-8s %12s %14s %10s", "method", "total (ms)", "per ray (ns)", "blocked");
+	printfln("%-8s %12.3f %14.1f %10lld", "exact", exactMs, exactMs * 1e6 / (f64)rays, (long long)(exactBlocked / BENCH_LINE_OF_SIGHT_REPEATS));
+	printfln("%-8s %12.3f %14.1f %10lld", "grid", gridMs, gridMs * 1e6 / (f64)rays, (long long)(gridBlocked / BENCH_LINE_OF_SIGHT_REPEATS));
+	printfln("speedup %.1fx, %d of %d rays disagree", exactMs / gridMs, disagreements, npcs);
+
+	array_free(from);
+	array_free(to);
+	map_free(map);
+}
+
+// the arena takes the map data, libtmx's nodes and the map itself with it,
+// what is left is what lives outside of it, gpu resources and the npcs.
+void map_free(Map *map) {
+	free_terrain_chunks(&map->terrainChunks);
 
 	array_range(map->overWorldCharacters, i) {
 		character_free(&map->overWorldCharacters[i]);
 	}
-	array_free(map->overWorldCharacters);
-	map->overWorldCharacters = nil;
+	if (map->overWorldCharacters != nil) {
+		array_free(map->overWorldCharacters);
+	}
+	if (map->sortedCharacters != nil) {
+		array_free(map->sortedCharacters);
+	}
+	free_character_colliders(map);
 
-	// LibTMX
-	// todo - add to memory/memory.h
-	tmx_map_free(map->tiledMap);
+	array_range(map->textures, i) {
+		if ((map->textures[i].id & PLACEHOLDER_TEXTURE_BIT) == 0) {
+			texture_cache_release(map->textures[i]);
+		}
+	}
+	if (map->textures != nil) {
+		array_free(map->textures);
+	}
+	// freed before the upload finished, map->textures still has placeholders
+	// for what got uploaded so far.
+	array_range(map->pendingTextures, i) {
+		if (map->pendingTextures[i].image.data != nil) {
+			UnloadImage(map->pendingTextures[i].image);
+		}
+	}
+	if (map->pendingTextures != nil) {
+		array_free(map->pendingTextures);
+	}
+	array_range(map->uploadedTextures, i) {
+		texture_cache_release(map->uploadedTextures[i]);
+	}
+	if (map->uploadedTextures != nil) {
+		array_free(map->uploadedTextures);
+	}
+
+	if (visibleSprites != nil) {
+		array_free(visibleSprites);
+		visibleSprites = nil;
+	}
 
-	mfree(map, sizeof(*map), MemoryTagGame);
+	memory_untrack_arena(&map->arena);
+	Arena arena = map->arena;
+	arena_free(&arena);
 }
 
 MapID map_id_for_name(const char *name) {
@@ -280,6 +1144,7 @@ MapID map_id_for_name(const char *name) {
 }
 
 static void init_monster_encounter_sprites(Map *map, const tmx_layer *layer) {
+	PROFILE_FUNCTION();
 	const tmx_object *monsterTileH = layer->content.objgr->head;
 	while (monsterTileH) {
 		if (!monsterTileH->visible) {
@@ -287,6 +1152,7 @@ static void init_monster_encounter_sprites(Map *map, const tmx_layer *layer) {
 			continue;
 		}
 		const tmx_property *biomeProp = tmx_get_property(monsterTileH->properties, "biome");
+		panicIfNil(biomeProp, "monster patch %u has no biome", monsterTileH->id);
 		Texture2D texture = {};
 		WorldLayer worldLayer = WorldLayerMain;
 		if (streq(biomeProp->value.string, "ice")) {
@@ -326,11 +1192,58 @@ static void init_monster_encounter_sprites(Map *map, const tmx_layer *layer) {
 		} else if (worldLayer == WorldLayerBackground) {
 			array_push(map->backgroundSprites, s);
 		}
+
+		const Biome biome = biome_from_str(biomeProp->value.string);
+		const EncounterPatch patch = {
+			.area = rectangle_at(s.sourceFrame, s.entity.position),
+			.biome = biome,
+			.encounters = patch_encounters(map, biome, monsterTileH),
+		};
+		array_push(map->encounterPatches, patch);
 		monsterTileH = monsterTileH->next;
 	}
 }
 
+// the species a patch's monsters property lists, comma separated, all equally
+// likely and within ENCOUNTER_PATCH_LEVEL_SPREAD of its level property.
+static EncounterData patch_encounters(const Map *map, const Biome biome, const tmx_object *object) {
+	EncounterData data = {.biome = biome};
+	strncpy(data.map, mapAtlas[map->id].name, sizeof(data.map) - 1);
+
+	const tmx_property *monstersProp = tmx_get_property(object->properties, "monsters");
+	if (monstersProp == nil || monstersProp->value.string == nil || monstersProp->value.string[0] == '\0') {
+		return data;
+	}
+	const tmx_property *levelProp = tmx_get_property(object->properties, "level");
+	panicIfNil(levelProp, "monster patch %u lists monsters but has no level", object->id);
+	const i32 level = levelProp->type == PT_INT ? levelProp->value.integer : atoi(levelProp->value.string);
+	panicIf(level <= 0 || level > UINT8_MAX, "monster patch %u has an invalid level %d", object->id, level);
+
+	const char *cursor = monstersProp->value.string;
+	while (*cursor != '\0') {
+		while (*cursor == ' ') { cursor++; }
+		const char *end = strchr(cursor, ',');
+		usize len = end != nil ? (usize)(end - cursor) : strlen(cursor);
+		const usize nextLen = end != nil ? len + 1 : len;
+		while (len > 0 && cursor[len - 1] == ' ') { len--; }
+		char name[MAX_MONSTER_NAME_LEN] = {};
+		panicIf(len == 0 || len >= sizeof(name), "monster patch %u has a bad monsters list '%s'", object->id, monstersProp->value.string);
+		memcpy(name, cursor, len);
+
+		panicIf(data.len >= MAX_ENCOUNTER_SPECIES, "monster patch %u lists more than %d monsters", object->id, MAX_ENCOUNTER_SPECIES);
+		data.entries[data.len++] = (EncounterEntry){
+			.monster = monster_name_from_str(name),
+			.weight = 1.f,
+			.minLevel = (u8)max(level - ENCOUNTER_PATCH_LEVEL_SPREAD, 1),
+			.maxLevel = (u8)min(level + ENCOUNTER_PATCH_LEVEL_SPREAD, UINT8_MAX),
+		};
+		cursor += nextLen;
+	}
+	return data;
+}
+
 static AnimatedTexturesSprite *init_water_sprites(const tmx_layer *layer) {
+	PROFILE_FUNCTION();
 	AnimatedTexturesSprite *animatedSprite = nil;
 	const tmx_object *waterTileH = layer->content.objgr->head;
 	while (waterTileH) {
@@ -350,8 +1263,6 @@ static AnimatedTexturesSprite *init_water_sprites(const tmx_layer *layer) {
 					},
 					.textures = assets.waterTextures.texturesList,
 					.framesLen = 4,
-					.currentFrame = 0,
-					.frameTimer = 0.f,
 					.animationSpeed = settings.waterAnimationSpeed,
 				};
 				array_push(animatedSprite, waterSprite);
@@ -364,6 +1275,42 @@ static AnimatedTexturesSprite *init_water_sprites(const tmx_layer *layer) {
 	return animatedSprite;
 }
 
+// the water sprites keep the id of the object they were cut from, so the
+// objects come back as the bounds of their tiles. Compiled maps only have the
+// sprites, this works the same for both.
+static Rectangle *init_water_regions(const AnimatedTexturesSprite *waterSprites) {
+	Rectangle *regions = nil;
+	u32 *regionIDs = nil;
+	array_range(waterSprites, i) {
+		const AnimatedTexturesSprite sprite = waterSprites[i];
+		const Rectangle tile = rectangle_at(rectangle_from_texture(sprite.textures[0]), sprite.entity.position);
+
+		i32 region = -1;
+		array_range(regionIDs, r) {
+			if (regionIDs[r] == sprite.entity.id) {
+				region = r;
+				break;
+			}
+		}
+		if (region < 0) {
+			array_push(regions, tile);
+			array_push(regionIDs, sprite.entity.id);
+			continue;
+		}
+
+		Rectangle *bounds = &regions[region];
+		const f32 right = max(bounds->x + bounds->width, tile.x + tile.width);
+		const f32 bottom = max(bounds->y + bounds->height, tile.y + tile.height);
+		bounds->x = min(bounds->x, tile.x);
+		bounds->y = min(bounds->y, tile.y);
+		bounds->width = right - bounds->x;
+		bounds->height = bottom - bounds->y;
+	}
+
+	if (regionIDs != nil) { array_free(regionIDs); }
+	return regions;
+}
+
 _comptime_unused_
 static Vector2 find_player_position(const tmx_layer *layer) {
 	const tmx_object *characterH = layer->content.objgr->head;
@@ -377,8 +1324,8 @@ static Vector2 find_player_position(const tmx_layer *layer) {
 	return (Vector2){};
 }
 
-Character *init_over_world_characters(const tmx_layer *layer) {
-	Character *characters = nil;
+static CharacterSpawn *init_character_spawns(const tmx_layer *layer) {
+	CharacterSpawn *spawns = nil;
 	const tmx_object *characterH = layer->content.objgr->head;
 	while (characterH) {
 		if (!characterH->visible || streq(characterH->name, "Player")) {
@@ -391,31 +1338,6 @@ Character *init_over_world_characters(const tmx_layer *layer) {
 		const tmx_property *graphicProp = tmx_get_property(characterH->properties, "graphic");
 		const tmx_property *radiusProp = tmx_get_property(characterH->properties, "radius");
 
-		TileMap characterTiledMapID = {};
-		if (streq(graphicProp->value.string, "blond")) {
-			characterTiledMapID = assets.tileMaps.blondCharacter;
-		} else if (streq(graphicProp->value.string, "fire_boss")) {
-			characterTiledMapID = assets.tileMaps.fireBossCharacter;
-		} else if (streq(graphicProp->value.string, "grass_boss")) {
-			characterTiledMapID = assets.tileMaps.grassBossCharacter;
-		} else if (streq(graphicProp->value.string, "hat_girl")) {
-			characterTiledMapID = assets.tileMaps.hatGirlCharacter;
-		} else if (streq(graphicProp->value.string, "purple_girl")) {
-			characterTiledMapID = assets.tileMaps.purpleGirlCharacter;
-		} else if (streq(graphicProp->value.string, "straw")) {
-			characterTiledMapID = assets.tileMaps.strawCharacter;
-		} else if (streq(graphicProp->value.string, "water_boss")) {
-			characterTiledMapID = assets.tileMaps.waterBossCharacter;
-		} else if (streq(graphicProp->value.string, "young_girl")) {
-			characterTiledMapID = assets.tileMaps.youngGirlCharacter;
-		} else if (streq(graphicProp->value.string, "young_guy")) {
-			characterTiledMapID = assets.tileMaps.youngGuyCharacter;
-		}
-
-		if (!IsTextureReady(characterTiledMapID.texture)) {
-			panic("unexpected graphics property for entity %s", graphicProp->value.string);
-		}
-
 		CharacterDirection direction = CharacterDirectionNone;
 		if (streq(directionProp->value.string, "down")) {
 			direction = CharacterDirectionDown;
@@ -430,11 +1352,68 @@ Character *init_over_world_characters(const tmx_layer *layer) {
 			panic("unexpected direction property for entity: %s", directionProp->value.string);
 		}
 
+		CharacterSpawn spawn = {
+			.direction = direction,
+			.center = {.x = (f32)characterH->x, .y = (f32)characterH->y},
+		};
+		strncpy(spawn.id, characterIDProp->value.string, sizeof(spawn.id) - 1);
+		strncpy(spawn.graphic, graphicProp->value.string, sizeof(spawn.graphic) - 1);
+
+		if (radiusProp != nil) {
+			const i32 radius = atoi(radiusProp->value.string);
+			if (radius > 0) {
+				spawn.radius = (f32)radius;
+			}
+		}
+
+		array_push(spawns, spawn);
+		characterH = characterH->next;
+	}
+
+	return spawns;
+}
+
+static TileMap character_tile_map(const char *graphic) {
+	TileMap characterTiledMapID = {};
+	if (streq(graphic, "blond")) {
+		characterTiledMapID = assets.tileMaps.blondCharacter;
+	} else if (streq(graphic, "fire_boss")) {
+		characterTiledMapID = assets.tileMaps.fireBossCharacter;
+	} else if (streq(graphic, "grass_boss")) {
+		characterTiledMapID = assets.tileMaps.grassBossCharacter;
+	} else if (streq(graphic, "hat_girl")) {
+		characterTiledMapID = assets.tileMaps.hatGirlCharacter;
+	} else if (streq(graphic, "purple_girl")) {
+		characterTiledMapID = assets.tileMaps.purpleGirlCharacter;
+	} else if (streq(graphic, "straw")) {
+		characterTiledMapID = assets.tileMaps.strawCharacter;
+	} else if (streq(graphic, "water_boss")) {
+		characterTiledMapID = assets.tileMaps.waterBossCharacter;
+	} else if (streq(graphic, "young_girl")) {
+		characterTiledMapID = assets.tileMaps.youngGirlCharacter;
+	} else if (streq(graphic, "young_guy")) {
+		characterTiledMapID = assets.tileMaps.youngGuyCharacter;
+	}
+
+	if (!IsTextureReady(characterTiledMapID.texture)) {
+		panic("unexpected graphics property for entity %s", graphic);
+	}
+	return characterTiledMapID;
+}
+
+// maps load on a worker thread, so the rolls come from a stream of the map's
+// own instead of the game's, the same ones whenever and wherever it loads.
+static Character *build_over_world_characters(const Map *map) {
+	const CharacterSpawn *spawns = map->characterSpawns;
+	Rng rng = rng_new(rng_game_seed(), (u64)map->id + 1);
+	Character *characters = nil;
+	array_range(spawns, i) {
+		const CharacterSpawn *spawn = &spawns[i];
 		Character character = character_new(
 			(Vector2){},
-			characterTiledMapID,
-			direction,
-			characterIDProp->value.string
+			character_tile_map(spawn->graphic),
+			spawn->direction,
+			spawn->id
 		);
 		character.speed = settings.charactersSpeed;
 
@@ -442,25 +1421,22 @@ Character *init_over_world_characters(const tmx_layer *layer) {
 		character.canNoticePlayer = data->lookAround;
 		// ideally we want this to be driven by the character creation data,
 		// but giving a bit of randomness here is good enough for this game.
-		const f32 patrolInterval = (f32)GetRandomValue(1, (int)settings.charactersPatrolIntervalSecs);
-		timer_start(&character.patrolTimer, patrolInterval);
+		// only the interval, the timer is started by map_start_patrols.
+		character.patrolTimer.lifeTime = (f32)rng_range(&rng, 1, (i32)settings.charactersPatrolIntervalSecs);
 
-		if (radiusProp != nil) {
-			const i32 radius = atoi(radiusProp->value.string);
-			if (radius > 0) {
-				character.radius = (f32)radius;
-			}
+		if (spawn->radius > 0) {
+			character.radius = spawn->radius;
 		}
 
-		character_set_center_at(&character, (Vector2){.x = (f32)characterH->x, .y = (f32)characterH->y});
+		character_set_center_at(&character, spawn->center);
 		array_push(characters, character);
-		characterH = characterH->next;
 	}
 
 	return characters;
 }
 
 static AnimatedTiledSprite *init_coast_line_sprites(const tmx_layer *layer) {
+	PROFILE_FUNCTION();
 	AnimatedTiledSprite *spritesList = nil;
 
 	const tmx_object *coastLineH = layer->content.objgr->head;
@@ -562,66 +1538,136 @@ static AnimatedTiledSprite *init_coast_line_sprites(const tmx_layer *layer) {
 	return spritesList;
 }
 
-// I hate the boolean, but i don't feel like changing the way the map is setup
-// for this test project
-static void init_terrain_sprites(Map *map, const tmx_layer *layer, bool isTopLayer) {
+static TileLayer init_tile_layer(const Map *map, const tmx_layer *layer) {
 	if (layer == nil || layer->name == nil) {
 		printf("no layer found\n");
-		return;
+		return (TileLayer){};
 	}
 
-	for (u64 i = 0; i < map->tiledMap->height; i++) {
-		for (u64 j = 0; j < map->tiledMap->width; j++) {
-			const u32 gid = (layer->content.gids[(i * map->tiledMap->width) + j]) & TMX_FLIP_BITS_REMOVAL;
-			if (map->tiledMap->tiles[gid] == NULL) {
-				continue;
-			}
+	const tmx_map *tiledMap = map->tiledMap;
+	TileLayer tileLayer = {
+		.columns = (i32)tiledMap->width,
+		.rows = (i32)tiledMap->height,
+		.tileWidth = (f32)tiledMap->tile_width,
+		.tileHeight = (f32)tiledMap->tile_height,
+		.tilesLen = (i32)tiledMap->tilecount + 1, // GIDs start at 1
+	};
+	panicIf(tileLayer.tilesLen > UINT16_MAX, "map has too many tiles for u16 GIDs");
 
-			const tmx_tileset *tileSet = map->tiledMap->tiles[gid]->tileset;
-			void *image = tileSet->image->resource_image;
+	tileLayer.gids = arena_alloc(loading_arena(), sizeof(*tileLayer.gids) * tileLayer.columns * tileLayer.rows);
+	tileLayer.tiles = arena_alloc(loading_arena(), sizeof(*tileLayer.tiles) * tileLayer.tilesLen);
 
-			if (map->tiledMap->tiles[gid]->image) {
-				image = map->tiledMap->tiles[gid]->image->resource_image;
-			}
+	for (i32 i = 0; i < tileLayer.columns * tileLayer.rows; i++) {
+		const u32 gid = layer->content.gids[i] & TMX_FLIP_BITS_REMOVAL;
+		if (gid == 0 || tiledMap->tiles[gid] == nil) {
+			continue;
+		}
+		panicIf(gid >= (u32)tileLayer.tilesLen, "tile GID %d is out of range", gid);
+		tileLayer.gids[i] = (u16)gid;
+		tileLayer.usedCells++;
 
-			// i32 flags = (layer->content.gids[(i * map->tiledMap->width) + j]) & ~TMX_FLIP_BITS_REMOVAL;
-			const Rectangle sourceRec = {
-				.x = (f32)map->tiledMap->tiles[gid]->ul_x,
-				.y = (f32)map->tiledMap->tiles[gid]->ul_y,
+		// only fill the lookup table for the GIDs this layer uses
+		if (IsTextureReady(tileLayer.tiles[gid].texture)) {
+			continue;
+		}
+		const tmx_tile *tile = tiledMap->tiles[gid];
+		const tmx_tileset *tileSet = tile->tileset;
+		void *image = tileSet->image->resource_image;
+		if (tile->image) {
+			image = tile->image->resource_image;
+		}
+
+		tileLayer.tiles[gid] = (TileLayerTile){
+			.texture = *(Texture2D *)image,
+			.sourceFrame = {
+				.x = (f32)tile->ul_x,
+				.y = (f32)tile->ul_y,
 				.width = (f32)tileSet->tile_width,
 				.height = (f32)tileSet->tile_height,
-			};
-			const Vector2 destination = {
-				.x = (f32)(j * tileSet->tile_width),
-				.y = (f32)(i * tileSet->tile_height),
-			};
-			const Rectangle boundingBox = {
-				.x = destination.x,
-				.y = destination.y,
-				.height = sourceRec.height,
-				.width = sourceRec.width,
-			};
+			},
+		};
+	}
 
-			const Texture2D texture = *(Texture2D *)image;
-			const StaticSprite s = {
-				.entity = {
-					.id = texture.id,
-					.position = destination,
-					.layer = isTopLayer ? WorldLayerMain : WorldLayerBackground,
-					.ySort = destination.y + (boundingBox.height / 2),
-				},
-				.texture = texture,
-				.width = boundingBox.width,
-				.height = boundingBox.height,
-				.sourceFrame = sourceRec,
-			};
+	return tileLayer;
+}
 
-			array_push(map->backgroundSprites, s);
+static TerrainChunkCache init_terrain_chunks(const Map *map) {
+	const f32 mapWidth = (f32)map->terrainLayer.columns * map->terrainLayer.tileWidth;
+	const f32 mapHeight = (f32)map->terrainLayer.rows * map->terrainLayer.tileHeight;
+	TerrainChunkCache cache = {
+		.columns = (i32)ceilf(mapWidth / TERRAIN_CHUNK_SIZE),
+		.rows = (i32)ceilf(mapHeight / TERRAIN_CHUNK_SIZE),
+	};
+	const i32 chunksLen = cache.columns * cache.rows;
+	if (chunksLen == 0) { return cache; }
+
+	cache.chunks = arena_alloc(loading_arena(), sizeof(*cache.chunks) * chunksLen);
+	cache.chunkTiles = arena_alloc(loading_arena(), sizeof(*cache.chunkTiles) * chunksLen);
+
+	// counted up front so the metrics still show the tiles a baked chunk stands for.
+	const TileLayer *layers[] = {&map->terrainLayer, &map->terrainTopLayer};
+	for (usize l = 0; l < comptime_array_len(layers); l++) {
+		const TileLayer *layer = layers[l];
+		for (i32 i = 0; i < layer->columns * layer->rows; i++) {
+			if (layer->gids == nil || layer->gids[i] == 0) { continue; }
+			const i32 chunkCol = (i32)((f32)(i % layer->columns) * layer->tileWidth) / TERRAIN_CHUNK_SIZE;
+			const i32 chunkRow = (i32)((f32)(i / layer->columns) * layer->tileHeight) / TERRAIN_CHUNK_SIZE;
+			cache.chunkTiles[(chunkRow * cache.columns) + chunkCol]++;
+		}
+	}
+	return cache;
+}
+
+// the chunk arrays are in the map arena, only the baked textures need freeing.
+static void free_terrain_chunks(TerrainChunkCache *cache) {
+	if (cache->chunks == nil) { return; }
+
+	const i32 chunksLen = cache->columns * cache->rows;
+	for (i32 i = 0; i < chunksLen; i++) {
+		if (cache->chunks[i].id != 0) {
+			UnloadRenderTexture(cache->chunks[i]);
 		}
 	}
+	*cache = (TerrainChunkCache){};
+}
+
+// chunks on the right and bottom edges are cut to the size of the map.
+static Rectangle terrain_chunk_rect(const Map *map, const i32 col, const i32 row) {
+	const f32 mapWidth = (f32)map->terrainLayer.columns * map->terrainLayer.tileWidth;
+	const f32 mapHeight = (f32)map->terrainLayer.rows * map->terrainLayer.tileHeight;
+	const Rectangle rect = {
+		.x = (f32)(col * TERRAIN_CHUNK_SIZE),
+		.y = (f32)(row * TERRAIN_CHUNK_SIZE),
+	};
+	return (Rectangle){
+		.x = rect.x,
+		.y = rect.y,
+		.width = min((f32)TERRAIN_CHUNK_SIZE, mapWidth - rect.x),
+		.height = min((f32)TERRAIN_CHUNK_SIZE, mapHeight - rect.y),
+	};
+}
+
+static void bake_terrain_chunk(Map *map, const i32 col, const i32 row) {
+	const Rectangle rect = terrain_chunk_rect(map, col, row);
+	const RenderTexture2D target = LoadRenderTexture((i32)rect.width, (i32)rect.height);
+	panicIf(!IsRenderTextureReady(target), "failed to create render texture for terrain chunk");
+
+	const Vector2 offset = {.x = -rect.x, .y = -rect.y};
+	gpu_begin_texture_mode(target);
+	{
+		ClearBackground(BLANK);
+		draw_tile_layer_area(&map->terrainLayer, DrawLayerTerrain, rect, offset, false);
+		draw_tile_layer_area(&map->terrainTopLayer, DrawLayerTerrainTop, rect, offset, false);
+		draw_buffer_flush();
+	}
+	gpu_end_texture_mode();
+
+	map->terrainChunks.chunks[(row * map->terrainChunks.columns) + col] = target;
+	map->terrainChunks.bakedChunks++;
 }
 
 static void init_collision_sprites(Map *map, const tmx_layer *layer) {
+	PROFILE_FUNCTION();
 	if (layer == nil || layer->name == nil) {
 		printf("no layer objects found\n");
 		return;
@@ -648,6 +1694,7 @@ static void init_collision_sprites(Map *map, const tmx_layer *layer) {
 }
 
 void init_transition_sprites(Map *map, const tmx_layer *layer) {
+	PROFILE_FUNCTION();
 	const tmx_object *objectHead = layer->content.objgr->head;
 	while (objectHead) {
 		if (!objectHead->visible) {
@@ -692,7 +1739,196 @@ void init_transition_sprites(Map *map, const tmx_layer *layer) {
 	}
 }
 
+// the sprite lists must be sorted by now, chunks store indices into them and
+// hand them back in the same order.
+static void init_sprite_chunks(Map *map) {
+	PROFILE_FUNCTION();
+	const f32 mapWidth = map->width;
+	const f32 mapHeight = map->height;
+
+	map->spriteChunks.water = spatial_grid_new(mapWidth, mapHeight, MAP_CHUNK_SIZE);
+	array_range(map->waterSpritesList, i) {
+		const AnimatedTexturesSprite sprite = map->waterSpritesList[i];
+		const Rectangle bounds = rectangle_at(rectangle_from_texture(sprite.textures[0]), sprite.entity.position);
+		spatial_grid_insert(&map->spriteChunks.water, i, bounds);
+	}
+
+	map->spriteChunks.coastLine = spatial_grid_new(mapWidth, mapHeight, MAP_CHUNK_SIZE);
+	array_range(map->coastLineSpritesList, i) {
+		const AnimatedTiledSprite sprite = map->coastLineSpritesList[i];
+		const Rectangle bounds = rectangle_at(sprite.sourceFrames[0], sprite.entity.position);
+		spatial_grid_insert(&map->spriteChunks.coastLine, i, bounds);
+	}
+
+	map->spriteChunks.background = spatial_grid_new(mapWidth, mapHeight, MAP_CHUNK_SIZE);
+	array_range(map->backgroundSprites, i) {
+		const StaticSprite sprite = map->backgroundSprites[i];
+		spatial_grid_insert(&map->spriteChunks.background, i, rectangle_at(sprite.sourceFrame, sprite.entity.position));
+	}
+
+	map->spriteChunks.main = spatial_grid_new(mapWidth, mapHeight, MAP_CHUNK_SIZE);
+	array_range(map->mainSprites, i) {
+		const StaticSprite sprite = map->mainSprites[i];
+		spatial_grid_insert(&map->spriteChunks.main, i, rectangle_at(sprite.sourceFrame, sprite.entity.position));
+	}
+
+	map->spriteChunks.foreground = spatial_grid_new(mapWidth, mapHeight, MAP_CHUNK_SIZE);
+	array_range(map->foregroundSprites, i) {
+		const StaticSprite sprite = map->foregroundSprites[i];
+		spatial_grid_insert(&map->spriteChunks.foreground, i, rectangle_at(sprite.sourceFrame, sprite.entity.position));
+	}
+
+	Arena *arena = loading_arena();
+	spatial_grid_freeze(&map->spriteChunks.water, arena);
+	spatial_grid_freeze(&map->spriteChunks.coastLine, arena);
+	spatial_grid_freeze(&map->spriteChunks.background, arena);
+	spatial_grid_freeze(&map->spriteChunks.main, arena);
+	spatial_grid_freeze(&map->spriteChunks.foreground, arena);
+}
+
+// collision boxes can be as long as a cliff, so they go in every cell they
+// cover rather than growing every query by the size of the biggest one.
+static void init_static_colliders(Map *map) {
+	Rectangle *boxes = nil;
+	array_range(map->collisionBoxes, i) {
+		array_push(boxes, map->collisionBoxes[i]);
+	}
+	array_range(map->mainSprites, i) {
+		const Entity entity = map->mainSprites[i].entity;
+		if (!entity.collideable) { continue; }
+
+		array_push(boxes, entity.hitBox);
+	}
+
+	SpatialGrid grid = spatial_grid_new(map->width, map->height, MAP_CHUNK_SIZE);
+	array_range(boxes, i) {
+		spatial_grid_insert_spanning(&grid, i, boxes[i]);
+	}
+
+	Arena *arena = loading_arena();
+	spatial_grid_freeze(&grid, arena);
+	map->colliders.staticGrid = grid;
+	map->colliders.staticBoxes = array_freeze(boxes, arena);
+
+	// objects never blocked the view, only the collision boxes.
+	map->colliders.occupancy = occupancy_grid_new(arena, map->width, map->height, TILE_SIZE);
+	array_range(map->collisionBoxes, i) {
+		occupancy_grid_fill(&map->colliders.occupancy, map->collisionBoxes[i]);
+	}
+}
+
+// npcs are rebuilt on every visit, so their grid is too, outside the arena.
+static void init_character_colliders(Map *map) {
+	map->colliders.characterGrid = spatial_grid_new(map->width, map->height, MAP_CHUNK_SIZE);
+	array_range(map->overWorldCharacters, i) {
+		const Rectangle hitBox = map->overWorldCharacters[i].hitBox;
+		spatial_grid_insert(&map->colliders.characterGrid, i, hitBox);
+		array_push(map->colliders.characterBounds, hitBox);
+	}
+}
+
+static void free_character_colliders(Map *map) {
+	spatial_grid_free(&map->colliders.characterGrid);
+	if (map->colliders.characterBounds != nil) {
+		array_free(map->colliders.characterBounds);
+	}
+	map->colliders.characterBounds = nil;
+}
+
+bool map_collides(const Map *map, const Rectangle hitBox) {
+	// only used from the main thread, kept around to not allocate every call.
+	static i32 *candidates = nil;
+
+	game.gameMetrics.collisionColliders = array_length(map->colliders.staticBoxes) +
+										  array_length(map->overWorldCharacters);
+
+	array_clear(candidates);
+	spatial_grid_query(&map->colliders.staticGrid, hitBox, &candidates);
+	game.gameMetrics.collisionCandidates += array_length(candidates);
+	array_range(candidates, i) {
+		if (CheckCollisionRecs(hitBox, map->colliders.staticBoxes[candidates[i]])) {
+			return true;
+		}
+	}
+
+	array_clear(candidates);
+	spatial_grid_query(&map->colliders.characterGrid, hitBox, &candidates);
+	game.gameMetrics.collisionCandidates += array_length(candidates);
+	array_range(candidates, i) {
+		if (CheckCollisionRecs(hitBox, map->overWorldCharacters[candidates[i]].hitBox)) {
+			return true;
+		}
+	}
+	return false;
+}
+
+static void init_biome_grid(Map *map) {
+	map->biomes = biome_grid_new(loading_arena(), map->width, map->height, TILE_SIZE);
+
+	array_range(map->encounterPatches, i) {
+		const EncounterPatch *patch = &map->encounterPatches[i];
+		biome_grid_fill(&map->biomes, patch->area, patch->biome, patch_table_for(map, &patch->encounters));
+	}
+	map->patchEncounters = array_freeze(map->patchEncounters, loading_arena());
+}
+
+// the patches of a map mostly list the same few species, they share a table
+// per list. Returns the index of the table plus one, 0 for the biome's table.
+static u8 patch_table_for(Map *map, const EncounterData *encounters) {
+	if (encounters->len == 0) { return 0; }
+
+	array_range(map->patchEncounters, i) {
+		if (encounter_table_matches(&map->patchEncounters[i], encounters)) {
+			return (u8)(i + 1);
+		}
+	}
+	panicIf(array_length(map->patchEncounters) >= UINT8_MAX, "map %d has more than %d different monster patches", map->id, UINT8_MAX);
+	array_push(map->patchEncounters, encounter_table_new(encounters));
+	return (u8)array_length(map->patchEncounters);
+}
+
+static void init_encounter_tables(Map *map) {
+	const char *name = mapAtlas[map->id].name;
+	for (i32 biome = BiomeNone + 1; biome < BiomeCount; biome++) {
+		map->encounters[biome] = encounter_table_new(game_data_for_encounters(name, biome));
+	}
+}
+
+Biome map_biome_under(const Map *map, const Rectangle area, const EncounterTable **outEncounters) {
+	u8 table = 0;
+	const Biome biome = biome_grid_under(&map->biomes, area, &table);
+	*outEncounters = nil;
+	if (biome == BiomeNone) { return biome; }
+
+	*outEncounters = table > 0 ? &map->patchEncounters[table - 1] : &map->encounters[biome];
+	return biome;
+}
+
+bool map_line_of_sight(const Map *map, const Vector2 from, const Vector2 to) {
+	return occupancy_grid_line_clear(&map->colliders.occupancy, from, to);
+}
+
+bool map_line_of_sight_exact(const Map *map, const Vector2 from, const Vector2 to) {
+	array_range(map->collisionBoxes, i) {
+		if (line_intersects_rect(from, to, map->collisionBoxes[i])) {
+			return false;
+		}
+	}
+	return true;
+}
+
+// not the best, but works here. If need more performance, use Cohen-Sutherland algorithm
+// https://stackoverflow.com/a/23641016
+static bool line_intersects_rect(const Vector2 p1, const Vector2 p2, const Rectangle r) {
+	return CheckCollisionLines(p1, p2, (Vector2){r.x, r.y}, (Vector2){r.x + r.width, r.y}, nil) ||
+		   CheckCollisionLines(p1, p2, (Vector2){r.x + r.width, r.y}, (Vector2){r.x + r.width, r.y + r.height}, nil) ||
+		   CheckCollisionLines(p1, p2, (Vector2){r.x + r.width, r.y + r.height}, (Vector2){r.x, r.y + r.height}, nil) ||
+		   CheckCollisionLines(p1, p2, (Vector2){r.x, r.y + r.height}, (Vector2){r.x, r.y}, nil) ||
+		   (CheckCollisionPointRec(p1, r) && CheckCollisionPointRec(p2, r));
+}
+
 static void init_object_sprites(Map *map, const tmx_layer *layer) {
+	PROFILE_FUNCTION();
 	if (layer == nil || layer->name == nil) {
 		printf("no layer objects found\n");
 		return;
@@ -760,84 +1996,124 @@ static void init_object_sprites(Map *map, const tmx_layer *layer) {
 	}
 }
 
-void map_update(const Map *map, const f32 dt) {
-	for (i32 i = 0; i < array_length(map->waterSpritesList); i++) {
-		animated_textures_sprite_update(&map->waterSpritesList[i], dt);
+// water and coast sprites play off the shared animation clocks, only the
+// characters have anything of their own to update.
+void map_update(Map *map, const f32 dt) {
+	PROFILE_FUNCTION();
+	animation_clocks_update(dt);
+
+	array_range(map->overWorldCharacters, i) {
+		character_update(&map->overWorldCharacters[i], dt);
+
+		const Rectangle hitBox = map->overWorldCharacters[i].hitBox;
+		spatial_grid_move(&map->colliders.characterGrid, i, map->colliders.characterBounds[i], hitBox);
+		map->colliders.characterBounds[i] = hitBox;
 	}
+}
 
-	array_range(map->coastLineSpritesList, i) {
-		animated_tiled_sprite_update(&map->coastLineSpritesList[i], dt);
+void map_prepare_draw(Map *map) {
+	sort_characters(map);
+	bake_visible_terrain_chunks(map);
+}
+
+// insertion sort, the list is still sorted from the last frame except for the
+// few characters that walked past someone else, so this is close to a single
+// pass.
+static void sort_characters(Map *map) {
+	Character **characters = map->sortedCharacters;
+	for (i32 i = 1; i < array_length(characters); i++) {
+		Character *character = characters[i];
+		i32 j = i - 1;
+		while (j >= 0 && compare_entities(&characters[j]->animatedSprite.entity, &character->animatedSprite.entity) > 0) {
+			characters[j + 1] = characters[j];
+			j--;
+		}
+		characters[j + 1] = character;
 	}
+}
 
-	array_range(map->overWorldCharacters, i) {
-		character_update(&map->overWorldCharacters[i], dt);
+static void bake_visible_terrain_chunks(Map *map) {
+	if (!settings.bakeTerrainChunks || map->terrainChunks.chunks == nil) { return; }
+
+	const Rectangle camera = game.cameraBoundingBox;
+	const TerrainChunkCache *cache = &map->terrainChunks;
+	const i32 firstCol = max((i32)floorf(camera.x / TERRAIN_CHUNK_SIZE), 0);
+	const i32 firstRow = max((i32)floorf(camera.y / TERRAIN_CHUNK_SIZE), 0);
+	const i32 lastCol = min((i32)floorf((camera.x + camera.width) / TERRAIN_CHUNK_SIZE), cache->columns - 1);
+	const i32 lastRow = min((i32)floorf((camera.y + camera.height) / TERRAIN_CHUNK_SIZE), cache->rows - 1);
+
+	for (i32 row = firstRow; row <= lastRow; row++) {
+		for (i32 col = firstCol; col <= lastCol; col++) {
+			if (cache->chunks[(row * cache->columns) + col].id == 0) {
+				bake_terrain_chunk(map, col, row);
+			}
+		}
 	}
 }
 
 void map_draw(const Map *map) {
-	ClearBackground(int_to_color(map->tiledMap->backgroundcolor));
+	PROFILE_FUNCTION();
+	if (!platform_is_headless()) {
+		ClearBackground(map->backgroundColor);
+	}
 
-	// background sprites
-	array_range(map->backgroundSprites, i) {
-		draw_static_sprite(map->backgroundSprites[i]);
+	if (settings.bakeTerrainChunks && map->terrainChunks.chunks != nil) {
+		draw_terrain_chunks(map);
+	} else {
+		draw_tile_layer(&map->terrainLayer, DrawLayerTerrain);
+		draw_tile_layer(&map->terrainTopLayer, DrawLayerTerrainTop);
 	}
 
-	draw_animated_textures_sprites(map->waterSpritesList);
-	draw_animated_tiled_sprites(map->coastLineSpritesList);
+	// background sprites
+	draw_static_sprites(map->backgroundSprites, &map->spriteChunks.background, DrawLayerBackground);
 
-	// todo(hector) - the player and the other characters need to be in the same list as the main sprites...
-	array_range(map->overWorldCharacters, i) {
-		character_draw(&map->overWorldCharacters[i]);
+	if (water_shader_ready()) {
+		draw_water_regions(map);
+	} else {
+		draw_animated_textures_sprites(map->waterSpritesList, &map->spriteChunks.water);
 	}
+	draw_animated_tiled_sprites(map->coastLineSpritesList, &map->spriteChunks.coastLine);
 
-	// main sprites
-	bool playerDrawn = false;
-	array_range(map->mainSprites, i) {
-		const StaticSprite sprite = map->mainSprites[i];
-		// todo(hector) - no me gusta, but its a quick hack that doesnt require refactoring the whole map system.
-		if (!playerDrawn && sprite.entity.ySort > game.player.characterComponent.animatedSprite.entity.ySort) {
-			// player_draw(&game.player);
-			playerDrawn = true;
-		}
-		draw_static_sprite(sprite);
-	}
-	player_draw(&game.player);
+	draw_main_layer(map);
 
 	// foreground sprites
-	array_range(map->foregroundSprites, i) {
-		draw_static_sprite(map->foregroundSprites[i]);
-	}
+	draw_static_sprites(map->foregroundSprites, &map->spriteChunks.foreground, DrawLayerForeground);
 
 	if (game.isDebug) {
 		// draw collision boxes
 		array_range(map->collisionBoxes, i) {
-			DrawRectangleLinesEx(map->collisionBoxes[i], 5.f, BLUE);
+			draw_buffer_push_rectangle_lines(DrawLayerDebug, 0, map->collisionBoxes[i], 5.f, BLUE);
 		}
 		array_range(map->transitionBoxes, i) {
-			DrawRectangleLinesEx(map->transitionBoxes[i].box, 5.f, LIME);
+			draw_buffer_push_rectangle_lines(DrawLayerDebug, 0, map->transitionBoxes[i].box, 5.f, LIME);
 		}
 	}
 	array_range(map->transitionBoxes, i) {
-		DrawRectangleLinesEx(map->transitionBoxes[i].box, 5.f, LIME);
+		draw_buffer_push_rectangle_lines(DrawLayerOverlay, 0, map->transitionBoxes[i].box, 5.f, LIME);
 	}
+
+	// everything above only queued its draws, this sorts them into as few
+	// texture changes as the layers allow.
+	draw_buffer_flush();
 }
 
 static void draw_tile(
 	void *imageTexture2D,
+	const DrawLayer layer,
 	const Rectangle sourceRec,
 	const Vector2 destination,
 	const f32 opacity
 ) {
 	const u8 c = (u8)opacity * 255;
 	const Color tint = {c, c, c, c};
-	DrawTextureRec(*(Texture2D *)imageTexture2D, sourceRec, destination, tint);
+	draw_buffer_push_texture(layer, 0, *(Texture2D *)imageTexture2D, sourceRec, destination, tint);
 }
 
 static bool collidesWithCamera(const Rectangle rect) {
 	return CheckCollisionRecs(game.cameraBoundingBox, rect);
 }
 
-static void draw_static_sprite(const StaticSprite sprite) {
+static void draw_static_sprite(const StaticSprite sprite, const DrawLayer layer, const f32 depth) {
 	const Rectangle spriteBoundingBox = {
 		.x = sprite.entity.position.x,
 		.y = sprite.entity.position.y,
@@ -849,20 +2125,163 @@ static void draw_static_sprite(const StaticSprite sprite) {
 	}
 
 	game.gameMetrics.drawnSprites++;
-	DrawTextureRec(sprite.texture, sprite.sourceFrame, sprite.entity.position, WHITE);
+	game.gameMetrics.drawCalls++;
+	draw_buffer_push_texture(layer, depth, sprite.texture, sprite.sourceFrame, sprite.entity.position, WHITE);
 
 	// draw debug frames
 	if (!game.isDebug) { return; }
 
-	DrawRectangleLinesEx(spriteBoundingBox, 3.f, RED);
-	DrawCircleV(sprite.entity.position, 5.f, RED);
+	draw_buffer_push_rectangle_lines(DrawLayerDebug, 0, spriteBoundingBox, 3.f, RED);
+	draw_buffer_push_circle(DrawLayerDebug, 0, sprite.entity.position, 5.f, RED);
+}
+
+// the visible main sprites and the characters are both sorted already, so a
+// single merge of the two gives the draw order. The position in that order is
+// the depth the draw buffer sorts by, it only moves forward when the y-sort
+// does, that way things at the same height can still be batched by texture.
+static void draw_main_layer(const Map *map) {
+	const i32 *visibleMainSprites = query_visible_sprites(&map->spriteChunks.main);
+	Character *const *characters = map->sortedCharacters;
+	const i32 spritesLen = array_length(visibleMainSprites);
+	const i32 charactersLen = array_length(characters);
+
+	i32 spriteIndex = 0;
+	i32 characterIndex = 0;
+	f32 depth = 0;
+	f32 lastYSort = 0;
+	while (spriteIndex < spritesLen || characterIndex < charactersLen) {
+		const StaticSprite *sprite = spriteIndex < spritesLen ? &map->mainSprites[visibleMainSprites[spriteIndex]] : nil;
+		const Character *character = characterIndex < charactersLen ? characters[characterIndex] : nil;
+		const bool spriteFirst = character == nil ||
+								 (sprite != nil && compare_entities(&sprite->entity, &character->animatedSprite.entity) <= 0);
+
+		const f32 ySort = spriteFirst ? sprite->entity.ySort : character->animatedSprite.entity.ySort;
+		if (spriteIndex + characterIndex == 0 || ySort != lastYSort) {
+			depth++;
+			lastYSort = ySort;
+		}
+
+		if (spriteFirst) {
+			draw_static_sprite(*sprite, DrawLayerMain, depth);
+			spriteIndex++;
+		} else if (character->isPlayer) {
+			player_draw(&game.player, depth);
+			characterIndex++;
+		} else {
+			character_draw(character, depth);
+			characterIndex++;
+		}
+	}
+}
+
+static void draw_tile_layer(const TileLayer *layer, const DrawLayer drawLayer) {
+	const i32 tilesDrawn = draw_tile_layer_area(layer, drawLayer, game.cameraBoundingBox, (Vector2){}, game.isDebug);
+	game.gameMetrics.drawnSprites += tilesDrawn;
+	game.gameMetrics.drawCalls += tilesDrawn;
+}
+
+// walks straight over the rows and columns inside the area, every cell in
+// that range is on screen so there is nothing to cull. Offset moves the tiles,
+// used when baking chunks into their own texture, where debug frames would
+// get baked in too.
+static i32 draw_tile_layer_area(
+	const TileLayer *layer,
+	const DrawLayer drawLayer,
+	const Rectangle area,
+	const Vector2 offset,
+	const bool debugFrames
+) {
+	if (layer->gids == nil) { return 0; }
+
+	// the far edge is exclusive, a chunk should not pick the first row and
+	// column of its neighbours.
+	const i32 firstCol = max((i32)floorf(area.x / layer->tileWidth), 0);
+	const i32 firstRow = max((i32)floorf(area.y / layer->tileHeight), 0);
+	const i32 lastCol = min((i32)ceilf((area.x + area.width) / layer->tileWidth) - 1, layer->columns - 1);
+	const i32 lastRow = min((i32)ceilf((area.y + area.height) / layer->tileHeight) - 1, layer->rows - 1);
+
+	i32 tilesDrawn = 0;
+	for (i32 row = firstRow; row <= lastRow; row++) {
+		for (i32 col = firstCol; col <= lastCol; col++) {
+			const u16 gid = layer->gids[(row * layer->columns) + col];
+			if (gid == 0) { continue; }
+
+			const TileLayerTile tile = layer->tiles[gid];
+			const Vector2 position = {
+				.x = ((f32)col * layer->tileWidth) + offset.x,
+				.y = ((f32)row * layer->tileHeight) + offset.y,
+			};
+			tilesDrawn++;
+			draw_buffer_push_texture(drawLayer, 0, tile.texture, tile.sourceFrame, position, WHITE);
+
+			// draw debug frames
+			if (!debugFrames) { continue; }
+
+			draw_buffer_push_rectangle_lines(DrawLayerDebug, 0, rectangle_at(tile.sourceFrame, position), 3.f, RED);
+			draw_buffer_push_circle(DrawLayerDebug, 0, position, 5.f, RED);
+		}
+	}
+	return tilesDrawn;
+}
+
+static void draw_terrain_chunks(const Map *map) {
+	const TerrainChunkCache *cache = &map->terrainChunks;
+	for (i32 row = 0; row < cache->rows; row++) {
+		for (i32 col = 0; col < cache->columns; col++) {
+			const Rectangle rect = terrain_chunk_rect(map, col, row);
+			if (!collidesWithCamera(rect)) { continue; }
+
+			const i32 chunkIndex = (row * cache->columns) + col;
+			const RenderTexture2D chunk = cache->chunks[chunkIndex];
+			if (chunk.id == 0) {
+				// not baked yet, map_prepare_draw did not run for this camera.
+				const i32 tilesDrawn = draw_tile_layer_area(&map->terrainLayer, DrawLayerTerrain, rect, (Vector2){}, game.isDebug) +
+									   draw_tile_layer_area(&map->terrainTopLayer, DrawLayerTerrainTop, rect, (Vector2){}, game.isDebug);
+				game.gameMetrics.drawnSprites += tilesDrawn;
+				game.gameMetrics.drawCalls += tilesDrawn;
+				continue;
+			}
+
+			// render textures are upside down, flip them back with a negative height.
+			const Rectangle source = {
+				.width = (f32)chunk.texture.width,
+				.height = -(f32)chunk.texture.height,
+			};
+			game.gameMetrics.drawnSprites += cache->chunkTiles[chunkIndex];
+			game.gameMetrics.drawCalls++;
+			draw_buffer_push_texture(DrawLayerTerrain, 0, chunk.texture, source, rectangle_location(rect), WHITE);
+
+			if (!game.isDebug) { continue; }
+
+			draw_buffer_push_rectangle_lines(DrawLayerDebug, 0, rect, 5.f, ORANGE);
+		}
+	}
 }
 
-static void draw_animated_tiled_sprites(AnimatedTiledSprite *coastLineSprites) {
+// the indices come back sorted, so they keep the y-sort order of the list
+// the chunks were built from.
+static const i32 *query_visible_sprites(const SpatialGrid *chunks) {
+	array_clear(visibleSprites);
+	game.gameMetrics.visitedChunks += spatial_grid_query(chunks, game.cameraBoundingBox, &visibleSprites);
+	return visibleSprites;
+}
+
+static void draw_static_sprites(const StaticSprite *sprites, const SpatialGrid *chunks, const DrawLayer layer) {
+	if (array_length(sprites) == 0) { return; }
+
+	const i32 *visible = query_visible_sprites(chunks);
+	array_range(visible, i) {
+		const StaticSprite sprite = sprites[visible[i]];
+		draw_static_sprite(sprite, layer, sprite.entity.ySort);
+	}
+}
+
+static void draw_animated_tiled_sprites(AnimatedTiledSprite *coastLineSprites, const SpatialGrid *chunks) {
 	if (array_length(coastLineSprites) == 0) { return; }
 
-	array_range(coastLineSprites, i) {
-		const AnimatedTiledSprite coastSprite = coastLineSprites[i];
+	const i32 *visible = query_visible_sprites(chunks);
+	array_range(visible, i) {
+		const AnimatedTiledSprite coastSprite = coastLineSprites[visible[i]];
 		const Rectangle coastSpriteBoundingBox = {
 			.x = coastSprite.entity.position.x,
 			.y = coastSprite.entity.position.y,
@@ -875,22 +2294,24 @@ static void draw_animated_tiled_sprites(AnimatedTiledSprite *coastLineSprites) {
 		}
 
 		game.gameMetrics.drawnSprites++;
-		const Rectangle tileToDraw = coastSprite.sourceFrames[coastSprite.currentFrame];
-		draw_tile(&assets.tileMaps.coastLine.texture, tileToDraw, coastSprite.entity.position, 1.f);
+		game.gameMetrics.drawCalls++;
+		const Rectangle tileToDraw = animated_tiled_sprite_current_frame(&coastSprite);
+		draw_tile(&assets.tileMaps.coastLine.texture, DrawLayerCoastLine, tileToDraw, coastSprite.entity.position, 1.f);
 
 		// draw debug frames
 		if (!game.isDebug) { continue; }
 
-		DrawRectangleLinesEx(coastSpriteBoundingBox, 3.f, RED);
-		DrawCircleV(coastSprite.entity.position, 5.f, RED);
+		draw_buffer_push_rectangle_lines(DrawLayerDebug, 0, coastSpriteBoundingBox, 3.f, RED);
+		draw_buffer_push_circle(DrawLayerDebug, 0, coastSprite.entity.position, 5.f, RED);
 	}
 }
 
-static void draw_animated_textures_sprites(AnimatedTexturesSprite *waterSprites) {
+static void draw_animated_textures_sprites(AnimatedTexturesSprite *waterSprites, const SpatialGrid *chunks) {
 	if (array_length(waterSprites) == 0) { return; }
 
-	for (i32 i = 0; i < array_length(waterSprites); i++) {
-		const AnimatedTexturesSprite waterSprite = waterSprites[i];
+	const i32 *visible = query_visible_sprites(chunks);
+	array_range(visible, i) {
+		const AnimatedTexturesSprite waterSprite = waterSprites[visible[i]];
 		const Rectangle sourceRec = {
 			.x = waterSprite.entity.position.x,
 			.y = waterSprite.entity.position.y,
@@ -902,41 +2323,98 @@ static void draw_animated_textures_sprites(AnimatedTexturesSprite *waterSprites)
 		}
 
 		game.gameMetrics.drawnSprites++;
-		Texture2D *frameToDraw = &waterSprite.textures[waterSprite.currentFrame];
-		draw_tile(frameToDraw, sourceRec, waterSprite.entity.position, 1.f);
+		game.gameMetrics.drawCalls++;
+		Texture2D *frameToDraw = animated_textures_sprite_current_frame(&waterSprite);
+		draw_tile(frameToDraw, DrawLayerWater, sourceRec, waterSprite.entity.position, 1.f);
 
 		// draw debug frames
 		if (!game.isDebug) { continue; }
 
-		DrawRectangleLinesEx(sourceRec, 3.f, RED);
-		DrawCircleV(waterSprite.entity.position, 5.f, RED);
+		draw_buffer_push_rectangle_lines(DrawLayerDebug, 0, sourceRec, 3.f, RED);
+		draw_buffer_push_circle(DrawLayerDebug, 0, waterSprite.entity.position, 5.f, RED);
+	}
+}
+
+// LoadShader falls back to the default shader when the water one fails to
+// compile, the water is then drawn a tile at a time.
+static bool water_shader_ready() {
+	return !platform_is_headless() && assets.shaders.water.id != rlGetShaderIdDefault();
+}
+
+// every visible Water object is one quad, the shader repeats the current frame
+// over it, so the layer is a single draw call however much water is on screen.
+static void draw_water_regions(const Map *map) {
+	if (array_length(map->waterRegions) == 0) { return; }
+
+	const Texture2D strip = assets.waterTextures.strip;
+	const f32 framesLen = (f32)assets.waterTextures.len;
+	const f32 frame = (f32)animation_clock_frame(map->waterSpritesList[0].clock);
+	SetShaderValue(assets.shaders.water, assets.shaders.waterFrameLoc, &frame, SHADER_UNIFORM_FLOAT);
+	SetShaderValue(assets.shaders.water, assets.shaders.waterFramesLenLoc, &framesLen, SHADER_UNIFORM_FLOAT);
+
+	const f32 tileWidth = (f32)strip.width / framesLen;
+	const f32 tileHeight = (f32)strip.height;
+	array_range(map->waterRegions, i) {
+		const Rectangle region = map->waterRegions[i];
+		if (!collidesWithCamera(region)) {
+			continue;
+		}
+
+		// only the part on screen. DrawTexturePro divides the source by the
+		// texture size, so a source as big as the strip for every tile gives
+		// texture coordinates counted in tiles from the region origin.
+		const Rectangle visible = GetCollisionRec(region, game.cameraBoundingBox);
+		const Rectangle source = {
+			.x = (visible.x - region.x) / tileWidth * (f32)strip.width,
+			.y = (visible.y - region.y) / tileHeight * (f32)strip.height,
+			.width = visible.width / tileWidth * (f32)strip.width,
+			.height = visible.height / tileHeight * (f32)strip.height,
+		};
+
+		game.gameMetrics.drawnSprites++;
+		game.gameMetrics.drawCalls++;
+		draw_buffer_push_shaded_texture(DrawLayerWater, 0, assets.shaders.water, strip, source, visible, WHITE);
+
+		// draw debug frames
+		if (!game.isDebug) { continue; }
+
+		draw_buffer_push_rectangle_lines(DrawLayerDebug, 0, region, 3.f, RED);
 	}
 }
 
 static void *texture_loader_callback(const char *path) {
-	Texture2D *text = mallocate(sizeof(*text), MemoryTagTexture);
-	*text = LoadTexture(path);
+	Texture2D *text = arena_alloc(loading_arena(), sizeof(*text));
+	*text = load_map_texture(path);
 	slogi("loaded %s with ID %d", path, text->id);
+	if ((text->id & PLACEHOLDER_TEXTURE_BIT) != 0) {
+		deferredTextures[array_length(deferredTextures) - 1].target = text;
+	}
 	return text;
 }
 
-static void texture_free_callback(void *ptr) {
-	const Texture2D *text = (Texture2D *)ptr;
-	slogi("unloading texture #%d", text->id);
-	UnloadTexture(*text);
-	mfree(ptr, sizeof(*text), MemoryTagTexture);
-}
-
 static u64 totalMapMemoryAllocated = 0;
 
+// libtmx, and the libxml2 parser under it, allocate through these. During a
+// map load the nodes go into the map arena, the parser scratch memory too,
+// but that one is small next to the map and is gone before tmx_load returns.
+// libxml2's globals are set up by maps_manager_init, outside any arena.
 void *map_alloc_callback(void *ptr, const size_t len) {
-	// TODO - what to do .-.
-	totalMapMemoryAllocated += len;
-	// slogi("allocating %d bytes for map, total: %d", len, totalMapMemoryAllocated);
-	return realloc(ptr, len);
+	__atomic_fetch_add(&totalMapMemoryAllocated, len, __ATOMIC_RELAXED);
+	if (loadingArena == nil || (ptr != nil && !arena_owns(loadingArena, ptr))) {
+		return realloc(ptr, len);
+	}
+
+	byte *block = ptr != nil ? (byte *)ptr - TMX_BLOCK_HEADER_SIZE : nil;
+	const u64 oldSize = block != nil ? *(u64 *)block : 0;
+	block = arena_realloc(loadingArena, block, oldSize + TMX_BLOCK_HEADER_SIZE, len + TMX_BLOCK_HEADER_SIZE);
+	*(u64 *)block = len;
+	return block + TMX_BLOCK_HEADER_SIZE;
 }
 
 void map_free_callback(void *ptr) {
+	// arena blocks go with the arena.
+	if (loadingArena != nil && arena_owns(loadingArena, ptr)) { return; }
+
 	free(ptr);
 }
 
@@ -10,6 +10,12 @@
 #include "tmx.h"
 #include "sprites.h"
 #include "character_entity.h"
+#include "spatial_grid.h"
+#include "occupancy_grid.h"
+#include "biome_grid.h"
+#include "encounter_table.h"
+#include "memory/arena.h"
+#include "texture_cache.h"
 
 typedef enum MapID {
     MapIDWorld = 0,
@@ -40,13 +46,95 @@ typedef struct TransitionSprite {
     char destinationPos[MAX_TRANSITION_DEST_LEN];
 } TransitionSprite;
 
+// Terrain layers are full grids of tiles that never move, so instead of a
+// sprite per cell they keep the tile GID of each cell plus a lookup table with
+// what to draw for each GID.
+typedef struct TileLayerTile {
+    Texture2D texture;
+    Rectangle sourceFrame;
+} TileLayerTile;
+
+typedef struct TileLayer {
+    i32 columns;
+    i32 rows;
+    f32 tileWidth;
+    f32 tileHeight;
+    u16 *gids;            // columns * rows, 0 means the cell is empty
+    TileLayerTile *tiles; // indexed by GID, tilesLen entries
+    i32 tilesLen;
+    i32 usedCells;
+} TileLayer;
+
+// Terrain never changes after load, so it can be rasterised once into big
+// render textures and drawn as a handful of quads. Chunks are baked lazily, the
+// first time the camera sees them, and released with the map.
+#define TERRAIN_CHUNK_SIZE 1024
+
+typedef struct TerrainChunkCache {
+    i32 columns;
+    i32 rows;
+    RenderTexture2D *chunks; // columns * rows, id 0 until baked
+    i32 *chunkTiles;         // non-empty terrain cells inside each chunk
+    i32 bakedChunks;
+} TerrainChunkCache;
+
+#define MAX_CHARACTER_GRAPHIC_LEN 32
+
+// where and how an npc starts on the map, the characters themselves are built
+// from these every time the map loads.
+typedef struct CharacterSpawn {
+    char id[MAX_CHARACTER_ID_LENGTH];
+    char graphic[MAX_CHARACTER_GRAPHIC_LEN];
+    CharacterDirection direction;
+    f32 radius; // 0 keeps the default
+    Vector2 center;
+} CharacterSpawn;
+
+// a texture decoded off the main thread, waiting to be uploaded to the GPU.
+typedef struct PendingTexture {
+    Image image;
+    char path[MAX_TEXTURE_PATH_LEN]; // where it goes in the texture cache
+    Texture2D *target; // the texture handed to libtmx, nil for compiled maps
+} PendingTexture;
+
 typedef struct Map {
     MapID id;
-    tmx_map *tiledMap;
+    // set once the map has been the current one, its npcs may have moved since
+    // they spawned.
+    bool wasShown;
+    // everything that lives exactly as long as the map goes in here, the map
+    // itself, libtmx's nodes, tile layers, sprite lists and chunks, so freeing
+    // the map is freeing the arena. The npcs are rebuilt on every visit and
+    // stay out of it.
+    Arena arena;
+    tmx_map *tiledMap; // in the arena, nil when the map came from a compiled file
+    // textures the map loaded itself, shared assets not included.
+    Texture2D *textures;
+    Color backgroundColor;
+    f32 width;
+    f32 height;
+    i64 totalSprites;
+    usize textureBytes; // loaded by this map, shared assets not included
+    // textures of a map loaded with load_map_deferred, every texture in the
+    // map is a placeholder until map_upload_textures gets through them.
+    PendingTexture *pendingTextures;
+    Texture2D *uploadedTextures;
 
     AnimatedTexturesSprite *waterSpritesList;
+    // the tiles of every Water layer object merged back into one rectangle,
+    // drawn as a single quad when the water shader is available.
+    Rectangle *waterRegions;
     AnimatedTiledSprite *coastLineSpritesList;
+    CharacterSpawn *characterSpawns;
     Character *overWorldCharacters;
+    // the npcs above plus the player, in draw order. Only a handful of them
+    // move each frame, so map_prepare_draw keeps it sorted with an insertion
+    // sort instead of sorting from scratch.
+    Character **sortedCharacters;
+
+    TileLayer terrainLayer;
+    TileLayer terrainTopLayer;
+    TerrainChunkCache terrainChunks;
 
     StaticSprite *backgroundSprites;
     StaticSprite *mainSprites;
@@ -55,16 +143,93 @@ typedef struct Map {
     Rectangle *collisionBoxes;
     TransitionSprite *transitionBoxes;
 
+    // chunked index over the sprite lists above, built once the lists are
+    // sorted so drawing only walks what is around the camera.
+    struct {
+        SpatialGrid water;
+        SpatialGrid coastLine;
+        SpatialGrid background;
+        SpatialGrid main;
+        SpatialGrid foreground;
+    } spriteChunks;
+
+    // what characters bump into. The collision boxes and the hit boxes of
+    // collideable objects never move, so they are bucketed once on load. The
+    // npcs get a grid of their own that follows them as they walk.
+    struct {
+        Rectangle *staticBoxes;
+        SpatialGrid staticGrid;
+        SpatialGrid characterGrid;
+        Rectangle *characterBounds; // the hit box each npc was last bucketed with
+        // the collision boxes at tile resolution, for line of sight.
+        OccupancyGrid occupancy;
+    } colliders;
+
+    // the objects of the Monsters layer, with the species each one lists.
+    EncounterPatch *encounterPatches;
+    // the Monsters layer by tile, where wild encounters can happen.
+    BiomeGrid biomes;
+    // what shows up in each biome, built from the game data on load, for the
+    // patches that don't list their own species.
+    EncounterTable encounters[BiomeCount];
+    // one table for every different list of species the patches have, the
+    // biome grid says which one each tile rolls from.
+    EncounterTable *patchEncounters;
+
     Vector2 playerStartingPosition;
 } Map;
 
 
 void maps_manager_init();
+// loads the compiled version of the map when there is an up to date one,
+// otherwise parses the .tmx.
 Map *load_map(MapID mapID);
+// same as load_map, but it never touches the GPU so it can run on a worker
+// thread. Images are decoded there and the map can't be drawn until
+// map_upload_textures returns true on the main thread.
+Map *load_map_deferred(MapID mapID);
+// uploads the pending textures of a deferred map for up to budgetSecs (at least
+// one per call), returns true once every texture is on the GPU.
+bool map_upload_textures(Map *map, f64 budgetSecs);
+// rough size of everything the map holds on to, cpu and gpu.
+usize map_memory_size(const Map *map);
+// puts every npc back where the map spawns them, for maps that stay loaded
+// between visits.
+void map_reset_characters(Map *map);
+// starts the patrol timers of the npcs on the game clock. Maps can be built on
+// the loader thread, which must not read that clock while the main thread
+// moves it, so this is called on the main thread when the map becomes current.
+void map_start_patrols(Map *map);
+// writes a compiled file next to every .tmx, returns false if any failed.
+bool maps_manager_compile_all();
+// prints how long it takes to load every map from its .tmx and its compiled file.
+void maps_manager_bench_load(i32 iterations);
+// times both line of sight tests from npcs scattered over the world map, and
+// prints how often they disagree.
+void maps_manager_bench_line_of_sight(i32 npcs);
 void map_free(Map *map);
 MapID map_id_for_name(const char *name);
 
-void map_update(const Map *map, f32 dt);
+void map_update(Map *map, f32 dt);
+// true if the hit box overlaps a collision box, a collideable object or an npc.
+// Only what the collision grids have around the box gets tested.
+bool map_collides(const Map *map, Rectangle hitBox);
+// true if no collision box is between the two points, walked over the occupancy
+// grid a tile at a time.
+bool map_line_of_sight(const Map *map, Vector2 from, Vector2 to);
+// the same question tested exactly against every collision box, slow, kept to
+// check the grid against.
+bool map_line_of_sight_exact(const Map *map, Vector2 from, Vector2 to);
+/**
+ * The biome of the encounter tiles under the area, BiomeNone off the Monsters layer.
+ * @param outEncounters the table wild monsters on that tile roll from, the
+ * patch's own when it lists species, nil off the Monsters layer
+ */
+Biome map_biome_under(const Map *map, Rectangle area, const EncounterTable **outEncounters);
+// runs anything that renders into textures, must be called before BeginMode2D
+// since texture mode resets the camera transform. Also re-sorts the characters
+// after they moved during the update.
+void map_prepare_draw(Map *map);
 void map_draw(const Map *map);
 
 #endif //RAYLIB_POKEMON_CLONE_MAPS_MANAGER_H
@@ -0,0 +1,160 @@
+//
+// Created by Hector Mejia on 10/17/26.
+//
+
+#include "arena.h"
+
+#define ARENA_ALIGNMENT 16
+
+struct ArenaChunk {
+    ArenaChunk *next;
+    u64 capacity;
+    u64 used;
+    u64 lastBlock; // offset of the last allocation, so it can grow in place
+    _Alignas(ARENA_ALIGNMENT) byte data[];
+};
+
+static u64 align_up(u64 value);
+static ArenaChunk *push_chunk(Arena *arena);
+static ArenaChunk *push_oversized_chunk(Arena *arena, u64 size);
+static ArenaChunk *new_chunk(Arena *arena, u64 capacity);
+static void free_chunk(const Arena *arena, ArenaChunk *chunk);
+
+Arena arena_new(const char *name, const u64 chunkSize, const memory_tag tag) {
+    panicIf(chunkSize == 0, "arena chunk size must be positive");
+
+    Arena arena = {
+        .tag = tag,
+        .chunkSize = chunkSize,
+    };
+    strncpy(arena.name, name, sizeof(arena.name) - 1);
+    return arena;
+}
+
+void *arena_alloc(Arena *arena, const u64 size) {
+    const u64 alignedSize = align_up(size);
+    ArenaChunk *chunk = arena->chunks;
+    if (alignedSize > arena->chunkSize) {
+        chunk = push_oversized_chunk(arena, alignedSize);
+    } else if (chunk == nil || chunk->used + alignedSize > chunk->capacity) {
+        chunk = push_chunk(arena);
+    }
+
+    void *block = chunk->data + chunk->used;
+    chunk->lastBlock = chunk->used;
+    chunk->used += alignedSize;
+    arena->used += alignedSize;
+    arena->highWater = max(arena->highWater, arena->used);
+    // chunks come zeroed from mallocate, but reset ones are reused.
+    return mzero_memory(block, alignedSize);
+}
+
+void *arena_realloc(Arena *arena, void *block, const u64 oldSize, const u64 newSize) {
+    if (block == nil) {
+        return arena_alloc(arena, newSize);
+    }
+
+    ArenaChunk *chunk = arena->chunks;
+    const u64 oldAligned = align_up(oldSize);
+    const u64 newAligned = align_up(newSize);
+    const bool isLast = chunk != nil && (byte *)block == chunk->data + chunk->lastBlock;
+    if (isLast && chunk->lastBlock + newAligned <= chunk->capacity) {
+        if (newAligned > oldAligned) {
+            mzero_memory(chunk->data + chunk->lastBlock + oldAligned, newAligned - oldAligned);
+        }
+        chunk->used = chunk->lastBlock + newAligned;
+        arena->used = arena->used - oldAligned + newAligned;
+        arena->highWater = max(arena->highWater, arena->used);
+        return block;
+    }
+
+    void *newBlock = arena_alloc(arena, newSize);
+    mcopy_memory(newBlock, block, min(oldSize, newSize));
+    return newBlock;
+}
+
+bool arena_owns(const Arena *arena, const void *block) {
+    for (const ArenaChunk *chunk = arena->chunks; chunk != nil; chunk = chunk->next) {
+        if ((const byte *)block >= chunk->data && (const byte *)block < chunk->data + chunk->capacity) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void arena_reset(Arena *arena) {
+    // keep one chunk sized for regular use, if there is one, the oversized
+    // ones were for allocations that may not come again.
+    ArenaChunk *keep = nil;
+    ArenaChunk *chunk = arena->chunks;
+    while (chunk != nil) {
+        ArenaChunk *next = chunk->next;
+        if (keep == nil && chunk->capacity == arena->chunkSize) {
+            keep = chunk;
+        } else {
+            arena->capacity -= chunk->capacity;
+            free_chunk(arena, chunk);
+        }
+        chunk = next;
+    }
+    if (keep != nil) {
+        keep->next = nil;
+        keep->used = 0;
+        keep->lastBlock = 0;
+    }
+    arena->chunks = keep;
+    arena->used = 0;
+}
+
+void arena_free(Arena *arena) {
+    ArenaChunk *chunk = arena->chunks;
+    while (chunk != nil) {
+        ArenaChunk *next = chunk->next;
+        free_chunk(arena, chunk);
+        chunk = next;
+    }
+    arena->chunks = nil;
+    arena->capacity = 0;
+    arena->used = 0;
+}
+
+static u64 align_up(const u64 value) {
+    return (value + ARENA_ALIGNMENT - 1) & ~(u64)(ARENA_ALIGNMENT - 1);
+}
+
+// whatever room is left in the old head is given up, it is less than the
+// allocation that didn't fit, which is at most chunkSize.
+static ArenaChunk *push_chunk(Arena *arena) {
+    ArenaChunk *chunk = new_chunk(arena, arena->chunkSize);
+    chunk->next = arena->chunks;
+    arena->chunks = chunk;
+    return chunk;
+}
+
+// an allocation bigger than chunkSize gets a chunk of its own, it goes behind
+// the head so the head keeps serving the regular ones with the room it has
+// left.
+static ArenaChunk *push_oversized_chunk(Arena *arena, const u64 size) {
+    ArenaChunk *chunk = new_chunk(arena, size);
+    ArenaChunk *head = arena->chunks;
+    if (head == nil) {
+        arena->chunks = chunk;
+    } else {
+        chunk->next = head->next;
+        head->next = chunk;
+    }
+    return chunk;
+}
+
+static ArenaChunk *new_chunk(Arena *arena, const u64 capacity) {
+    ArenaChunk *chunk = mallocate(sizeof(*chunk) + capacity, arena->tag);
+    panicIfNil(chunk, "failed to alloc a %llu bytes chunk for arena %s", capacity, arena->name);
+
+    chunk->capacity = capacity;
+    arena->capacity += capacity;
+    return chunk;
+}
+
+static void free_chunk(const Arena *arena, ArenaChunk *chunk) {
+    mfree(chunk, sizeof(*chunk) + chunk->capacity, arena->tag);
+}
@@ -0,0 +1,53 @@
+//
+// Created by Hector Mejia on 10/17/26.
+//
+
+#ifndef RAYLIB_POKEMON_CLONE_ARENA_H
+#define RAYLIB_POKEMON_CLONE_ARENA_H
+
+#include "memory.h"
+
+#define MAX_ARENA_NAME_LEN 32
+
+typedef struct ArenaChunk ArenaChunk;
+
+// Linear allocator for things that all die at the same time. Allocations are
+// bumped out of chunks of chunkSize bytes (bigger ones get a chunk of their
+// own, kept behind the head), nothing is freed on its own, the whole arena
+// goes at once.
+typedef struct Arena {
+    char name[MAX_ARENA_NAME_LEN];
+    memory_tag tag;
+    u64 chunkSize;
+    ArenaChunk *chunks; // allocations come out of the head, the newest regular chunk
+    u64 capacity;
+    u64 used;
+    u64 highWater;
+} Arena;
+
+// no memory is taken until the first allocation.
+Arena arena_new(const char *name, u64 chunkSize, memory_tag tag);
+
+/**
+ * Returns zeroed memory, aligned for any type, that lives until the arena is
+ * reset or freed.
+ */
+void *arena_alloc(Arena *arena, u64 size);
+
+/**
+ * Grows or shrinks a block. The last block allocated is resized in place when
+ * the chunk has room, anything else is copied into a new block and the old one
+ * is left where it was until the arena goes.
+ * @param block a block from this arena, or nil to allocate a new one
+ * @param oldSize the size the block was allocated with
+ * @param newSize the size it needs now
+ */
+void *arena_realloc(Arena *arena, void *block, u64 oldSize, u64 newSize);
+
+bool arena_owns(const Arena *arena, const void *block);
+
+// keeps one chunkSize chunk around for reuse, frees the rest.
+void arena_reset(Arena *arena);
+void arena_free(Arena *arena);
+
+#endif //RAYLIB_POKEMON_CLONE_ARENA_H
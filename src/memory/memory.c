@@ -4,10 +4,17 @@
 
 #include "memory.h"
 
+#include <pthread.h>
+
+#include "arena.h"
+
+#define MAX_TRACKED_ARENAS 32
+
 static void get_memory_unit_for_size(char buf[], u64 size);
 static char get_memory_unit_for_size1(u64 size);
 static f32 normalize_memory_size(u64 size);
 static void print_memory_action(char action[], memory_tag tag, u64 size);
+static struct arena_stats *find_arena_stats(const char *name);
 
 // todo(hector) - get a call stack going
 struct memory_stats {
@@ -33,12 +40,30 @@ static const char *memory_tag_strings[MemoryTagMaxTags] = {
     "JSON       ",
 };
 
+// maps load on a worker thread, so the counters can be touched from more than
+// one thread at a time.
+#define stat_add(field, value) __atomic_fetch_add(&(field), (value), __ATOMIC_RELAXED)
+#define stat_sub(field, value) __atomic_fetch_sub(&(field), (value), __ATOMIC_RELAXED)
+
+struct arena_stats {
+    char name[MAX_ARENA_NAME_LEN];
+    const Arena *arena; // nil once untracked
+    u64 capacity;
+    u64 used;
+    u64 highWater;
+};
+
 typedef struct memory_system_state {
     struct memory_stats stats;
+    struct arena_stats arenas[MAX_TRACKED_ARENAS];
+    u32 arenasLen;
+    pthread_mutex_t arenasLock;
 } memory_system_state;
 
 // Pointer to system state.
-static memory_system_state state = {};
+static memory_system_state state = {
+    .arenasLock = PTHREAD_MUTEX_INITIALIZER,
+};
 
 void initialize_memory() {
 }
@@ -51,10 +76,10 @@ void *mallocate(const u64 size, const memory_tag tag) {
         slogw("mallocate called using %s. Re-class this allocation.", memory_tag_strings[tag]);
     }
 
-    state.stats.totalAllocated += size;
-    state.stats.currentlyAllocated += size;
-    state.stats.totalAllocations++;
-    state.stats.taggedAllocations[tag] += size;
+    stat_add(state.stats.totalAllocated, size);
+    stat_add(state.stats.currentlyAllocated, size);
+    stat_add(state.stats.totalAllocations, 1);
+    stat_add(state.stats.taggedAllocations[tag], size);
 
     // TODO: Memory alignment?
     // void *block = malloc(size);
@@ -70,15 +95,56 @@ void mfree(void *block, const u64 size, const memory_tag tag) {
         slogw("mfree called using %s. Re-class this allocation.", memory_tag_strings[tag]);
     }
 
-    state.stats.currentlyAllocated -= size;
-    state.stats.taggedAllocations[tag] -= size;
-    state.stats.totalFrees++;
+    stat_sub(state.stats.currentlyAllocated, size);
+    stat_sub(state.stats.taggedAllocations[tag], size);
+    stat_add(state.stats.totalFrees, 1);
 
     print_memory_action("mfree", tag, size);
     // TODO: Memory alignment
     free(block);
 }
 
+void memory_track_arena(const Arena *arena) {
+    pthread_mutex_lock(&state.arenasLock);
+    struct arena_stats *stats = find_arena_stats(arena->name);
+    if (stats != nil) {
+        stats->arena = arena;
+    } else {
+        slogw("too many arenas to track, ignoring %s", arena->name);
+    }
+    pthread_mutex_unlock(&state.arenasLock);
+}
+
+void memory_untrack_arena(const Arena *arena) {
+    pthread_mutex_lock(&state.arenasLock);
+    for (u32 i = 0; i < state.arenasLen; i++) {
+        struct arena_stats *stats = &state.arenas[i];
+        if (stats->arena != arena) { continue; }
+
+        stats->capacity = arena->capacity;
+        stats->used = arena->used;
+        stats->highWater = max(stats->highWater, arena->highWater);
+        stats->arena = nil;
+        break;
+    }
+    pthread_mutex_unlock(&state.arenasLock);
+}
+
+// arenas are tracked by name, so a map that gets loaded again keeps its row
+// (and its high-water mark).
+static struct arena_stats *find_arena_stats(const char *name) {
+    for (u32 i = 0; i < state.arenasLen; i++) {
+        if (streq(state.arenas[i].name, name)) {
+            return &state.arenas[i];
+        }
+    }
+    if (state.arenasLen == MAX_TRACKED_ARENAS) { return nil; }
+
+    struct arena_stats *stats = &state.arenas[state.arenasLen++];
+    strncpy(stats->name, name, sizeof(stats->name) - 1);
+    return stats;
+}
+
 void *mzero_memory(void *block, const u64 size) {
     return memset(block, 0, size);
 }
@@ -142,6 +208,34 @@ char *get_memory_usage_str() {
         state.stats.totalFrees
     );
 
+    offset += strlen(buffer + offset);
+    pthread_mutex_lock(&state.arenasLock);
+    if (state.arenasLen > 0) {
+        offset += snprintf(buffer + offset, bufferSize - offset, "Arenas (used/capacity, high water):\n");
+    }
+    for (u32 i = 0; i < state.arenasLen && offset < bufferSize; i++) {
+        struct arena_stats stats = state.arenas[i];
+        if (stats.arena != nil) {
+            stats.capacity = stats.arena->capacity;
+            stats.used = stats.arena->used;
+            stats.highWater = max(stats.highWater, stats.arena->highWater);
+        }
+        offset += snprintf(
+            buffer + offset,
+            bufferSize - offset,
+            "\t%-11s: %.2f%c/%.2f%c, %.2f%c%s\n",
+            stats.name,
+            normalize_memory_size(stats.used),
+            get_memory_unit_for_size1(stats.used),
+            normalize_memory_size(stats.capacity),
+            get_memory_unit_for_size1(stats.capacity),
+            normalize_memory_size(stats.highWater),
+            get_memory_unit_for_size1(stats.highWater),
+            stats.arena == nil ? " (freed)" : ""
+        );
+    }
+    pthread_mutex_unlock(&state.arenasLock);
+
     // char *out_string = strdup(buffer);
     // return out_string;
     return strdup(buffer);
@@ -31,6 +31,8 @@ typedef enum memory_tag {
 #define MiB  (1024 * 1024)
 #define KiB  (1024)
 
+typedef struct Arena Arena;
+
 void initialize_memory();
 void shutdown_memory();
 
@@ -41,4 +43,9 @@ void *mcopy_memory(void *dest, const void *source, u64 size);
 void *mset_memory(void *dest, i32 value, u64 size);
 char *get_memory_usage_str();
 
+// arenas show up in the memory usage report while tracked, once untracked the
+// last numbers they had are kept under their name.
+void memory_track_arena(const Arena *arena);
+void memory_untrack_arena(const Arena *arena);
+
 #endif //RAYLIB_POKEMON_CLONE_MEMORY_H
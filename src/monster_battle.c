@@ -3,10 +3,14 @@
 #include "monster_battle.h"
 #include "game.h"
 #include "settings.h"
+#include "input.h"
 #include "colors.h"
 #include "ui.h"
 #include "raylib_extras.h"
 #include "game_data.h"
+#include "gpu_stats.h"
+#include "profiler.h"
+#include "rng.h"
 
 #include <raymath.h>
 
@@ -303,17 +307,17 @@ void monster_battle_input() {
 		panic("invalid selection mode %d", state.uiBattleChoiceState.uiSelectionMode);
 	}
 
-	if (IsKeyPressed(KEY_DOWN)) {
+	if (input_key_pressed(KEY_DOWN)) {
 		state.uiBattleChoiceState.indexes[selectedMode] = (state.uiBattleChoiceState.indexes[selectedMode] + 1) %
 														  maxIndex;
 	}
-	if (IsKeyPressed(KEY_UP)) {
+	if (input_key_pressed(KEY_UP)) {
 		state.uiBattleChoiceState.indexes[selectedMode] -= 1;
 		if (state.uiBattleChoiceState.indexes[selectedMode] < 0) {
 			state.uiBattleChoiceState.indexes[selectedMode] = maxIndex - 1;
 		}
 	}
-	if (IsKeyPressed(KEY_SPACE)) {
+	if (input_key_pressed(KEY_SPACE)) {
 		if (selectedMode == SelectionModeTarget) {
 			Monster **targetMonsters = state.selectedSelectionSide == SelectionSideOpponent ?
 				state.opponentActiveMonsters : state.playerActiveMonsters;
@@ -454,7 +458,7 @@ void monster_battle_input() {
 		state.uiBattleChoiceState.indexes[SelectionModeSwitch] = 0;
 		state.uiBattleChoiceState.indexes[SelectionModeTarget] = 0;
 	}
-	if (IsKeyPressed(KEY_ESCAPE)) {
+	if (input_key_pressed(KEY_ESCAPE)) {
 		if (selectedMode == SelectionModeSwitch ||
 			selectedMode == SelectionModeAttack ||
 			selectedMode == SelectionModeTarget) {
@@ -683,7 +687,7 @@ static void opponent_monster_update(Monster *monster, AnimatedTiledSprite *sprit
 			availableAbilitiesLen++;
 		}
 
-		i32 randomAttack = rand() % availableAbilitiesLen;
+		i32 randomAttack = rng_range(rng_game(), 0, availableAbilitiesLen - 1);
 		i32 realIndex = 0;
 		for (i32 i = 0; i < currentMonsterData->abilitiesLen; i++) {
 			if (state.currentMonster.monster->level < currentMonsterData->abilities[i].level) { continue; }
@@ -711,7 +715,7 @@ static void opponent_monster_update(Monster *monster, AnimatedTiledSprite *sprit
 			playerActiveMonsters++;
 		}
 
-		i32 randomTarget = rand() % playerActiveMonsters;
+		i32 randomTarget = rng_range(rng_game(), 0, playerActiveMonsters - 1);
 		i32 displayedIndex = 0;
 		for (i32 i = 0; i < MAX_MONSTERS_PER_SIDE_LEN; i++) {
 			if (activeMonsters[i]->id == MonsterIDNone || activeMonsters[i]->health <= 0) {
@@ -732,6 +736,7 @@ static void opponent_monster_update(Monster *monster, AnimatedTiledSprite *sprit
 
 
 void monster_battle_update(f32 dt) {
+	PROFILE_FUNCTION();
 	if (game.gameModeState != GameModeBattle) { return; }
 	// music
 
@@ -852,10 +857,11 @@ void monster_battle_update(f32 dt) {
 // but since this scene is fairly basic, and stuff won't dynamically change their
 // z ordering; we will just manually draw them in the correct order.
 void monster_battle_draw() {
+	PROFILE_FUNCTION();
 if (game.gameModeState != GameModeBattle) { return; }
 
-	DrawTexture(game.battleStage.bgTexture, 0, 0, WHITE);
-	DrawTexturePro(
+	gpu_draw_texture(game.battleStage.bgTexture, 0, 0, WHITE);
+	gpu_draw_texture_pro(
 		game.battleStage.bgTexture,
 		(Rectangle){
 			.x= 0,
@@ -920,7 +926,7 @@ if (game.gameModeState != GameModeBattle) { return; }
 static void draw_monster_catch_failed_icon() {
 	if (!state.catchFailedSprite.active) { return; }
 
-	DrawTexturePro(
+	gpu_draw_texture_pro(
 		state.catchFailedSprite.sprite.texture,
 		rectangle_from_texture(state.catchFailedSprite.sprite.texture),
 		state.catchFailedSprite.rect,
@@ -934,7 +940,7 @@ static void draw_monster_attack() {
 	if (!state.attackAnimationSprite.active) { return; }
 	Rectangle animationFrame = animated_tiled_sprite_current_frame(&state.attackAnimationSprite.sprite);
 
-	DrawTexturePro(
+	gpu_draw_texture_pro(
 		state.attackAnimationSprite.sprite.texture,
 		animationFrame,
 		state.attackAnimationSprite.rect,
@@ -979,8 +985,8 @@ static void draw_monster(const Monster *monster, const AnimatedTiledSprite *spri
 		.x = monsterNameRect.x + monsterNamePadding,
 		.y = monsterNameRect.y + monsterNamePadding,
 	};
-	DrawRectangleRec(monsterNameRect, gameColors[ColorsWhite]);
-	DrawTextEx(
+	gpu_draw_rectangle_rec(monsterNameRect, gameColors[ColorsWhite]);
+	gpu_draw_text_ex(
 		assets.fonts.regular.rFont,
 		monsterName,
 		monsterNamePos,
@@ -1027,8 +1033,8 @@ static void draw_monster(const Monster *monster, const AnimatedTiledSprite *spri
 		.y = monsterLevelRect.y + monsterLevelPadding / 2,
 	};
 
-	DrawRectangleRec(monsterLevelRect, gameColors[ColorsWhite]);
-	DrawTextEx(
+	gpu_draw_rectangle_rec(monsterLevelRect, gameColors[ColorsWhite]);
+	gpu_draw_text_ex(
 		assets.fonts.small.rFont,
 		monsterLevelText,
 		monsterLevelPos,
@@ -1061,11 +1067,11 @@ static void draw_monster(const Monster *monster, const AnimatedTiledSprite *spri
 		state.currentMonsterRect = monsterDestRec; // todo - this is a big no no, but i don't feel like restructuring the code...
 	}
 	if (isCurrentMonster || isSelectedOpponent) {
-		BeginShaderMode(assets.shaders.textureOutline);
+		gpu_begin_shader_mode(assets.shaders.textureOutline);
 	}
 
 	// draw the monster AFTER the name/level
-	DrawTexturePro(
+	gpu_draw_texture_pro(
 		sprite->texture,
 		animationFrame,
 		monsterDestRec,
@@ -1074,7 +1080,7 @@ static void draw_monster(const Monster *monster, const AnimatedTiledSprite *spri
 		WHITE
 	);
 	if (isCurrentMonster || isSelectedOpponent) {
-		EndShaderMode();
+		gpu_end_shader_mode();
 	}
 
 	// monster stats
@@ -1087,7 +1093,7 @@ static void draw_monster(const Monster *monster, const AnimatedTiledSprite *spri
 	monsterStatsRect.x = monsterDestRec.x + (monsterDestRec.width - monsterStatsRect.width) / 2;
 	monsterStatsRect.y = monsterDestRec.y + monsterDestRec.height + 20 - monsterStatsRect.height;
 
-	DrawRectangleRec(monsterStatsRect, gameColors[ColorsWhite]);
+	gpu_draw_rectangle_rec(monsterStatsRect, gameColors[ColorsWhite]);
 
 	// health and energy
 	const f32 barWidth = monsterStatsRect.width * 0.9f;
@@ -1137,7 +1143,7 @@ static void draw_monster_stat_bar(Vector2 textPos, f32 barWidth, i32 value, i32
 		.width = barTextSize.x,
 		.height = barTextSize.y,
 	};
-	DrawTextEx(
+	gpu_draw_text_ex(
 		assets.fonts.small.rFont,
 		barText,
 		(Vector2){barTextRect.x, barTextRect.y},
@@ -1189,9 +1195,9 @@ static void draw_ui() {
 }
 
 static void draw_battle_icon(Texture2D texture, Vector2 pos, bool grayscale) {
-	if (grayscale) { BeginShaderMode(assets.shaders.grayscale); }
-	DrawTextureV(texture, pos, WHITE);
-	if (grayscale) { EndShaderMode(); }
+	if (grayscale) { gpu_begin_shader_mode(assets.shaders.grayscale); }
+	gpu_draw_texture_v(texture, pos, WHITE);
+	if (grayscale) { gpu_end_shader_mode(); }
 }
 
 static void draw_general_ui() {
@@ -1273,7 +1279,7 @@ static void draw_attacks_ui() {
 	const f32 itemRadius = 0.05f;
 	const f32 tableOffset = selectedIndex < visibleAttacks ?
 		0 : -((f32)(selectedIndex - visibleAttacks + 1)) * itemHeight;
-	DrawRectangleRounded(listBgRect, itemRadius, 1, gameColors[ColorsWhite]);
+	gpu_draw_rectangle_rounded(listBgRect, itemRadius, 1, gameColors[ColorsWhite]);
 
 	const MonsterData *currentMonsterData = game_data_for_monster_id(state.currentMonster.monster->id);
 	for (i32 i = 0; i < currentMonsterData->abilitiesLen; i++) {
@@ -1310,9 +1316,9 @@ static void draw_attacks_ui() {
 
 		bool isSelected = i == selectedIndex;
 		if (isSelected) {
-			DrawRectangleRounded(attackTextRect, itemRadius, 1, gameColors[ColorsDarkWhite]);
+			gpu_draw_rectangle_rounded(attackTextRect, itemRadius, 1, gameColors[ColorsDarkWhite]);
 		}
-		DrawTextEx(
+		gpu_draw_text_ex(
 			assets.fonts.regular.rFont,
 			abilityText,
 			rectangle_location(textRect),
@@ -1322,7 +1328,7 @@ static void draw_attacks_ui() {
 		);
 
 		const bool isReady = state.currentMonster.monster->energy >= abilityData->cost;
-		DrawRectangleRec(
+		gpu_draw_rectangle_rec(
 			rectangle_at(
 				(Rectangle){.width = attackTextRect.width * .1f, .height = attackTextRect.height},
 				rectangle_location(attackTextRect)
@@ -1352,7 +1358,7 @@ static void draw_switch_ui() {
 	const f32 itemRadius = 0.05f;
 	const f32 tableOffset = selectedIndex < visibleRows ?
 		0 : (f32)(-(selectedIndex - visibleRows + 1)) * itemHeight;
-	DrawRectangleRounded(listBodyRect, itemRadius, 1, gameColors[ColorsWhite]);
+	gpu_draw_rectangle_rounded(listBodyRect, itemRadius, 1, gameColors[ColorsWhite]);
 
 	i32 availableMonsterCount = 0;
 	const Monster *availableMonsters[MAX_PARTY_MONSTERS_LEN] = {};
@@ -1403,9 +1409,9 @@ static void draw_switch_ui() {
 		);
 		bool isSelected = (i32)i == selectedIndex;
 		if (isSelected) {
-			DrawRectangleRounded(monsterRowRect, itemRadius, 1, gameColors[ColorsDarkWhite]);
+			gpu_draw_rectangle_rounded(monsterRowRect, itemRadius, 1, gameColors[ColorsDarkWhite]);
 		}
-		DrawTexturePro(
+		gpu_draw_texture_pro(
 			monsterIcon,
 			rectangle_from_texture(monsterIcon),
 			monsterIconRect,
@@ -1421,7 +1427,7 @@ static void draw_switch_ui() {
 			Vector2Add(rectangle_top_right(monsterIconRect), (Vector2){monsterIconPadding, 0})
 		);
 
-		DrawTextEx(
+		gpu_draw_text_ex(
 			assets.fonts.regular.rFont,
 			rowText,
 			rectangle_location(textRect),
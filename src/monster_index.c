@@ -7,6 +7,8 @@
 #include "colors.h"
 #include "ui.h"
 #include "game_data.h"
+#include "gpu_stats.h"
+#include "input.h"
 #include <raylib.h>
 #include <math.h>
 
@@ -36,23 +38,23 @@ void monster_index_handle_input() {
 	if (game.gameModeState != GameModeMonsterIndex) {
 		return;
 	}
-	if (IsKeyPressed(KEY_ENTER) || IsKeyPressed(KEY_ESCAPE)) {
+	if (input_key_pressed(KEY_ENTER) || input_key_pressed(KEY_ESCAPE)) {
 		game.gameModeState = GameModePlaying;
 		game.monsterIndex.state.currentIndex = 0;
 		game.monsterIndex.state.selectedIndex = -1;
 		return;
 	}
-	if (IsKeyPressed(KEY_UP)) {
+	if (input_key_pressed(KEY_UP)) {
 		game.monsterIndex.state.currentIndex -= 1;
 		if (game.monsterIndex.state.currentIndex < 0) {
 			game.monsterIndex.state.currentIndex = game.monsterIndex.state.partyLength - 1;
 		}
 	}
-	if (IsKeyPressed(KEY_DOWN)) {
+	if (input_key_pressed(KEY_DOWN)) {
 		game.monsterIndex.state.currentIndex = (game.monsterIndex.state.currentIndex + 1) %
 											   game.monsterIndex.state.partyLength;
 	}
-	if (IsKeyPressed(KEY_SPACE)) {
+	if (input_key_pressed(KEY_SPACE)) {
 		if (game.monsterIndex.state.selectedIndex == -1) {
 			game.monsterIndex.state.selectedIndex = game.monsterIndex.state.currentIndex;
 		} else {
@@ -105,20 +107,20 @@ static void draw_monsters_list(Rectangle *menuRect, const f32 listWidth, const f
 			const f32 menuItemCornerRadius = 12;
 			if (CheckCollisionPointRec((Vector2){.x = (*menuRect).x, .y = (*menuRect).y + 1}, menuItemRect)) {
 				// this box is at the top
-				DrawCircle(
+				gpu_draw_circle(
 					(i32)(menuItemRect.x + menuItemCornerRadius),
 					(i32)(menuItemRect.y + menuItemCornerRadius),
 					menuItemCornerRadius,
 					backgroundColor
 				);
-				DrawRectangle(
+				gpu_draw_rectangle(
 					(i32)(menuItemRect.x + menuItemCornerRadius),
 					(i32)(menuItemRect.y),
 					(i32)(menuItemRect.width - menuItemCornerRadius),
 					(i32)(menuItemRect.height),
 					backgroundColor
 				);
-				DrawRectangle(
+				gpu_draw_rectangle(
 					(i32)(menuItemRect.x),
 					(i32)(menuItemRect.y + menuItemCornerRadius),
 					(i32)(menuItemRect.width),
@@ -130,20 +132,20 @@ static void draw_monsters_list(Rectangle *menuRect, const f32 listWidth, const f
 				(Vector2){.x = (*menuRect).x, .y = (*menuRect).y + (*menuRect).height - 1},
 				menuItemRect
 			)) {
-				DrawCircle(
+				gpu_draw_circle(
 					(i32)(menuItemRect.x + menuItemCornerRadius),
 					(i32)(menuItemRect.y - menuItemCornerRadius + menuItemRect.height),
 					menuItemCornerRadius,
 					backgroundColor
 				);
-				DrawRectangle(
+				gpu_draw_rectangle(
 					(i32)(menuItemRect.x),
 					(i32)(menuItemRect.y),
 					(i32)(menuItemRect.width),
 					(i32)(menuItemRect.height - menuItemCornerRadius),
 					backgroundColor
 				);
-				DrawRectangle(
+				gpu_draw_rectangle(
 					(i32)(menuItemRect.x + menuItemCornerRadius),
 					(i32)(menuItemRect.y),
 					(i32)(menuItemRect.width - menuItemCornerRadius),
@@ -151,7 +153,7 @@ static void draw_monsters_list(Rectangle *menuRect, const f32 listWidth, const f
 					backgroundColor
 				);
 			} else {
-				DrawRectangleRec(menuItemRect, backgroundColor);
+				gpu_draw_rectangle_rec(menuItemRect, backgroundColor);
 			}
 
 			if (monster.id == MonsterIDNone) { continue; } // empty slots
@@ -163,7 +165,7 @@ static void draw_monsters_list(Rectangle *menuRect, const f32 listWidth, const f
 				.x = menuItemRect.x + textPadding,
 				.y = menuItemRectMidLeft - (textSize.y / 2),
 			};
-			DrawTextEx(
+			gpu_draw_text_ex(
 				assets.fonts.regular.rFont,
 				monster.name,
 				pos,
@@ -185,7 +187,7 @@ static void draw_monsters_list(Rectangle *menuRect, const f32 listWidth, const f
 				.y = menuItemRectMidLeft - ((f32)monsterIconTexture.height / 2.f),
 			};
 
-			DrawTextureRec(monsterIconTexture, monsterIconFrame, monsterIconPos, WHITE);
+			gpu_draw_texture_rec(monsterIconTexture, monsterIconFrame, monsterIconPos, WHITE);
 		}
 	}
 
@@ -194,7 +196,7 @@ static void draw_monsters_list(Rectangle *menuRect, const f32 listWidth, const f
 		const f32 y = menuRect->y + itemHeight * (f32)i;
 		Vector2 start = {.x = menuRect->x, .y = y};
 		Vector2 end = {.x = menuRect->x + listWidth, .y = y};
-		DrawLineV(start, end, gameColors[ColorsLightGray]);
+		gpu_draw_line_v(start, end, gameColors[ColorsLightGray]);
 	}
 }
 
@@ -205,7 +207,7 @@ void monster_index_draw() {
 	Color c = {0, 0, 0, 200};
 
 	// background
-	DrawRectangleRec(game.monsterIndex.frame, c);
+	gpu_draw_rectangle_rec(game.monsterIndex.frame, c);
 	// draw the menu in the center of the screen
 	Rectangle menuRect = {
 		.height = roundf(0.8f * game.monsterIndex.frame.height),
@@ -235,7 +237,7 @@ void monster_index_draw() {
 		.width = 4,
 		.height = menuRect.height,
 	};
-	DrawRectangleRec(shadowBorder, (Color){0, 0, 0, 100});
+	gpu_draw_rectangle_rec(shadowBorder, (Color){0, 0, 0, 100});
 
 	// the detail view
 	const Color detailViewBGColor = gameColors[ColorsDark];
@@ -249,20 +251,20 @@ void monster_index_draw() {
 		.width = menuRect.width - listWidth,
 		.height = menuRect.height,
 	};
-	DrawCircle(
+	gpu_draw_circle(
 		(i32)(detailRec.x + detailRec.width - detailViewCornerRadius),
 		(i32)(detailRec.y + detailRec.height - detailViewCornerRadius),
 		detailViewCornerRadius,
 		detailViewBGColor
 	);
-	DrawRectangle(
+	gpu_draw_rectangle(
 		(i32)(detailRec.x),
 		(i32)(detailRec.y),
 		(i32)(detailRec.width - detailViewCornerRadius),
 		(i32)(detailRec.height),
 		detailViewBGColor
 	);
-	DrawRectangle(
+	gpu_draw_rectangle(
 		(i32)(detailRec.x),
 		(i32)(detailRec.y + detailViewCornerRadius),
 		(i32)(detailRec.width),
@@ -279,7 +281,7 @@ void monster_index_draw() {
 		.width = detailRec.width,
 		.height = detailRec.height * 0.4f,
 	};
-	DrawCircle(
+	gpu_draw_circle(
 		(i32)(detailRec.x + detailRec.width - detailViewCornerRadius),
 		(i32)(detailRec.y + detailViewCornerRadius),
 		detailViewCornerRadius,
@@ -287,11 +289,11 @@ void monster_index_draw() {
 	);
 	Rectangle toDrawMonsterDisplayRect = monsterDisplayRect;
 	toDrawMonsterDisplayRect.width -= detailViewCornerRadius;
-	DrawRectangleRec(toDrawMonsterDisplayRect, monsterBGColor);
+	gpu_draw_rectangle_rec(toDrawMonsterDisplayRect, monsterBGColor);
 	toDrawMonsterDisplayRect = monsterDisplayRect;
 	toDrawMonsterDisplayRect.y += detailViewCornerRadius;
 	toDrawMonsterDisplayRect.height -= detailViewCornerRadius;
-	DrawRectangleRec(toDrawMonsterDisplayRect, monsterBGColor);
+	gpu_draw_rectangle_rec(toDrawMonsterDisplayRect, monsterBGColor);
 
 	const Monster currentMonster = game.playerMonsters[game.monsterIndex.state.currentIndex];
 	game.monsterIndex.state.animatedMonster.texture = assets.monsterTileMaps[currentMonster.id].texture;
@@ -308,7 +310,7 @@ void monster_index_draw() {
 		.height = monsterToRectHeight,
 		.width = monsterToRectHeight,
 	};
-	DrawTexturePro(
+	gpu_draw_texture_pro(
 		animatedSprite->texture,
 		animationFrame,
 		monsterDestRec,
@@ -319,7 +321,7 @@ void monster_index_draw() {
 
 	// monster name and level
 	const Vector2 monsterNamePos = {.x = monsterDisplayRect.x + 10, .y = monsterDisplayRect.y + 10};
-	DrawTextEx(
+	gpu_draw_text_ex(
 		assets.fonts.bold.rFont,
 		currentMonster.name,
 		monsterNamePos,
@@ -344,7 +346,7 @@ void monster_index_draw() {
 		.x = monsterDisplayRect.x + 10,
 		.y = monsterDisplayRect.y + monsterDisplayRect.height - levelTextHeight - 16, // 10 padding
 	};
-	DrawTextEx(
+	gpu_draw_text_ex(
 		assets.fonts.regular.rFont,
 		levelText,
 		monsterLevelPos,
@@ -381,7 +383,7 @@ void monster_index_draw() {
 		.x = monsterDisplayRect.x + monsterDisplayRect.width - typeTextSize.x - 10,
 		.y = monsterDisplayRect.y + monsterDisplayRect.height - typeTextSize.y - 10, // 10 padding
 	};
-	DrawTextEx(
+	gpu_draw_text_ex(
 		assets.fonts.regular.rFont,
 		monsterTypeText,
 		monsterElementPos,
@@ -417,7 +419,7 @@ void monster_index_draw() {
 		.x = healthBarRect.x + hpTextPadding,
 		.y = healthBarRect.y + hpTextPadding,
 	};
-	DrawTextEx(
+	gpu_draw_text_ex(
 		assets.fonts.regular.rFont,
 		hpText,
 		hpTextPos,
@@ -453,7 +455,7 @@ void monster_index_draw() {
 		.x = energyBarRect.x + energyTextPadding,
 		.y = energyBarRect.y + energyTextPadding,
 	};
-	DrawTextEx(
+	gpu_draw_text_ex(
 		assets.fonts.regular.rFont,
 		energyText,
 		energyPos,
@@ -480,7 +482,7 @@ void monster_index_draw() {
 		.x = statsRect.x,
 		.y = statsRect.y - statsTextSize.y,
 	};
-	DrawTextEx(
+	gpu_draw_text_ex(
 		assets.fonts.regular.rFont,
 		statsText,
 		statsPos,
@@ -530,14 +532,14 @@ void monster_index_draw() {
 			.height = (f32)statIcons[i].height,
 			.width = (f32)statIcons[i].width,
 		};
-		DrawTextureV(statIcons[i], (Vector2){iconRect.x, iconRect.y}, WHITE);
+		gpu_draw_texture_v(statIcons[i], (Vector2){iconRect.x, iconRect.y}, WHITE);
 
 		const Vector2 singleStatSize = MeasureTextEx(assets.fonts.regular.rFont, statNames[i], singleStatFontSize, 1);
 		const Vector2 singleStatTextPos = {
 			.x = iconRect.x + iconRect.width + singleStatTextPadding,
 			.y = singleStatRect.y + (singleStatRect.height - singleStatSize.y) / 2,
 		};
-		DrawTextEx(
+		gpu_draw_text_ex(
 			assets.fonts.regular.rFont,
 			statNames[i],
 			singleStatTextPos,
@@ -557,7 +559,7 @@ void monster_index_draw() {
 		.x = abilitiesRect.x,
 		.y = abilitiesRect.y - abilitiesTextSize.y,
 	};
-	DrawTextEx(
+	gpu_draw_text_ex(
 		assets.fonts.regular.rFont,
 		abilitiesText,
 		abilitiesPos,
@@ -592,8 +594,8 @@ void monster_index_draw() {
 
 		const MonsterAbilityData *attackData = game_data_for_monster_attack_id(abilityID);
 		const Color abilityBGColor = monster_type_color(attackData->element);
-		DrawRectangleRounded(abilityRect, 0.4f, 1, abilityBGColor);
-		DrawTextEx(
+		gpu_draw_rectangle_rounded(abilityRect, 0.4f, 1, abilityBGColor);
+		gpu_draw_text_ex(
 			assets.fonts.regular.rFont,
 			abilityText,
 			abilityPos,
@@ -0,0 +1,96 @@
+//
+// Created by Hector Mejia on 10/17/26.
+//
+
+#include "occupancy_grid.h"
+
+#include <math.h>
+
+#define BITS_PER_WORD 64
+
+static i32 cell_index(const OccupancyGrid *grid, i32 col, i32 row);
+
+OccupancyGrid occupancy_grid_new(Arena *arena, const f32 worldWidth, const f32 worldHeight, const f32 cellSize) {
+	panicIf(cellSize <= 0, "occupancy grid cell size must be positive");
+
+	OccupancyGrid grid = {
+		.cellSize = cellSize,
+		.columns = max((i32)ceilf(worldWidth / cellSize), 1),
+		.rows = max((i32)ceilf(worldHeight / cellSize), 1),
+	};
+	const i32 words = ((grid.columns * grid.rows) + BITS_PER_WORD - 1) / BITS_PER_WORD;
+	grid.bits = arena_alloc(arena, sizeof(*grid.bits) * words);
+	return grid;
+}
+
+void occupancy_grid_fill(OccupancyGrid *grid, const Rectangle rect) {
+	if (rect.width <= 0 || rect.height <= 0) { return; }
+
+	// a box ending exactly on a cell border doesn't reach into the next cell.
+	const i32 firstCol = max((i32)floorf(rect.x / grid->cellSize), 0);
+	const i32 firstRow = max((i32)floorf(rect.y / grid->cellSize), 0);
+	const i32 lastCol = min((i32)ceilf((rect.x + rect.width) / grid->cellSize) - 1, grid->columns - 1);
+	const i32 lastRow = min((i32)ceilf((rect.y + rect.height) / grid->cellSize) - 1, grid->rows - 1);
+	for (i32 row = firstRow; row <= lastRow; row++) {
+		for (i32 col = firstCol; col <= lastCol; col++) {
+			const i32 index = cell_index(grid, col, row);
+			grid->bits[index / BITS_PER_WORD] |= (u64)1 << (index % BITS_PER_WORD);
+		}
+	}
+}
+
+// outside the map nothing is solid.
+bool occupancy_grid_blocked(const OccupancyGrid *grid, const i32 col, const i32 row) {
+	if (col < 0 || row < 0 || col >= grid->columns || row >= grid->rows) { return false; }
+
+	const i32 index = cell_index(grid, col, row);
+	return (grid->bits[index / BITS_PER_WORD] >> (index % BITS_PER_WORD)) & 1;
+}
+
+bool occupancy_grid_line_clear(const OccupancyGrid *grid, const Vector2 from, const Vector2 to) {
+	i32 col = (i32)floorf(from.x / grid->cellSize);
+	i32 row = (i32)floorf(from.y / grid->cellSize);
+	const i32 endCol = (i32)floorf(to.x / grid->cellSize);
+	const i32 endRow = (i32)floorf(to.y / grid->cellSize);
+
+	const f32 dx = to.x - from.x;
+	const f32 dy = to.y - from.y;
+	const i32 stepX = (dx > 0) - (dx < 0);
+	const i32 stepY = (dy > 0) - (dy < 0);
+
+	// how far along the segment (0 at from, 1 at to) the next vertical and
+	// horizontal cell borders are, and how far apart consecutive borders are.
+	const f32 tDeltaX = stepX != 0 ? grid->cellSize / fabsf(dx) : INFINITY;
+	const f32 tDeltaY = stepY != 0 ? grid->cellSize / fabsf(dy) : INFINITY;
+	f32 tMaxX = INFINITY;
+	f32 tMaxY = INFINITY;
+	if (stepX != 0) {
+		const f32 borderX = (f32)(stepX > 0 ? col + 1 : col) * grid->cellSize;
+		tMaxX = (borderX - from.x) / dx;
+	}
+	if (stepY != 0) {
+		const f32 borderY = (f32)(stepY > 0 ? row + 1 : row) * grid->cellSize;
+		tMaxY = (borderY - from.y) / dy;
+	}
+
+	// every step crosses one border, counting them keeps float error from
+	// walking past the last cell.
+	const i32 steps = abs(endCol - col) + abs(endRow - row);
+	for (i32 i = 1; i < steps; i++) {
+		if (tMaxX < tMaxY) {
+			col += stepX;
+			tMaxX += tDeltaX;
+		} else {
+			row += stepY;
+			tMaxY += tDeltaY;
+		}
+		if (occupancy_grid_blocked(grid, col, row)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+static i32 cell_index(const OccupancyGrid *grid, const i32 col, const i32 row) {
+	return (row * grid->columns) + col;
+}
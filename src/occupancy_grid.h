@@ -0,0 +1,41 @@
+//
+// Created by Hector Mejia on 10/17/26.
+//
+
+#ifndef RAYLIB_POKEMON_CLONE_OCCUPANCY_GRID_H
+#define RAYLIB_POKEMON_CLONE_OCCUPANCY_GRID_H
+
+#include "raylib.h"
+#include "common.h"
+#include "memory/arena.h"
+
+// One bit per tile, set when anything solid covers part of the tile. It is
+// coarser than the geometry it came from (a box covering a sliver of a tile
+// blocks the whole tile), in exchange a line can be checked a tile at a time
+// instead of against every box on the map.
+typedef struct OccupancyGrid {
+	f32 cellSize;
+	i32 columns;
+	i32 rows;
+	u64 *bits; // columns * rows bits, row by row
+} OccupancyGrid;
+
+OccupancyGrid occupancy_grid_new(Arena *arena, f32 worldWidth, f32 worldHeight, f32 cellSize);
+
+/**
+ * Marks every cell the rectangle covers, even partially. The parts outside
+ * the grid are ignored.
+ */
+void occupancy_grid_fill(OccupancyGrid *grid, Rectangle rect);
+bool occupancy_grid_blocked(const OccupancyGrid *grid, i32 col, i32 row);
+
+/**
+ * Walks the cells the segment goes through (Amanatides and Woo), stopping at
+ * the first blocked one. The cells the segment starts and ends in are not
+ * checked, whatever stands there (a character) is kept out of the solid parts
+ * by its own collisions, even when the tile it stands on is only partly free.
+ * @return true if no blocked cell is in the way
+ */
+bool occupancy_grid_line_clear(const OccupancyGrid *grid, Vector2 from, Vector2 to);
+
+#endif //RAYLIB_POKEMON_CLONE_OCCUPANCY_GRID_H
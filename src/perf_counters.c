@@ -0,0 +1,155 @@
+//
+// Created by Hector Mejia on 10/17/26.
+//
+
+#include "perf_counters.h"
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+static const char *perfCounterNames[PerfCounterCount] = {
+	[PerfCounterCycles] = "cycles",
+	[PerfCounterInstructions] = "instructions",
+	[PerfCounterCacheMisses] = "cache misses",
+	[PerfCounterBranchMisses] = "branch misses",
+	[PerfCounterPageFaults] = "page faults",
+};
+
+static struct {
+	bool enabled;
+	i32 fds[PerfCounterCount]; // -1 when it didn't open
+} perf = {};
+
+#ifdef __linux__
+
+static i32 open_counter(u32 type, u64 config);
+
+bool perf_counters_init() {
+	if (perf.enabled) { return true; }
+
+	static const struct {
+		u32 type;
+		u64 config;
+	} events[PerfCounterCount] = {
+		[PerfCounterCycles] = {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+		[PerfCounterInstructions] = {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+		[PerfCounterCacheMisses] = {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+		[PerfCounterBranchMisses] = {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+		[PerfCounterPageFaults] = {PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS},
+	};
+
+	i32 opened = 0;
+	for (i32 i = 0; i < PerfCounterCount; i++) {
+		perf.fds[i] = open_counter(events[i].type, events[i].config);
+		if (perf.fds[i] >= 0) {
+			opened++;
+		} else {
+			slogw("perf counter %s is not available", perfCounterNames[i]);
+		}
+	}
+	if (opened == 0) {
+		slogw("no perf counters, check /proc/sys/kernel/perf_event_paranoid");
+		return false;
+	}
+
+	for (i32 i = 0; i < PerfCounterCount; i++) {
+		if (perf.fds[i] < 0) { continue; }
+		ioctl(perf.fds[i], PERF_EVENT_IOC_RESET, 0);
+		ioctl(perf.fds[i], PERF_EVENT_IOC_ENABLE, 0);
+	}
+	perf.enabled = true;
+	return true;
+}
+
+void perf_counters_shutdown() {
+	if (!perf.enabled) { return; }
+
+	for (i32 i = 0; i < PerfCounterCount; i++) {
+		if (perf.fds[i] >= 0) {
+			close(perf.fds[i]);
+		}
+	}
+	perf = (typeof(perf)){};
+}
+
+PerfCounterValues perf_counters_read() {
+	PerfCounterValues values = {};
+	if (!perf.enabled) { return values; }
+
+	for (i32 i = 0; i < PerfCounterCount; i++) {
+		if (perf.fds[i] < 0) { continue; }
+
+		// value, time enabled, time running.
+		u64 data[3] = {};
+		if (read(perf.fds[i], data, sizeof(data)) != sizeof(data) || data[2] == 0) { continue; }
+		values.counts[i] = data[2] < data[1] ? (u64)((f64)data[0] * ((f64)data[1] / (f64)data[2])) : data[0];
+	}
+	return values;
+}
+
+static i32 open_counter(const u32 type, const u64 config) {
+	struct perf_event_attr attr = {
+		.type = type,
+		.size = sizeof(attr),
+		.config = config,
+		.disabled = 1,
+		.exclude_kernel = 1,
+		.exclude_hv = 1,
+		.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING,
+	};
+	// this thread, any cpu, no group.
+	return (i32)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+}
+
+#else
+
+bool perf_counters_init() {
+	slogw("perf counters are only supported on linux");
+	return false;
+}
+
+void perf_counters_shutdown() {}
+
+PerfCounterValues perf_counters_read() {
+	return (PerfCounterValues){};
+}
+
+#endif
+
+bool perf_counters_enabled() {
+	return perf.enabled;
+}
+
+bool perf_counters_available(const PerfCounter counter) {
+	return perf.enabled && perf.fds[counter] >= 0;
+}
+
+PerfCounterValues perf_counters_since(const PerfCounterValues start) {
+	PerfCounterValues values = perf_counters_read();
+	for (i32 i = 0; i < PerfCounterCount; i++) {
+		// scaled counts can come out a little behind the last read.
+		values.counts[i] = values.counts[i] > start.counts[i] ? values.counts[i] - start.counts[i] : 0;
+	}
+	return values;
+}
+
+void perf_counters_add(PerfCounterValues *total, const PerfCounterValues values) {
+	for (i32 i = 0; i < PerfCounterCount; i++) {
+		total->counts[i] += values.counts[i];
+	}
+}
+
+f64 perf_counters_ipc(const PerfCounterValues values) {
+	const u64 cycles = values.counts[PerfCounterCycles];
+	if (cycles == 0) { return 0; }
+
+	return (f64)values.counts[PerfCounterInstructions] / (f64)cycles;
+}
+
+const char *perf_counter_name(const PerfCounter counter) {
+	return perfCounterNames[counter];
+}
@@ -0,0 +1,53 @@
+//
+// Created by Hector Mejia on 10/17/26.
+//
+
+#ifndef RAYLIB_POKEMON_CLONE_PERF_COUNTERS_H
+#define RAYLIB_POKEMON_CLONE_PERF_COUNTERS_H
+
+#include "common.h"
+
+// Hardware counters for the calling thread through perf_event_open, to tell
+// a phase that is waiting on memory from one that is just doing a lot. Each
+// counter opens on its own, so a machine without one of them (VMs often have
+// no cache counters) still gets the rest. When the kernel says no to all of
+// them (perf_event_paranoid, containers, not linux) reads return zeros and
+// nothing else changes.
+typedef enum PerfCounter {
+	PerfCounterCycles = 0,
+	PerfCounterInstructions,
+	PerfCounterCacheMisses,
+	PerfCounterBranchMisses,
+	PerfCounterPageFaults,
+
+	PerfCounterCount,
+} PerfCounter;
+
+typedef struct PerfCounterValues {
+	u64 counts[PerfCounterCount];
+} PerfCounterValues;
+
+/**
+ * Opens the counters for the calling thread, reads only count that thread.
+ * @return false if none of them could be opened
+ */
+bool perf_counters_init();
+void perf_counters_shutdown();
+bool perf_counters_enabled();
+bool perf_counters_available(PerfCounter counter);
+
+/**
+ * The counts since perf_counters_init, zero for counters that didn't open.
+ * Counters the kernel had to multiplex are scaled up to the time they were
+ * enabled.
+ */
+PerfCounterValues perf_counters_read();
+// what the counters went up by since start was read.
+PerfCounterValues perf_counters_since(PerfCounterValues start);
+void perf_counters_add(PerfCounterValues *total, PerfCounterValues values);
+
+// instructions per cycle, 0 without both counters.
+f64 perf_counters_ipc(PerfCounterValues values);
+const char *perf_counter_name(PerfCounter counter);
+
+#endif //RAYLIB_POKEMON_CLONE_PERF_COUNTERS_H
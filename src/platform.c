@@ -0,0 +1,122 @@
+//
+// Created by Hector Mejia on 10/17/26.
+//
+
+#include "platform.h"
+
+#include <stdatomic.h>
+
+// a png starts with an 8 byte signature, then the IHDR chunk, its length and
+// type take 8 more bytes and the big endian width and height follow.
+#define PNG_SIZE_OFFSET 16
+#define PNG_HEADER_LEN 24
+
+static struct {
+	bool headless;
+	bool manualTime;
+	i32 screenWidth;
+	i32 screenHeight;
+	f64 time;
+	// maps load on a worker thread and get their textures there too.
+	atomic_uint nextTextureID;
+} platform = {};
+
+static Texture2D placeholder_texture(i32 width, i32 height);
+static bool png_size(const char *path, i32 *outWidth, i32 *outHeight);
+
+void platform_init_headless(const i32 screenWidth, const i32 screenHeight) {
+	platform.headless = true;
+	platform.screenWidth = screenWidth;
+	platform.screenHeight = screenHeight;
+	platform_use_manual_time();
+	atomic_store(&platform.nextTextureID, 1);
+}
+
+bool platform_is_headless() {
+	return platform.headless;
+}
+
+void platform_use_manual_time() {
+	platform.manualTime = true;
+	platform.time = 0;
+}
+
+void platform_advance_time(const f64 secs) {
+	panicIf(!platform.manualTime, "time only moves by hand after platform_use_manual_time");
+	platform.time += secs;
+}
+
+f64 platform_time() {
+	return platform.manualTime ? platform.time : GetTime();
+}
+
+i32 platform_screen_width() {
+	return platform.headless ? platform.screenWidth : GetScreenWidth();
+}
+
+i32 platform_screen_height() {
+	return platform.headless ? platform.screenHeight : GetScreenHeight();
+}
+
+Texture2D platform_load_texture(const char *path) {
+	if (!platform.headless) {
+		return LoadTexture(path);
+	}
+
+	i32 width = 0;
+	i32 height = 0;
+	if (!png_size(path, &width, &height)) {
+		// not a png, decoding it is slower but still needs no GPU.
+		const Image image = LoadImage(path);
+		width = image.width;
+		height = image.height;
+		UnloadImage(image);
+	}
+	if (width == 0 || height == 0) {
+		slogw("could not read the size of %s", path);
+		return (Texture2D){};
+	}
+	return placeholder_texture(width, height);
+}
+
+Texture2D platform_load_texture_from_image(const Image image) {
+	if (!platform.headless) {
+		return LoadTextureFromImage(image);
+	}
+	return placeholder_texture(image.width, image.height);
+}
+
+void platform_unload_texture(const Texture2D texture) {
+	if (platform.headless) { return; }
+
+	UnloadTexture(texture);
+}
+
+static Texture2D placeholder_texture(const i32 width, const i32 height) {
+	return (Texture2D){
+		.id = atomic_fetch_add(&platform.nextTextureID, 1),
+		.width = width,
+		.height = height,
+		.mipmaps = 1,
+		.format = PIXELFORMAT_UNCOMPRESSED_R8G8B8A8,
+	};
+}
+
+static bool png_size(const char *path, i32 *outWidth, i32 *outHeight) {
+	static const byte signature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+
+	FILE *file = fopen(path, "rb");
+	if (file == nil) { return false; }
+
+	byte header[PNG_HEADER_LEN];
+	const bool read = fread(header, 1, sizeof(header), file) == sizeof(header);
+	fclose(file);
+	if (!read || memcmp(header, signature, sizeof(signature)) != 0) {
+		return false;
+	}
+
+	const byte *size = header + PNG_SIZE_OFFSET;
+	*outWidth = (i32)(((u32)size[0] << 24) | ((u32)size[1] << 16) | ((u32)size[2] << 8) | size[3]);
+	*outHeight = (i32)(((u32)size[4] << 24) | ((u32)size[5] << 16) | ((u32)size[6] << 8) | size[7]);
+	return true;
+}
@@ -0,0 +1,34 @@
+//
+// Created by Hector Mejia on 10/17/26.
+//
+
+#ifndef RAYLIB_POKEMON_CLONE_PLATFORM_H
+#define RAYLIB_POKEMON_CLONE_PLATFORM_H
+
+#include "raylib.h"
+#include "common.h"
+
+// The few raylib calls that need a window, a GL context or an audio device,
+// for the parts of the game that have to keep running without them. Headless
+// runs have no window: textures are placeholders with the size of the image
+// and an id of their own (so batching still sees texture changes), nothing
+// is drawn, the screen is the size given here and time only moves when the
+// caller says so.
+void platform_init_headless(i32 screenWidth, i32 screenHeight);
+bool platform_is_headless();
+// platform_time starts at 0 and stops following the wall clock, it only moves
+// with platform_advance_time. Headless runs always use it, replays use it so
+// timers see the frame times that were recorded.
+void platform_use_manual_time();
+void platform_advance_time(f64 secs);
+
+// GetTime, GetScreenWidth and GetScreenHeight, or their headless stand-ins.
+f64 platform_time();
+i32 platform_screen_width();
+i32 platform_screen_height();
+
+Texture2D platform_load_texture(const char *path);
+Texture2D platform_load_texture_from_image(Image image);
+void platform_unload_texture(Texture2D texture);
+
+#endif //RAYLIB_POKEMON_CLONE_PLATFORM_H
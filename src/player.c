@@ -8,9 +8,12 @@
 #include "character_entity.h"
 #include "game.h"
 #include "game_data.h"
+#include "gpu_stats.h"
 #include "array/array.h"
 #include "raymath.h"
 #include "settings.h"
+#include "input.h"
+#include "profiler.h"
 #include "raylib_extras.h"
 
 static void player_handle_dialog(Player *p);
@@ -34,7 +37,7 @@ void player_free(const Player *p) {
 }
 
 void player_input(Player *p) {
-	if (IsKeyPressed(KEY_SPACE)) {
+	if (input_key_pressed(KEY_SPACE)) {
 		player_handle_dialog(p);
 	}
 
@@ -43,19 +46,19 @@ void player_input(Player *p) {
 	}
 
 	p->characterComponent.velocity = (Vector2){};
-	if (IsKeyDown(KEY_UP) || IsKeyDown(KEY_W)) {
+	if (input_key_down(KEY_UP) || input_key_down(KEY_W)) {
 		p->characterComponent.direction = CharacterDirectionUp;
 		p->characterComponent.velocity.y -= 1;
 	}
-	if (IsKeyDown(KEY_DOWN) || IsKeyDown(KEY_S)) {
+	if (input_key_down(KEY_DOWN) || input_key_down(KEY_S)) {
 		p->characterComponent.direction = CharacterDirectionDown;
 		p->characterComponent.velocity.y += 1;
 	}
-	if (IsKeyDown(KEY_LEFT) || IsKeyDown(KEY_A)) {
+	if (input_key_down(KEY_LEFT) || input_key_down(KEY_A)) {
 		p->characterComponent.direction = CharacterDirectionLeft;
 		p->characterComponent.velocity.x -= 1;
 	}
-	if (IsKeyDown(KEY_RIGHT) || IsKeyDown(KEY_D)) {
+	if (input_key_down(KEY_RIGHT) || input_key_down(KEY_D)) {
 		p->characterComponent.direction = CharacterDirectionRight;
 		p->characterComponent.velocity.x += 1;
 	}
@@ -63,33 +66,17 @@ void player_input(Player *p) {
 }
 
 void player_update(Player *p, const f32 deltaTime) {
+	PROFILE_FUNCTION();
 	const Rectangle oldPlayerFrame = p->characterComponent.frame;
 	character_update(&p->characterComponent, deltaTime);
 
-	// collisions
-	array_range(game.currentMap->collisionBoxes, i) {
-		const Rectangle box = game.currentMap->collisionBoxes[i];
-		if (CheckCollisionRecs(p->characterComponent.hitBox, box)) {
-			p->characterComponent.frame = oldPlayerFrame;
-			break;
-		}
-	}
-	array_range(game.currentMap->mainSprites, i) {
-		const Entity entity = game.currentMap->mainSprites[i].entity;
-		if (!entity.collideable) { continue; }
-
-		if (CheckCollisionRecs(p->characterComponent.hitBox, entity.hitBox)) {
-			game.player.characterComponent.frame = oldPlayerFrame;
-			break;
-		}
+	// collisions, standing still can't walk into anything.
+	const Rectangle frame = p->characterComponent.frame;
+	if (frame.x == oldPlayerFrame.x && frame.y == oldPlayerFrame.y) {
+		return;
 	}
-	array_range(game.currentMap->overWorldCharacters, i) {
-		const Rectangle box = game.currentMap->overWorldCharacters[i].hitBox;
-
-		if (CheckCollisionRecs(p->characterComponent.hitBox, box)) {
-			game.player.characterComponent.frame = oldPlayerFrame;
-			break;
-		}
+	if (map_collides(game.currentMap, p->characterComponent.hitBox)) {
+		p->characterComponent.frame = oldPlayerFrame;
 	}
 }
 
@@ -161,16 +148,22 @@ static void player_handle_dialog(Player *p) {
 }
 
 
-void player_draw(const Player *p) {
+void player_draw(const Player *p, const f32 depth) {
 	// ok because the characters and the player are the same exact structure.
-	character_draw(&p->characterComponent);
+	character_draw(&p->characterComponent, depth);
 	if (p->noticed) {
 		const f32 padding = 10;
 		const Vector2 exclamationPos = {
 			.x = p->characterComponent.frame.x + padding + padding,
 			.y = p->characterComponent.frame.y - assets.exclamationMarkTexture.height - padding,
 		};
-		DrawTextureV(assets.exclamationMarkTexture, exclamationPos, WHITE);
+		const Rectangle exclamationRect = {
+			.width = (f32)assets.exclamationMarkTexture.width,
+			.height = (f32)assets.exclamationMarkTexture.height,
+		};
+		const GpuSubsystem subsystem = gpu_stats_set_subsystem(GpuSubsystemCharacters);
+		draw_buffer_push_texture(DrawLayerOverlay, 0, assets.exclamationMarkTexture, exclamationRect, exclamationPos, WHITE);
+		gpu_stats_set_subsystem(subsystem);
 	}
 }
 
@@ -19,7 +19,7 @@ Player player_new(Vector2 position);
 void player_free(const Player *p);
 void player_input(Player *p);
 void player_update(Player *p, f32 deltaTime);
-void player_draw(const Player *p);
+void player_draw(const Player *p, f32 depth);
 Vector2 player_get_center(const Player *p);
 void player_block(Player *p);
 void player_unblock(Player *p);
@@ -0,0 +1,278 @@
+//
+// Created by Hector Mejia on 10/17/26.
+//
+
+#include "profiler.h"
+
+#include <pthread.h>
+#include <stdatomic.h>
+
+#include "memory/memory.h"
+
+typedef struct ProfilerEvent {
+	const char *name;
+	u64 startNs;
+	u64 endNs;
+	u32 depth;
+} ProfilerEvent;
+
+typedef struct ProfilerThread {
+	char name[MAX_PROFILER_THREAD_NAME_LEN];
+	bool claimed;
+	ProfilerEvent *events; // PROFILER_RING_EVENTS, allocated on first claim
+	// events ever written, the ring index is this modulo its size.
+	atomic_ullong written;
+	// where profiler_frame_end left off.
+	u64 frameStart;
+
+	i32 depth;
+	struct {
+		const char *name;
+		u64 startNs;
+	} open[MAX_PROFILER_DEPTH];
+} ProfilerThread;
+
+static struct {
+	pthread_mutex_t lock;
+	u64 startNs;
+	ProfilerThread threads[MAX_PROFILER_THREADS];
+	ProfilerZoneStats frameZones[MAX_PROFILER_FRAME_ZONES];
+	i32 frameZonesLen;
+} profiler = {.lock = PTHREAD_MUTEX_INITIALIZER};
+
+static _Thread_local ProfilerThread *currentThread = nil;
+
+static i32 compare_zone_start(const void *a, const void *b);
+
+void profiler_init() {
+	profiler.startNs = profiler_now_ns();
+	profiler_thread_begin("main");
+}
+
+void profiler_shutdown() {
+	profiler_thread_end();
+
+	pthread_mutex_lock(&profiler.lock);
+	for (i32 i = 0; i < MAX_PROFILER_THREADS; i++) {
+		ProfilerThread *thread = &profiler.threads[i];
+		panicIf(thread->claimed, "profiler thread %s still running at shutdown", thread->name);
+		if (thread->events != nil) {
+			mfree(thread->events, sizeof(*thread->events) * PROFILER_RING_EVENTS, MemoryTagGame);
+		}
+		*thread = (ProfilerThread){};
+	}
+	pthread_mutex_unlock(&profiler.lock);
+	profiler.frameZonesLen = 0;
+}
+
+void profiler_thread_begin(const char *name) {
+	panicIf(currentThread != nil, "thread already profiled as %s", currentThread->name);
+
+	pthread_mutex_lock(&profiler.lock);
+	ProfilerThread *slot = nil;
+	for (i32 i = 0; i < MAX_PROFILER_THREADS && slot == nil; i++) {
+		ProfilerThread *thread = &profiler.threads[i];
+		if (!thread->claimed && thread->events != nil && streq(thread->name, name)) {
+			slot = thread;
+		}
+	}
+	for (i32 i = 0; i < MAX_PROFILER_THREADS && slot == nil; i++) {
+		if (profiler.threads[i].events == nil) {
+			slot = &profiler.threads[i];
+			snprintf(slot->name, sizeof(slot->name), "%s", name);
+			slot->events = mallocate(sizeof(*slot->events) * PROFILER_RING_EVENTS, MemoryTagGame);
+			panicIfNil(slot->events, "failed to alloc profiler events");
+		}
+	}
+	if (slot != nil) {
+		slot->claimed = true;
+		slot->depth = 0;
+		slot->frameStart = atomic_load(&slot->written);
+	}
+	pthread_mutex_unlock(&profiler.lock);
+
+	if (slot == nil) {
+		slogw("no profiler slot left for thread %s, its zones are dropped", name);
+	}
+	currentThread = slot;
+}
+
+void profiler_thread_end() {
+	if (currentThread == nil) { return; }
+
+	pthread_mutex_lock(&profiler.lock);
+	currentThread->claimed = false;
+	pthread_mutex_unlock(&profiler.lock);
+	currentThread = nil;
+}
+
+void profiler_begin(const char *name) {
+	ProfilerThread *thread = currentThread;
+	if (thread == nil) { return; }
+
+	// zones deeper than the stack still count, so they end in the right
+	// place, they just aren't kept.
+	if (thread->depth < MAX_PROFILER_DEPTH) {
+		thread->open[thread->depth].name = name;
+		thread->open[thread->depth].startNs = profiler_now_ns();
+	}
+	thread->depth++;
+}
+
+void profiler_end() {
+	ProfilerThread *thread = currentThread;
+	if (thread == nil) { return; }
+
+	panicIf(thread->depth == 0, "profiler_end without a zone open on %s", thread->name);
+	thread->depth--;
+	if (thread->depth >= MAX_PROFILER_DEPTH) { return; }
+
+	const u64 written = atomic_load_explicit(&thread->written, memory_order_relaxed);
+	thread->events[written % PROFILER_RING_EVENTS] = (ProfilerEvent){
+		.name = thread->open[thread->depth].name,
+		.startNs = thread->open[thread->depth].startNs,
+		.endNs = profiler_now_ns(),
+		.depth = (u32)thread->depth,
+	};
+	atomic_store_explicit(&thread->written, written + 1, memory_order_release);
+}
+
+void profiler_zone_cleanup(const char **name) {
+	(void)name;
+	profiler_end();
+}
+
+void profiler_frame_end() {
+	ProfilerThread *thread = currentThread;
+	if (thread == nil) { return; }
+
+	const u64 written = atomic_load(&thread->written);
+	// a frame with more zones than the ring holds only shows the newest.
+	const u64 first = max(thread->frameStart, written > PROFILER_RING_EVENTS ? written - PROFILER_RING_EVENTS : 0);
+	thread->frameStart = written;
+
+	// zones are stored as they close, so children come before their parents.
+	// they get summed by name and depth, then put back in the order they
+	// opened. The start of the first call stands in for the order.
+	u64 firstStart[MAX_PROFILER_FRAME_ZONES];
+	i32 len = 0;
+	for (u64 i = first; i < written; i++) {
+		const ProfilerEvent *event = &thread->events[i % PROFILER_RING_EVENTS];
+		i32 zone = 0;
+		while (zone < len && (profiler.frameZones[zone].name != event->name ||
+							  profiler.frameZones[zone].depth != (i32)event->depth)) {
+			zone++;
+		}
+		if (zone == len) {
+			if (len == MAX_PROFILER_FRAME_ZONES) { continue; }
+			profiler.frameZones[len] = (ProfilerZoneStats){.name = event->name, .depth = (i32)event->depth};
+			firstStart[len] = event->startNs;
+			len++;
+		}
+		profiler.frameZones[zone].calls++;
+		profiler.frameZones[zone].ms += (f64)(event->endNs - event->startNs) / 1e6;
+		firstStart[zone] = min(firstStart[zone], event->startNs);
+	}
+
+	// the starts are sorted along with the zones, so both go through qsort as
+	// one array of pairs.
+	struct {
+		u64 start;
+		ProfilerZoneStats zone;
+	} sorted[MAX_PROFILER_FRAME_ZONES];
+	for (i32 i = 0; i < len; i++) {
+		sorted[i].start = firstStart[i];
+		sorted[i].zone = profiler.frameZones[i];
+	}
+	qsort(sorted, len, sizeof(*sorted), compare_zone_start);
+	for (i32 i = 0; i < len; i++) {
+		profiler.frameZones[i] = sorted[i].zone;
+	}
+	profiler.frameZonesLen = len;
+}
+
+i32 profiler_frame_zones(const ProfilerZoneStats **outZones) {
+	*outZones = profiler.frameZones;
+	return profiler.frameZonesLen;
+}
+
+bool profiler_export_chrome_trace(const char *path) {
+	FILE *file = fopen(path, "w");
+	if (file == nil) {
+		slogw("could not open %s for writing", path);
+		return false;
+	}
+
+	fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+	fprintf(file, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"game\"}}");
+	const i64 exported = profiler_write_trace_events(file, 0);
+	fprintf(file, "\n]}\n");
+
+	if (fclose(file) != 0) {
+		slogw("failed to write trace %s", path);
+		return false;
+	}
+	slogi("wrote %lld profiler zones to %s", (long long)exported, path);
+	return true;
+}
+
+i64 profiler_write_trace_events(FILE *file, const u64 sinceNs) {
+	i64 exported = 0;
+	pthread_mutex_lock(&profiler.lock);
+	for (i32 t = 0; t < MAX_PROFILER_THREADS; t++) {
+		const ProfilerThread *thread = &profiler.threads[t];
+		if (thread->events == nil) { continue; }
+
+		fprintf(file, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":", t);
+		profiler_write_json_string(file, thread->name);
+		fprintf(file, "}}");
+
+		const u64 written = atomic_load_explicit(&thread->written, memory_order_acquire);
+		const u64 oldest = written > PROFILER_RING_EVENTS ? written - PROFILER_RING_EVENTS : 0;
+		for (u64 i = oldest; i < written; i++) {
+			const ProfilerEvent *event = &thread->events[i % PROFILER_RING_EVENTS];
+			if (event->endNs < sinceNs) { continue; }
+
+			// complete events, microseconds since profiler_init.
+			fprintf(file, ",\n{\"name\":");
+			profiler_write_json_string(file, event->name);
+			fprintf(
+				file,
+				",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}",
+				t,
+				profiler_trace_us(event->startNs),
+				(f64)(event->endNs - event->startNs) / 1e3
+			);
+			exported++;
+		}
+	}
+	pthread_mutex_unlock(&profiler.lock);
+	return exported;
+}
+
+f64 profiler_trace_us(const u64 ns) {
+	return (f64)(ns - profiler.startNs) / 1e3;
+}
+
+void profiler_write_json_string(FILE *file, const char *str) {
+	fputc('"', file);
+	for (const char *c = str; *c != '\0'; c++) {
+		if (*c == '"' || *c == '\\') {
+			fputc('\\', file);
+		}
+		fputc(*c, file);
+	}
+	fputc('"', file);
+}
+
+u64 profiler_now_ns() {
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return ((u64)now.tv_sec * 1000000000ull) + (u64)now.tv_nsec;
+}
+
+static i32 compare_zone_start(const void *a, const void *b) {
+	const u64 startA = *(const u64 *)a;
+	const u64 startB = *(const u64 *)b;
+	return (startA > startB) - (startA < startB);
+}
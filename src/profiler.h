@@ -0,0 +1,102 @@
+//
+// Created by Hector Mejia on 10/17/26.
+//
+
+#ifndef RAYLIB_POKEMON_CLONE_PROFILER_H
+#define RAYLIB_POKEMON_CLONE_PROFILER_H
+
+#include "common.h"
+
+// Named zones of wall time, nested however the calls nest. Every thread that
+// wants its zones kept claims a slot with profiler_thread_begin, closed zones
+// go into that slot's ring buffer (the oldest get overwritten) and can be
+// exported as a Chrome trace (chrome://tracing or ui.perfetto.dev). Zones on
+// threads without a slot cost a thread local read and are dropped.
+//
+// Zone names are kept as pointers, they have to be string literals or
+// __func__. Build with -DPROFILER_DISABLED to compile every zone out.
+#define PROFILER_RING_EVENTS (1 << 16)
+#define MAX_PROFILER_THREADS 4
+#define MAX_PROFILER_DEPTH 32
+#define MAX_PROFILER_FRAME_ZONES 48
+#define MAX_PROFILER_THREAD_NAME_LEN 32
+#define PROFILER_TRACE_PATH "./profile_trace.json"
+
+// one zone name over one frame, as shown by the debug overlay.
+typedef struct ProfilerZoneStats {
+	const char *name;
+	i32 depth;
+	i32 calls;
+	f64 ms;
+} ProfilerZoneStats;
+
+// claims a slot for the calling thread, main for the thread calling it.
+void profiler_init();
+void profiler_shutdown();
+
+/**
+ * Claims a slot for the calling thread. A free slot with the same name is
+ * reused before a new one, so threads started again for the same job (one per
+ * map load) keep ending up in the same row of the trace.
+ * @param name copied, shown as the thread name in the trace
+ */
+void profiler_thread_begin(const char *name);
+// gives the slot back, its events stay until they are overwritten.
+void profiler_thread_end();
+
+void profiler_begin(const char *name);
+void profiler_end();
+
+/**
+ * Sums up the zones the calling thread closed since the last call by name,
+ * for profiler_frame_zones. Meant for the main thread, once a frame.
+ */
+void profiler_frame_end();
+
+/**
+ * The zones of the last frame in the order they opened, parents before their
+ * children.
+ * @return how many zones outZones points to
+ */
+i32 profiler_frame_zones(const ProfilerZoneStats **outZones);
+
+/**
+ * Writes every event still in the ring buffers in the Chrome trace event
+ * format. Zones being written by other threads at the same time can come out
+ * torn, export while the loader is idle for a clean trace.
+ * @return false if the file could not be written
+ */
+bool profiler_export_chrome_trace(const char *path);
+
+/**
+ * Writes the zones still in the ring buffers that ended at or after sinceNs as
+ * Chrome trace events, with a thread_name event for every slot. Each event is
+ * written with a comma in front of it, the caller opens the traceEvents array
+ * with an event of its own.
+ * @return how many zones were written
+ */
+i64 profiler_write_trace_events(FILE *file, u64 sinceNs);
+// a profiler_now_ns time as a trace timestamp, microseconds since profiler_init.
+f64 profiler_trace_us(u64 ns);
+void profiler_write_json_string(FILE *file, const char *str);
+
+// CLOCK_MONOTONIC in nanoseconds.
+u64 profiler_now_ns();
+
+void profiler_zone_cleanup(const char **name);
+
+#define PROFILER_CONCAT_(a, b) a##b
+#define PROFILER_CONCAT(a, b) PROFILER_CONCAT_(a, b)
+
+#ifdef PROFILER_DISABLED
+#define PROFILE_ZONE(name)
+#else
+// a zone that closes when the enclosing scope ends, whichever way it ends.
+#define PROFILE_ZONE(name) \
+	__attribute__((cleanup(profiler_zone_cleanup))) const char *PROFILER_CONCAT(profilerZone, __LINE__) = (name); \
+	profiler_begin(PROFILER_CONCAT(profilerZone, __LINE__))
+#endif
+
+#define PROFILE_FUNCTION() PROFILE_ZONE(__func__)
+
+#endif //RAYLIB_POKEMON_CLONE_PROFILER_H
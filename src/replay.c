@@ -0,0 +1,313 @@
+//
+// Created by Hector Mejia on 10/17/26.
+//
+
+#include "replay.h"
+
+#include <time.h>
+
+#include "input.h"
+#include "platform.h"
+#include "rng.h"
+#include "settings.h"
+
+#define REPLAY_FLAG_STATE_HASHES (1u << 0)
+
+typedef enum ReplayMode {
+	ReplayModeNone = 0,
+	ReplayModeRecording,
+	ReplayModePlaying,
+} ReplayMode;
+
+// written field by field like the frames, the struct ends in 4 bytes of
+// padding that don't belong in the file.
+typedef struct ReplayHeader {
+	char magic[4];
+	u32 version;
+	u64 seed;
+	u32 flags;
+	// the tick settings change what the same frame times do, a recording is
+	// only played back with the ones it was made with.
+	f32 simulationTickRate;
+	i32 maxTicksPerFrame;
+} ReplayHeader;
+
+// written field by field, so there is no padding in the file.
+typedef struct ReplayFrame {
+	f32 frameTime;
+	u8 keysLen;
+	u8 outcomesLen;
+	u16 keys[MAX_REPLAY_FRAME_KEYS];
+	u8 outcomes[MAX_REPLAY_FRAME_OUTCOMES / 8];
+	u64 stateHash;
+} ReplayFrame;
+
+static struct {
+	ReplayMode mode;
+	FILE *file;
+	ReplayHeader header;
+	// the frame being recorded or played.
+	ReplayFrame frame;
+	i32 outcomesRead;
+	ReplayStats stats;
+} replay = {};
+
+static void start_replay(FILE *file, ReplayMode mode, ReplayHeader header);
+static bool write_header(FILE *file, const ReplayHeader *header);
+static bool read_header(FILE *file, ReplayHeader *outHeader);
+static bool write_frame(const ReplayFrame *frame, bool stateHash);
+static bool read_frame(ReplayFrame *outFrame, bool stateHash);
+
+bool replay_record(const char *path, const bool stateHashes) {
+	rng_seed_game((u64)time(nil));
+
+	ReplayHeader header = {
+		.version = REPLAY_VERSION,
+		.seed = rng_game_seed(),
+		.flags = stateHashes ? REPLAY_FLAG_STATE_HASHES : 0,
+		.simulationTickRate = settings.simulationTickRate,
+		.maxTicksPerFrame = settings.maxTicksPerFrame,
+	};
+	memcpy(header.magic, REPLAY_MAGIC, sizeof(header.magic));
+
+	FILE *file = fopen(path, "wb");
+	if (file == nil) {
+		slogw("could not open %s for writing", path);
+		return false;
+	}
+	if (!write_header(file, &header)) {
+		slogw("failed to write replay header to %s", path);
+		fclose(file);
+		remove(path);
+		return false;
+	}
+
+	start_replay(file, ReplayModeRecording, header);
+	slogi("recording replay to %s, seed %llu", path, (unsigned long long)header.seed);
+	return true;
+}
+
+bool replay_play(const char *path) {
+	FILE *file = fopen(path, "rb");
+	if (file == nil) {
+		slogw("could not open replay %s", path);
+		return false;
+	}
+
+	ReplayHeader header = {};
+	const char *reason = nil;
+	if (!read_header(file, &header)) {
+		reason = "truncated";
+	} else if (memcmp(header.magic, REPLAY_MAGIC, sizeof(header.magic)) != 0) {
+		reason = "not a replay";
+	} else if (header.version != REPLAY_VERSION) {
+		reason = "written by another version";
+	} else if (header.simulationTickRate != settings.simulationTickRate ||
+			   header.maxTicksPerFrame != settings.maxTicksPerFrame) {
+		reason = "recorded with other tick settings";
+	}
+	if (reason != nil) {
+		slogw("can't play replay %s, %s", path, reason);
+		fclose(file);
+		return false;
+	}
+
+	start_replay(file, ReplayModePlaying, header);
+	rng_seed_game(header.seed);
+	slogi("playing replay %s, seed %llu", path, (unsigned long long)header.seed);
+	return true;
+}
+
+bool replay_is_recording() {
+	return replay.mode == ReplayModeRecording;
+}
+
+bool replay_is_playing() {
+	return replay.mode == ReplayModePlaying;
+}
+
+bool replay_begin_frame(f32 *frameTime) {
+	if (replay.mode == ReplayModeNone) { return true; }
+
+	const bool stateHashes = (replay.header.flags & REPLAY_FLAG_STATE_HASHES) != 0;
+	if (replay.mode == ReplayModePlaying) {
+		if (!read_frame(&replay.frame, stateHashes)) { return false; }
+
+		KeyboardKey keys[MAX_REPLAY_FRAME_KEYS];
+		for (i32 i = 0; i < replay.frame.keysLen; i++) {
+			keys[i] = (KeyboardKey)replay.frame.keys[i];
+		}
+		input_queue_frame(keys, replay.frame.keysLen);
+		replay.outcomesRead = 0;
+		*frameTime = replay.frame.frameTime;
+	} else {
+		replay.frame = (ReplayFrame){.frameTime = *frameTime};
+	}
+
+	platform_advance_time(*frameTime);
+	return true;
+}
+
+void replay_end_frame(const u64 stateHash) {
+	if (replay.mode == ReplayModeNone) { return; }
+
+	const bool stateHashes = (replay.header.flags & REPLAY_FLAG_STATE_HASHES) != 0;
+	if (replay.mode == ReplayModeRecording) {
+		KeyboardKey keys[MAX_REPLAY_FRAME_KEYS];
+		replay.frame.keysLen = (u8)input_keys_down(keys, MAX_REPLAY_FRAME_KEYS);
+		for (i32 i = 0; i < replay.frame.keysLen; i++) {
+			replay.frame.keys[i] = (u16)keys[i];
+		}
+		replay.frame.stateHash = stateHash;
+		if (!write_frame(&replay.frame, stateHashes)) {
+			slogw("failed to write replay frame %lld, recording stopped", (long long)replay.stats.frames);
+			replay_stop();
+			return;
+		}
+	} else {
+		panicIf(
+			replay.outcomesRead != replay.frame.outcomesLen,
+			"frame %lld asked for %d outcomes, %d were recorded",
+			(long long)replay.stats.frames,
+			replay.outcomesRead,
+			replay.frame.outcomesLen
+		);
+		if (stateHashes && stateHash != replay.frame.stateHash) {
+			if (replay.stats.divergedFrames == 0) {
+				replay.stats.firstDivergedFrame = replay.stats.frames;
+				slogw("replay diverged from the recording at frame %lld", (long long)replay.stats.frames);
+			}
+			replay.stats.divergedFrames++;
+		}
+	}
+	replay.stats.frames++;
+}
+
+bool replay_outcome(const bool live) {
+	if (replay.mode == ReplayModeNone) { return live; }
+
+	if (replay.mode == ReplayModePlaying) {
+		const i32 bit = replay.outcomesRead++;
+		panicIf(
+			bit >= replay.frame.outcomesLen,
+			"frame %lld asked for more outcomes than were recorded",
+			(long long)replay.stats.frames
+		);
+		return (replay.frame.outcomes[bit / 8] >> (bit % 8)) & 1;
+	}
+
+	const i32 bit = replay.frame.outcomesLen;
+	panicIf(bit >= MAX_REPLAY_FRAME_OUTCOMES, "more than %d replay outcomes in one frame", MAX_REPLAY_FRAME_OUTCOMES);
+	replay.frame.outcomesLen++;
+	if (live) {
+		replay.frame.outcomes[bit / 8] |= (u8)(1u << (bit % 8));
+	}
+	return live;
+}
+
+void replay_stop() {
+	if (replay.mode == ReplayModeNone) { return; }
+
+	if (replay.mode == ReplayModePlaying) {
+		slogi(
+			"replay played %lld frames, %lld diverged (first at %lld)",
+			(long long)replay.stats.frames,
+			(long long)replay.stats.divergedFrames,
+			(long long)replay.stats.firstDivergedFrame
+		);
+	} else {
+		slogi("replay recorded %lld frames", (long long)replay.stats.frames);
+	}
+	if (fclose(replay.file) != 0) {
+		slogw("failed to close replay file");
+	}
+	replay.file = nil;
+	replay.mode = ReplayModeNone;
+}
+
+ReplayStats replay_stats() {
+	return replay.stats;
+}
+
+u64 replay_hash(u64 hash, const void *data, const usize size) {
+	const byte *bytes = data;
+	for (usize i = 0; i < size; i++) {
+		hash ^= bytes[i];
+		hash *= 0x100000001b3;
+	}
+	return hash;
+}
+
+static void start_replay(FILE *file, const ReplayMode mode, const ReplayHeader header) {
+	panicIf(replay.mode != ReplayModeNone, "a replay is already open");
+
+	replay = (typeof(replay)){
+		.mode = mode,
+		.file = file,
+		.header = header,
+		.stats = {.firstDivergedFrame = -1},
+	};
+	// the timers run on the recorded frame times instead of the wall clock.
+	platform_use_manual_time();
+}
+
+static bool write_header(FILE *file, const ReplayHeader *header) {
+	bool ok = fwrite(header->magic, sizeof(header->magic), 1, file) == 1;
+	ok = ok && fwrite(&header->version, sizeof(header->version), 1, file) == 1;
+	ok = ok && fwrite(&header->seed, sizeof(header->seed), 1, file) == 1;
+	ok = ok && fwrite(&header->flags, sizeof(header->flags), 1, file) == 1;
+	ok = ok && fwrite(&header->simulationTickRate, sizeof(header->simulationTickRate), 1, file) == 1;
+	ok = ok && fwrite(&header->maxTicksPerFrame, sizeof(header->maxTicksPerFrame), 1, file) == 1;
+	return ok;
+}
+
+// false if the file ends before the header does.
+static bool read_header(FILE *file, ReplayHeader *outHeader) {
+	ReplayHeader header = {};
+	bool ok = fread(header.magic, sizeof(header.magic), 1, file) == 1;
+	ok = ok && fread(&header.version, sizeof(header.version), 1, file) == 1;
+	ok = ok && fread(&header.seed, sizeof(header.seed), 1, file) == 1;
+	ok = ok && fread(&header.flags, sizeof(header.flags), 1, file) == 1;
+	ok = ok && fread(&header.simulationTickRate, sizeof(header.simulationTickRate), 1, file) == 1;
+	ok = ok && fread(&header.maxTicksPerFrame, sizeof(header.maxTicksPerFrame), 1, file) == 1;
+	if (!ok) { return false; }
+
+	*outHeader = header;
+	return true;
+}
+
+static bool write_frame(const ReplayFrame *frame, const bool stateHash) {
+	FILE *file = replay.file;
+	bool ok = fwrite(&frame->frameTime, sizeof(frame->frameTime), 1, file) == 1;
+	ok = ok && fwrite(&frame->keysLen, sizeof(frame->keysLen), 1, file) == 1;
+	ok = ok && fwrite(&frame->outcomesLen, sizeof(frame->outcomesLen), 1, file) == 1;
+	ok = ok && (frame->keysLen == 0 || fwrite(frame->keys, sizeof(*frame->keys), frame->keysLen, file) == frame->keysLen);
+
+	const usize outcomeBytes = (frame->outcomesLen + 7) / 8;
+	ok = ok && (outcomeBytes == 0 || fwrite(frame->outcomes, 1, outcomeBytes, file) == outcomeBytes);
+	if (stateHash) {
+		ok = ok && fwrite(&frame->stateHash, sizeof(frame->stateHash), 1, file) == 1;
+	}
+	return ok;
+}
+
+// false at the end of the file, a frame cut short counts as the end too.
+static bool read_frame(ReplayFrame *outFrame, const bool stateHash) {
+	FILE *file = replay.file;
+	ReplayFrame frame = {};
+	bool ok = fread(&frame.frameTime, sizeof(frame.frameTime), 1, file) == 1;
+	ok = ok && fread(&frame.keysLen, sizeof(frame.keysLen), 1, file) == 1;
+	ok = ok && fread(&frame.outcomesLen, sizeof(frame.outcomesLen), 1, file) == 1;
+	ok = ok && frame.keysLen <= MAX_REPLAY_FRAME_KEYS && frame.outcomesLen <= MAX_REPLAY_FRAME_OUTCOMES;
+	ok = ok && (frame.keysLen == 0 || fread(frame.keys, sizeof(*frame.keys), frame.keysLen, file) == frame.keysLen);
+
+	const usize outcomeBytes = (frame.outcomesLen + 7) / 8;
+	ok = ok && (outcomeBytes == 0 || fread(frame.outcomes, 1, outcomeBytes, file) == outcomeBytes);
+	if (stateHash) {
+		ok = ok && fread(&frame.stateHash, sizeof(frame.stateHash), 1, file) == 1;
+	}
+	if (!ok) { return false; }
+
+	*outFrame = frame;
+	return true;
+}
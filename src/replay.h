@@ -0,0 +1,82 @@
+//
+// Created by Hector Mejia on 10/17/26.
+//
+
+#ifndef RAYLIB_POKEMON_CLONE_REPLAY_H
+#define RAYLIB_POKEMON_CLONE_REPLAY_H
+
+#include "common.h"
+
+// A recorded session: the seed the game rolled with, then for every frame its
+// frame time, the keys held and the outcome of anything the simulation asked
+// that depends on timing outside of it (a map finishing its background load).
+// With the same build, playing that back goes through the exact same states,
+// which is what makes replays usable as a benchmark workload. A hash of the
+// game state can be written every frame to catch where a playback drifts.
+#define REPLAY_MAGIC "RPLY"
+#define REPLAY_VERSION 2
+#define MAX_REPLAY_FRAME_KEYS 32
+// outcomes a single frame can hold, one per tick at most so far.
+#define MAX_REPLAY_FRAME_OUTCOMES 64
+
+typedef struct ReplayStats {
+	i64 frames;
+	// playback only, frames whose state hash didn't match the recording.
+	i64 divergedFrames;
+	i64 firstDivergedFrame; // -1 until a frame diverges
+} ReplayStats;
+
+/**
+ * Starts recording to a file, the game seed and the clock are reset so the
+ * recording starts from a known state. Call before game_init.
+ * @param path the file to write, replaced if it exists
+ * @param stateHashes also write the hash of the game state every frame
+ * @return false if the file could not be opened
+ */
+bool replay_record(const char *path, bool stateHashes);
+
+/**
+ * Opens a recording and seeds the game with the seed it was recorded with.
+ * Call before game_init.
+ * @return false if the file is missing or was written by another version
+ */
+bool replay_play(const char *path);
+
+bool replay_is_recording();
+bool replay_is_playing();
+
+/**
+ * Called first thing every frame. Recording keeps the frame time, playback
+ * swaps it for the recorded one and queues the recorded keys with the input
+ * module. Either way the game clock moves by the frame time.
+ * @param frameTime the frame time, replaced when playing back
+ * @return false once a playback runs out of frames
+ */
+bool replay_begin_frame(f32 *frameTime);
+
+/**
+ * Called after the frame was updated. Recording writes the frame out,
+ * playback checks the hash against the recorded one when there is one.
+ * @param stateHash the hash of the game state after the update
+ */
+void replay_end_frame(u64 stateHash);
+
+/**
+ * For questions whose answer depends on timing the replay can't reproduce.
+ * Recording keeps the live answer and returns it, playback returns the answer
+ * that was recorded, and the caller has to make it true (wait for the load).
+ */
+bool replay_outcome(bool live);
+
+// flushes and closes the file, prints the playback stats.
+void replay_stop();
+ReplayStats replay_stats();
+
+/**
+ * FNV-1a, for building the state hash a piece at a time.
+ * @param hash REPLAY_HASH_START or what the previous call returned
+ */
+#define REPLAY_HASH_START 0xcbf29ce484222325
+u64 replay_hash(u64 hash, const void *data, usize size);
+
+#endif //RAYLIB_POKEMON_CLONE_REPLAY_H
@@ -0,0 +1,54 @@
+//
+// Created by Hector Mejia on 10/17/26.
+//
+
+#include "rng.h"
+
+#define PCG_MULTIPLIER 6364136223846793005ULL
+
+static u64 gameSeed = 0;
+static Rng gameRng = {};
+
+Rng rng_new(const u64 seed, const u64 stream) {
+	// same seeding as the reference pcg32_srandom_r.
+	Rng rng = {.state = 0, .increment = (stream << 1u) | 1u};
+	rng_next(&rng);
+	rng.state += seed;
+	rng_next(&rng);
+	return rng;
+}
+
+u32 rng_next(Rng *rng) {
+	const u64 old = rng->state;
+	rng->state = (old * PCG_MULTIPLIER) + rng->increment;
+	const u32 xorShifted = (u32)(((old >> 18u) ^ old) >> 27u);
+	const u32 rotation = (u32)(old >> 59u);
+	return (xorShifted >> rotation) | (xorShifted << ((-rotation) & 31));
+}
+
+i32 rng_range(Rng *rng, const i32 min, const i32 max) {
+	panicIf(max < min, "invalid random range [%d, %d]", min, max);
+
+	// Lemire's multiply and shift, the bias is at most range / 2^32 which is
+	// nothing for the ranges the game asks for.
+	const u64 range = (u64)((i64)max - (i64)min) + 1;
+	return (i32)((i64)min + (i64)(((u64)rng_next(rng) * range) >> 32));
+}
+
+f32 rng_float(Rng *rng) {
+	// the top 24 bits, all a float can hold without rounding up to 1.
+	return (f32)(rng_next(rng) >> 8) * (1.f / (f32)(1 << 24));
+}
+
+void rng_seed_game(const u64 seed) {
+	gameSeed = seed;
+	gameRng = rng_new(seed, 0);
+}
+
+u64 rng_game_seed() {
+	return gameSeed;
+}
+
+Rng *rng_game() {
+	return &gameRng;
+}
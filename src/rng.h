@@ -0,0 +1,36 @@
+//
+// Created by Hector Mejia on 10/17/26.
+//
+
+#ifndef RAYLIB_POKEMON_CLONE_RNG_H
+#define RAYLIB_POKEMON_CLONE_RNG_H
+
+#include "common.h"
+
+// PCG32, small and fast, and unlike rand() its sequence only depends on the
+// seed, so replays roll the same numbers on every platform. Streams with the
+// same seed but a different stream id don't overlap.
+typedef struct Rng {
+	u64 state;
+	u64 increment;
+} Rng;
+
+Rng rng_new(u64 seed, u64 stream);
+u32 rng_next(Rng *rng);
+/**
+ * Uniform in [min, max], both included like GetRandomValue.
+ */
+i32 rng_range(Rng *rng, i32 min, i32 max);
+// uniform in [0, 1).
+f32 rng_float(Rng *rng);
+
+/**
+ * Reseeds the generator the game rolls everything on, main thread only. Work
+ * on other threads (maps loading in the background) uses a stream of its own
+ * made from rng_game_seed, so when it runs doesn't change the game's rolls.
+ */
+void rng_seed_game(u64 seed);
+u64 rng_game_seed();
+Rng *rng_game();
+
+#endif //RAYLIB_POKEMON_CLONE_RNG_H
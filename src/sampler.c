@@ -0,0 +1,448 @@
+//
+// Created by Hector Mejia on 10/17/26.
+//
+
+// REG_RIP, dladdr and pthread_getattr_np.
+#define _GNU_SOURCE
+#include "sampler.h"
+
+#ifdef __linux__
+
+#include <dlfcn.h>
+#include <elf.h>
+#include <fcntl.h>
+#include <link.h>
+#include <pthread.h>
+#include <sched.h>
+#include <signal.h>
+#include <stdatomic.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <ucontext.h>
+#include <unistd.h>
+
+#include "array/array.h"
+#include "memory/memory.h"
+
+// set in the first word of a sample once its frames are in.
+#define SAMPLE_COMMITTED (1ull << 63)
+
+// a sample is a word with its depth followed by its frames, leaf first. The
+// handler reserves the words, fills in the frames and writes the depth word
+// last, with SAMPLE_COMMITTED, so the reader never takes a half written one.
+typedef struct SamplerState {
+	atomic_bool running;
+	// handlers between their first and last look at the buffer, it is only
+	// freed once there are none.
+	atomic_int inFlight;
+	atomic_ullong *buffer; // SAMPLER_BUFFER_WORDS, zeroed
+	atomic_ullong used;
+	atomic_ullong samples;
+	atomic_ullong dropped;
+	// the stack of the thread that started the sampler, frame pointers are
+	// only followed inside it so a bad one can't fault the handler.
+	uintptr_t stackLow;
+	uintptr_t stackHigh;
+	bool handlerInstalled;
+	struct sigaction previousAction;
+} SamplerState;
+
+typedef struct ElfSymbol {
+	uintptr_t start;
+	uintptr_t end;
+	const char *name;
+} ElfSymbol;
+
+// the executable's own symbols, dladdr only knows the exported ones and most
+// of the game is static functions.
+typedef struct SymbolTable {
+	ElfSymbol *symbols;
+	void *file;
+	usize fileSize;
+	uintptr_t base;
+} SymbolTable;
+
+static SamplerState sampler = {};
+
+static void handle_sigprof(i32 sig, siginfo_t *info, void *context);
+static void take_sample(void *context);
+static bool context_registers(const ucontext_t *context, uintptr_t *outPc, uintptr_t *outFp, uintptr_t *outSp);
+static bool current_stack_bounds(uintptr_t *outLow, uintptr_t *outHigh);
+static SymbolTable load_symbol_table();
+static void free_symbol_table(SymbolTable *table);
+static const char *symbol_name(const SymbolTable *table, uintptr_t address, char *scratch, usize scratchSize);
+static i32 compare_symbols(const void *a, const void *b);
+static i32 compare_lines(const void *a, const void *b);
+static i32 executable_base(struct dl_phdr_info *info, size_t size, void *data);
+
+bool sampler_start(const i32 hz) {
+	panicIf(hz <= 0 || hz > 10000, "invalid sampling rate %d", hz);
+	if (atomic_load(&sampler.running)) { return true; }
+
+	uintptr_t stackLow = 0;
+	uintptr_t stackHigh = 0;
+	if (!current_stack_bounds(&stackLow, &stackHigh)) {
+		slogw("could not find the stack bounds, not sampling");
+		return false;
+	}
+	if (sampler.buffer == nil) {
+		// mallocate zeroes it, nothing is committed yet.
+		sampler.buffer = mallocate(sizeof(*sampler.buffer) * SAMPLER_BUFFER_WORDS, MemoryTagGame);
+		panicIfNil(sampler.buffer, "failed to alloc the sample buffer");
+	}
+	sampler.stackLow = stackLow;
+	sampler.stackHigh = stackHigh;
+	atomic_store(&sampler.used, 0);
+	atomic_store(&sampler.samples, 0);
+	atomic_store(&sampler.dropped, 0);
+
+	// the handler stays installed after a stop, see sampler_stop.
+	if (!sampler.handlerInstalled) {
+		struct sigaction action = {};
+		action.sa_sigaction = handle_sigprof;
+		action.sa_flags = SA_SIGINFO | SA_RESTART;
+		sigemptyset(&action.sa_mask);
+		if (sigaction(SIGPROF, &action, &sampler.previousAction) != 0) {
+			slogw("could not install the SIGPROF handler");
+			return false;
+		}
+		sampler.handlerInstalled = true;
+	}
+
+	atomic_store(&sampler.running, true);
+	const i64 intervalUs = 1000000 / hz;
+	const struct itimerval timer = {
+		.it_interval = {.tv_sec = intervalUs / 1000000, .tv_usec = intervalUs % 1000000},
+		.it_value = {.tv_sec = intervalUs / 1000000, .tv_usec = intervalUs % 1000000},
+	};
+	if (setitimer(ITIMER_PROF, &timer, nil) != 0) {
+		slogw("could not start the profiling timer");
+		atomic_store(&sampler.running, false);
+		return false;
+	}
+	slogi("sampling at %d Hz", hz);
+	return true;
+}
+
+bool sampler_running() {
+	return atomic_load(&sampler.running);
+}
+
+bool sampler_stop(const char *path) {
+	if (!atomic_load(&sampler.running)) { return false; }
+
+	const struct itimerval off = {};
+	setitimer(ITIMER_PROF, &off, nil);
+	atomic_store(&sampler.running, false);
+
+	// handlers that start from now on see running is off and leave the buffer
+	// alone, the ones already past that check are waited for. This thread
+	// can't be interrupted by one while it waits. The handler is left
+	// installed, a signal still on its way would find the default action,
+	// which ends the process.
+	sigset_t profSignal;
+	sigset_t previousMask;
+	sigemptyset(&profSignal);
+	sigaddset(&profSignal, SIGPROF);
+	pthread_sigmask(SIG_BLOCK, &profSignal, &previousMask);
+	while (atomic_load(&sampler.inFlight) > 0) {
+		sched_yield();
+	}
+	pthread_sigmask(SIG_SETMASK, &previousMask, nil);
+
+	SymbolTable symbols = load_symbol_table();
+	char **stacks = nil;
+	const u64 used = atomic_load(&sampler.used);
+	u64 frames[MAX_SAMPLER_DEPTH];
+	for (u64 i = 0; i < used;) {
+		const u64 header = atomic_load_explicit(&sampler.buffer[i], memory_order_acquire);
+		// reserved but never written, nothing after it can be trusted.
+		if ((header & SAMPLE_COMMITTED) == 0) { break; }
+
+		const u64 depth = header & ~SAMPLE_COMMITTED;
+		for (u64 f = 0; f < depth; f++) {
+			frames[f] = atomic_load_explicit(&sampler.buffer[i + 1 + f], memory_order_relaxed);
+		}
+		i += depth + 1;
+
+		// folded stacks go from the root down to the leaf.
+		char line[MAX_SAMPLER_DEPTH * 64] = {};
+		usize len = 0;
+		for (i64 f = (i64)depth - 1; f >= 0 && len < sizeof(line); f--) {
+			// return addresses point after the call, the call is one back.
+			const uintptr_t address = f == 0 ? frames[f] : frames[f] - 1;
+			char scratch[64];
+			const char *name = symbol_name(&symbols, address, scratch, sizeof(scratch));
+			len += snprintf(line + len, sizeof(line) - len, "%s%s", len > 0 ? ";" : "", name);
+		}
+		array_push(stacks, strdup(line));
+	}
+	free_symbol_table(&symbols);
+
+	const i32 stacksLen = array_length(stacks);
+	if (stacksLen > 0) {
+		qsort(stacks, stacksLen, sizeof(*stacks), compare_lines);
+	}
+
+	bool ok = false;
+	FILE *file = fopen(path, "w");
+	if (file == nil) {
+		slogw("could not open %s for writing", path);
+	} else {
+		i32 unique = 0;
+		for (i32 i = 0; i < stacksLen;) {
+			i32 j = i;
+			while (j < stacksLen && strcmp(stacks[j], stacks[i]) == 0) {
+				j++;
+			}
+			fprintf(file, "%s %d\n", stacks[i], j - i);
+			unique++;
+			i = j;
+		}
+		ok = fclose(file) == 0;
+		slogi(
+			"wrote %llu samples (%d unique stacks, %llu dropped) to %s",
+			(unsigned long long)atomic_load(&sampler.samples),
+			unique,
+			(unsigned long long)atomic_load(&sampler.dropped),
+			path
+		);
+	}
+
+	array_range(stacks, i) {
+		free(stacks[i]);
+	}
+	if (stacks != nil) { array_free(stacks); }
+	mfree(sampler.buffer, sizeof(*sampler.buffer) * SAMPLER_BUFFER_WORDS, MemoryTagGame);
+	sampler.buffer = nil;
+	return ok;
+}
+
+// only async signal safe work in here: reads of the interrupted stack and
+// atomics on a buffer that is already there.
+static void handle_sigprof(const i32 sig, siginfo_t *info, void *context) {
+	(void)sig;
+	(void)info;
+	// counted before running is checked, sampler_stop turns running off
+	// before it reads the count, so one of the two sees the other.
+	atomic_fetch_add(&sampler.inFlight, 1);
+	if (atomic_load(&sampler.running)) {
+		take_sample(context);
+	}
+	atomic_fetch_sub(&sampler.inFlight, 1);
+}
+
+static void take_sample(void *context) {
+	uintptr_t pc = 0;
+	uintptr_t fp = 0;
+	uintptr_t sp = 0;
+	if (!context_registers(context, &pc, &fp, &sp)) { return; }
+
+	u64 frames[MAX_SAMPLER_DEPTH];
+	i32 depth = 0;
+	frames[depth++] = pc;
+
+	// frame pointer chains: [fp] is the caller's fp and [fp + 8] the return
+	// address. Each one has to be further up the same stack than the last.
+	const bool onOurStack = sp >= sampler.stackLow && sp < sampler.stackHigh;
+	while (onOurStack && depth < MAX_SAMPLER_DEPTH &&
+		   fp >= sp && fp + (2 * sizeof(uintptr_t)) <= sampler.stackHigh &&
+		   fp % sizeof(uintptr_t) == 0) {
+		const uintptr_t *frame = (const uintptr_t *)fp;
+		const uintptr_t returnAddress = frame[1];
+		if (returnAddress == 0) { break; }
+		frames[depth++] = returnAddress;
+
+		const uintptr_t next = frame[0];
+		if (next <= fp) { break; }
+		fp = next;
+	}
+
+	// a sample lands on whichever thread was running, two handlers can race
+	// for the same words.
+	u64 start = atomic_load_explicit(&sampler.used, memory_order_relaxed);
+	do {
+		if (start + depth + 1 > SAMPLER_BUFFER_WORDS) {
+			atomic_fetch_add_explicit(&sampler.dropped, 1, memory_order_relaxed);
+			return;
+		}
+	} while (!atomic_compare_exchange_weak_explicit(
+		&sampler.used,
+		&start,
+		start + depth + 1,
+		memory_order_relaxed,
+		memory_order_relaxed
+	));
+	for (i32 f = 0; f < depth; f++) {
+		atomic_store_explicit(&sampler.buffer[start + 1 + f], frames[f], memory_order_relaxed);
+	}
+	atomic_store_explicit(&sampler.buffer[start], (u64)depth | SAMPLE_COMMITTED, memory_order_release);
+	atomic_fetch_add_explicit(&sampler.samples, 1, memory_order_relaxed);
+}
+
+static bool context_registers(const ucontext_t *context, uintptr_t *outPc, uintptr_t *outFp, uintptr_t *outSp) {
+#if defined(__x86_64__)
+	*outPc = (uintptr_t)context->uc_mcontext.gregs[REG_RIP];
+	*outFp = (uintptr_t)context->uc_mcontext.gregs[REG_RBP];
+	*outSp = (uintptr_t)context->uc_mcontext.gregs[REG_RSP];
+	return true;
+#elif defined(__aarch64__)
+	*outPc = (uintptr_t)context->uc_mcontext.pc;
+	*outFp = (uintptr_t)context->uc_mcontext.regs[29];
+	*outSp = (uintptr_t)context->uc_mcontext.sp;
+	return true;
+#else
+	(void)context;
+	(void)outPc;
+	(void)outFp;
+	(void)outSp;
+	return false;
+#endif
+}
+
+static bool current_stack_bounds(uintptr_t *outLow, uintptr_t *outHigh) {
+	pthread_attr_t attr;
+	if (pthread_getattr_np(pthread_self(), &attr) != 0) { return false; }
+
+	void *low = nil;
+	usize size = 0;
+	const bool ok = pthread_attr_getstack(&attr, &low, &size) == 0;
+	pthread_attr_destroy(&attr);
+	if (!ok) { return false; }
+
+	*outLow = (uintptr_t)low;
+	*outHigh = (uintptr_t)low + size;
+	return true;
+}
+
+// reads the .symtab of /proc/self/exe, the build keeps it (-g3). Stripped
+// binaries fall back to dladdr for everything.
+static SymbolTable load_symbol_table() {
+	SymbolTable table = {};
+	dl_iterate_phdr(executable_base, &table.base);
+
+	const i32 fd = open("/proc/self/exe", O_RDONLY);
+	if (fd < 0) { return table; }
+	struct stat fileStat;
+	if (fstat(fd, &fileStat) != 0 || (usize)fileStat.st_size < sizeof(Elf64_Ehdr)) {
+		close(fd);
+		return table;
+	}
+	void *data = mmap(nil, fileStat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (data == MAP_FAILED) { return table; }
+	table.file = data;
+	table.fileSize = fileStat.st_size;
+
+	const byte *bytes = data;
+	const Elf64_Ehdr *header = data;
+	if (memcmp(header->e_ident, ELFMAG, SELFMAG) != 0 || header->e_ident[EI_CLASS] != ELFCLASS64 ||
+		header->e_shoff + ((u64)header->e_shnum * sizeof(Elf64_Shdr)) > table.fileSize) {
+		return table;
+	}
+
+	const Elf64_Shdr *sections = (const Elf64_Shdr *)(bytes + header->e_shoff);
+	for (i32 s = 0; s < header->e_shnum; s++) {
+		if (sections[s].sh_type != SHT_SYMTAB || sections[s].sh_link >= header->e_shnum) { continue; }
+
+		const Elf64_Shdr *strings = &sections[sections[s].sh_link];
+		if (sections[s].sh_offset + sections[s].sh_size > table.fileSize ||
+			strings->sh_offset + strings->sh_size > table.fileSize) {
+			continue;
+		}
+		const Elf64_Sym *symbols = (const Elf64_Sym *)(bytes + sections[s].sh_offset);
+		const usize symbolsLen = sections[s].sh_size / sizeof(Elf64_Sym);
+		for (usize i = 0; i < symbolsLen; i++) {
+			const Elf64_Sym *symbol = &symbols[i];
+			if (ELF64_ST_TYPE(symbol->st_info) != STT_FUNC || symbol->st_value == 0 ||
+				symbol->st_name >= strings->sh_size) {
+				continue;
+			}
+			array_push(table.symbols, ((ElfSymbol){
+				.start = table.base + symbol->st_value,
+				.end = table.base + symbol->st_value + max(symbol->st_size, (u64)1),
+				.name = (const char *)(bytes + strings->sh_offset + symbol->st_name),
+			}));
+		}
+	}
+
+	if (table.symbols != nil) {
+		qsort(table.symbols, array_length(table.symbols), sizeof(*table.symbols), compare_symbols);
+	}
+	return table;
+}
+
+static void free_symbol_table(SymbolTable *table) {
+	if (table->symbols != nil) { array_free(table->symbols); }
+	if (table->file != nil) { munmap(table->file, table->fileSize); }
+	*table = (SymbolTable){};
+}
+
+static const char *symbol_name(const SymbolTable *table, const uintptr_t address, char *scratch, const usize scratchSize) {
+	// the last symbol starting at or before the address.
+	i32 low = 0;
+	i32 high = array_length(table->symbols) - 1;
+	const ElfSymbol *found = nil;
+	while (low <= high) {
+		const i32 mid = low + ((high - low) / 2);
+		if (table->symbols[mid].start <= address) {
+			found = &table->symbols[mid];
+			low = mid + 1;
+		} else {
+			high = mid - 1;
+		}
+	}
+	if (found != nil && address < found->end) {
+		return found->name;
+	}
+
+	Dl_info info;
+	if (dladdr((void *)address, &info) != 0) {
+		if (info.dli_sname != nil) {
+			return info.dli_sname;
+		}
+		if (info.dli_fname != nil) {
+			const char *slash = strrchr(info.dli_fname, '/');
+			snprintf(scratch, scratchSize, "[%s]", slash != nil ? slash + 1 : info.dli_fname);
+			return scratch;
+		}
+	}
+	return "[unknown]";
+}
+
+static i32 executable_base(struct dl_phdr_info *info, const size_t size, void *data) {
+	(void)size;
+	// the executable comes first, with an empty name.
+	*(uintptr_t *)data = (uintptr_t)info->dlpi_addr;
+	return 1;
+}
+
+static i32 compare_symbols(const void *a, const void *b) {
+	const uintptr_t startA = ((const ElfSymbol *)a)->start;
+	const uintptr_t startB = ((const ElfSymbol *)b)->start;
+	return (startA > startB) - (startA < startB);
+}
+
+static i32 compare_lines(const void *a, const void *b) {
+	return strcmp(*(char *const *)a, *(char *const *)b);
+}
+
+#else
+
+bool sampler_start(const i32 hz) {
+	(void)hz;
+	slogw("the sampling profiler is only supported on linux");
+	return false;
+}
+
+bool sampler_running() {
+	return false;
+}
+
+bool sampler_stop(const char *path) {
+	(void)path;
+	return false;
+}
+
+#endif
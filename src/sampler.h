@@ -0,0 +1,41 @@
+//
+// Created by Hector Mejia on 10/17/26.
+//
+
+#ifndef RAYLIB_POKEMON_CLONE_SAMPLER_H
+#define RAYLIB_POKEMON_CLONE_SAMPLER_H
+
+#include "common.h"
+
+// A sampling profiler for the whole process, for flamegraphs of a play
+// session without perf on the machine. SIGPROF fires every 1/hz seconds of
+// CPU time, the handler walks the frame pointers of the interrupted thread
+// into a buffer allocated up front, and stopping symbolises the stacks and
+// writes them folded, one "root;...;leaf count" line per unique stack, ready
+// for flamegraph.pl or speedscope.
+//
+// Linux only. Stacks are only walked on the thread that started the sampler,
+// samples landing on other threads keep just the function they were in.
+// Functions built without frame pointers (libc, raylib) cut their stacks short.
+// The kernel rounds the interval up to its own tick, so past a few hundred Hz
+// asking for more doesn't get more samples.
+#define SAMPLER_DEFAULT_HZ 997 // not a multiple of the frame rate
+#define MAX_SAMPLER_DEPTH 64
+#define SAMPLER_BUFFER_WORDS (1 << 21)
+#define SAMPLER_FOLDED_PATH "./profile_samples.folded"
+
+/**
+ * Starts sampling, does nothing if it is already running.
+ * @param hz samples per second of CPU time
+ * @return false if sampling isn't supported or the timer could not be set
+ */
+bool sampler_start(i32 hz);
+bool sampler_running();
+
+/**
+ * Stops sampling and writes what it got as folded stacks.
+ * @return false if it wasn't running or the file could not be written
+ */
+bool sampler_stop(const char *path);
+
+#endif //RAYLIB_POKEMON_CLONE_SAMPLER_H
@@ -18,4 +18,12 @@ GameSettings settings = {
 	.monsterBattleRemoveHighlightIntervalSecs = 0.3f,
 	.globalCatchRate = 0.5f,
 	.monsterCatchFailedTimerIntervalSecs = 1.f,
+	.bakeTerrainChunks = true,
+	.mapUploadBudgetSecs = 0.004,
+	.mapCacheBudgetBytes = 128 * 1024 * 1024,
+	.mapPrefetchDistanceTiles = 4,
+	.exactLineOfSight = false,
+	.simulationTickRate = 60,
+	.maxTicksPerFrame = 5,
+	.frameBudgetMs = 0,
 };
@@ -21,6 +21,21 @@ typedef struct GameSettings {
 	f32 monsterBattleRemoveHighlightIntervalSecs;
 	f32 globalCatchRate;
 	f32 monsterCatchFailedTimerIntervalSecs;
+	bool bakeTerrainChunks;
+	f64 mapUploadBudgetSecs;
+	usize mapCacheBudgetBytes;
+	f32 mapPrefetchDistanceTiles;
+	// npcs check line of sight against every collision box instead of the
+	// tile occupancy grid.
+	bool exactLineOfSight;
+	// the game simulates in fixed steps of 1/simulationTickRate seconds, however
+	// fast it draws. After a long frame it runs at most maxTicksPerFrame steps
+	// and lets the rest of the time go.
+	f32 simulationTickRate;
+	i32 maxTicksPerFrame;
+	// frames longer than this get their trailing frames written out by the
+	// watchdog, 0 turns it off.
+	f32 frameBudgetMs;
 } GameSettings;
 
 extern GameSettings settings;
@@ -0,0 +1,148 @@
+//
+// Created by Hector Mejia on 10/17/26.
+//
+
+#include "spatial_grid.h"
+
+#include <math.h>
+
+#include "array/array.h"
+#include "memory/memory.h"
+
+static i32 compare_indices(const void *a, const void *b);
+static i32 cell_coord(f32 position, f32 cellSize, i32 cellsLen);
+
+SpatialGrid spatial_grid_new(const f32 worldWidth, const f32 worldHeight, const f32 cellSize) {
+	panicIf(cellSize <= 0, "spatial grid cell size must be positive");
+
+	SpatialGrid grid = {
+		.cellSize = cellSize,
+		.columns = max((i32)ceilf(worldWidth / cellSize), 1),
+		.rows = max((i32)ceilf(worldHeight / cellSize), 1),
+	};
+	const u64 cellsSize = sizeof(*grid.cells) * grid.columns * grid.rows;
+	grid.cells = mallocate(cellsSize, MemoryTagMap);
+	panicIfNil(grid.cells, "failed to alloc spatial grid cells");
+	return grid;
+}
+
+void spatial_grid_free(SpatialGrid *grid) {
+	if (grid->cells == nil) { return; }
+
+	const i32 cellsLen = spatial_grid_cell_count(grid);
+	for (i32 i = 0; i < cellsLen; i++) {
+		if (grid->cells[i] != nil) {
+			array_free(grid->cells[i]);
+		}
+	}
+	mfree(grid->cells, sizeof(*grid->cells) * cellsLen, MemoryTagMap);
+	*grid = (SpatialGrid){};
+}
+
+void spatial_grid_insert(SpatialGrid *grid, const i32 item, const Rectangle bounds) {
+	const i32 col = cell_coord(bounds.x, grid->cellSize, grid->columns);
+	const i32 row = cell_coord(bounds.y, grid->cellSize, grid->rows);
+	array_push(grid->cells[(row * grid->columns) + col], item);
+
+	grid->maxItemSize.x = max(grid->maxItemSize.x, bounds.width);
+	grid->maxItemSize.y = max(grid->maxItemSize.y, bounds.height);
+}
+
+void spatial_grid_insert_spanning(SpatialGrid *grid, const i32 item, const Rectangle bounds) {
+	const i32 firstCol = cell_coord(bounds.x, grid->cellSize, grid->columns);
+	const i32 firstRow = cell_coord(bounds.y, grid->cellSize, grid->rows);
+	const i32 lastCol = cell_coord(bounds.x + bounds.width, grid->cellSize, grid->columns);
+	const i32 lastRow = cell_coord(bounds.y + bounds.height, grid->cellSize, grid->rows);
+	for (i32 row = firstRow; row <= lastRow; row++) {
+		for (i32 col = firstCol; col <= lastCol; col++) {
+			array_push(grid->cells[(row * grid->columns) + col], item);
+		}
+	}
+}
+
+void spatial_grid_move(SpatialGrid *grid, const i32 item, const Rectangle oldBounds, const Rectangle newBounds) {
+	grid->maxItemSize.x = max(grid->maxItemSize.x, newBounds.width);
+	grid->maxItemSize.y = max(grid->maxItemSize.y, newBounds.height);
+
+	const i32 oldCell = (cell_coord(oldBounds.y, grid->cellSize, grid->rows) * grid->columns) +
+						cell_coord(oldBounds.x, grid->cellSize, grid->columns);
+	const i32 newCell = (cell_coord(newBounds.y, grid->cellSize, grid->rows) * grid->columns) +
+						cell_coord(newBounds.x, grid->cellSize, grid->columns);
+	if (oldCell == newCell) { return; }
+
+	i32 *cell = grid->cells[oldCell];
+	array_range(cell, i) {
+		if (cell[i] == item) {
+			array_remove(cell, i, sizeof(*cell));
+			break;
+		}
+	}
+	array_push(grid->cells[newCell], item);
+}
+
+i32 spatial_grid_query(const SpatialGrid *grid, const Rectangle area, i32 **outItems) {
+	if (grid->cells == nil) { return 0; }
+
+	// anything starting up to maxItemSize before the area can still overlap it.
+	const i32 firstCol = cell_coord(area.x - grid->maxItemSize.x, grid->cellSize, grid->columns);
+	const i32 firstRow = cell_coord(area.y - grid->maxItemSize.y, grid->cellSize, grid->rows);
+	const i32 lastCol = cell_coord(area.x + area.width, grid->cellSize, grid->columns);
+	const i32 lastRow = cell_coord(area.y + area.height, grid->cellSize, grid->rows);
+
+	const i32 firstItem = array_length(*outItems);
+	i32 cellsVisited = 0;
+	for (i32 row = firstRow; row <= lastRow; row++) {
+		for (i32 col = firstCol; col <= lastCol; col++) {
+			const i32 *cell = grid->cells[(row * grid->columns) + col];
+			cellsVisited++;
+			array_range(cell, i) {
+				array_push(*outItems, cell[i]);
+			}
+		}
+	}
+
+	const i32 itemsFound = array_length(*outItems) - firstItem;
+	if (itemsFound > 1) {
+		qsort(*outItems + firstItem, itemsFound, sizeof(**outItems), compare_indices);
+
+		// spanning items show up once per cell they are in.
+		i32 *items = *outItems + firstItem;
+		i32 unique = 1;
+		for (i32 i = 1; i < itemsFound; i++) {
+			if (items[i] != items[unique - 1]) {
+				items[unique++] = items[i];
+			}
+		}
+		array_truncate(*outItems, firstItem + unique);
+	}
+	return cellsVisited;
+}
+
+i32 spatial_grid_cell_count(const SpatialGrid *grid) {
+	return grid->columns * grid->rows;
+}
+
+void spatial_grid_freeze(SpatialGrid *grid, Arena *arena) {
+	if (grid->cells == nil) { return; }
+
+	const i32 cellsLen = spatial_grid_cell_count(grid);
+	i32 **cells = arena_alloc(arena, sizeof(*cells) * cellsLen);
+	for (i32 i = 0; i < cellsLen; i++) {
+		cells[i] = array_freeze(grid->cells[i], arena);
+	}
+	mfree(grid->cells, sizeof(*grid->cells) * cellsLen, MemoryTagMap);
+	grid->cells = cells;
+}
+
+// anything outside the map (some objects hang off the edges) goes into the
+// border cells.
+static i32 cell_coord(const f32 position, const f32 cellSize, const i32 cellsLen) {
+	const i32 coord = (i32)floorf(position / cellSize);
+	return min(max(coord, 0), cellsLen - 1);
+}
+
+static i32 compare_indices(const void *a, const void *b) {
+	const i32 indexA = *(const i32 *)a;
+	const i32 indexB = *(const i32 *)b;
+	return (indexA > indexB) - (indexA < indexB);
+}
@@ -0,0 +1,71 @@
+//
+// Created by Hector Mejia on 10/17/26.
+//
+
+#ifndef RAYLIB_POKEMON_CLONE_SPATIAL_GRID_H
+#define RAYLIB_POKEMON_CLONE_SPATIAL_GRID_H
+
+#include "raylib.h"
+#include "common.h"
+#include "memory/arena.h"
+
+// 8x8 tiles per chunk, small enough that a screen only touches a couple dozen
+// of them, big enough that most sprites fall inside a single one.
+#define MAP_CHUNK_SIZE (TILE_SIZE * 8)
+
+// Fixed size buckets laid over the map. Each bucket holds the indices of the
+// items whose top left corner falls inside of it, so callers keep their items
+// in whatever list (and order) they already had, the grid only answers "which
+// of those can be near this area".
+typedef struct SpatialGrid {
+	f32 cellSize;
+	i32 columns;
+	i32 rows;
+	// the largest item inserted so far. Items are bucketed by their top left
+	// corner, so queries grow by this much to catch items that start in a
+	// neighbour bucket but still reach into the area.
+	Vector2 maxItemSize;
+	i32 **cells; // columns * rows dynamic arrays (array.h) of item indices
+} SpatialGrid;
+
+SpatialGrid spatial_grid_new(f32 worldWidth, f32 worldHeight, f32 cellSize);
+void spatial_grid_free(SpatialGrid *grid);
+void spatial_grid_insert(SpatialGrid *grid, i32 item, Rectangle bounds);
+
+/**
+ * Puts the item in every cell its bounds overlap instead of only the one with
+ * its top left corner. Meant for big items (a collision box running along a
+ * whole cliff) that would otherwise grow every query by their size.
+ */
+void spatial_grid_insert_spanning(SpatialGrid *grid, i32 item, Rectangle bounds);
+
+/**
+ * Moves an item inserted with spatial_grid_insert to the cell its new bounds
+ * start in, if it crossed into another one. Not for frozen grids.
+ * @param grid the grid the item is in
+ * @param item the item index it was inserted with
+ * @param oldBounds the bounds it was inserted or last moved with
+ * @param newBounds where it is now
+ */
+void spatial_grid_move(SpatialGrid *grid, i32 item, Rectangle oldBounds, Rectangle newBounds);
+
+/**
+ * Appends to outItems (a dynamic array) the indices of every item bucketed in
+ * the cells overlapping the given area. The appended indices are sorted and
+ * unique, so if items were inserted using their position on a sorted list, the
+ * result keeps that same order.
+ * @param grid the grid to query
+ * @param area the area to look into, in world coordinates
+ * @param outItems dynamic array the indices are pushed into
+ * @return the number of cells visited
+ */
+i32 spatial_grid_query(const SpatialGrid *grid, Rectangle area, i32 **outItems);
+i32 spatial_grid_cell_count(const SpatialGrid *grid);
+
+/**
+ * Moves the cells into an arena once every item is in. The grid can still be
+ * queried, but not inserted into or freed, it goes when the arena goes.
+ */
+void spatial_grid_freeze(SpatialGrid *grid, Arena *arena);
+
+#endif //RAYLIB_POKEMON_CLONE_SPATIAL_GRID_H
@@ -3,14 +3,62 @@
 //
 
 #include <math.h>
+#include <pthread.h>
+#include <stdatomic.h>
 #include "sprites.h"
 
-void animated_textures_sprite_update(AnimatedTexturesSprite *sprite, f32 dt) {
-	sprite->frameTimer += sprite->animationSpeed * dt;
-	sprite->currentFrame = (i32)fmodf(sprite->frameTimer, (f32)sprite->framesLen);
+typedef struct AnimationClock {
+	f32 speed;
+	i32 framesLen;
+	f32 timer; // wrapped to framesLen, so it never loses precision
+	i32 currentFrame;
+} AnimationClock;
+
+// clocks are only ever added, the length is published after the clock is
+// filled so the main thread never sees a half made one.
+static AnimationClock clocks[MAX_ANIMATION_CLOCKS] = {};
+static atomic_int clocksLen = 0;
+static pthread_mutex_t clocksLock = PTHREAD_MUTEX_INITIALIZER;
+
+AnimationClockID animation_clock_for(const f32 speed, const i32 framesLen) {
+	panicIf(framesLen <= 0, "animation clock needs at least one frame");
+
+	pthread_mutex_lock(&clocksLock);
+	const i32 len = atomic_load(&clocksLen);
+	for (i32 i = 0; i < len; i++) {
+		if (clocks[i].speed == speed && clocks[i].framesLen == framesLen) {
+			pthread_mutex_unlock(&clocksLock);
+			return i + 1;
+		}
+	}
+	panicIf(len == MAX_ANIMATION_CLOCKS, "ran out of animation clocks");
+
+	clocks[len] = (AnimationClock){
+		.speed = speed,
+		.framesLen = framesLen,
+	};
+	atomic_store(&clocksLen, len + 1);
+	pthread_mutex_unlock(&clocksLock);
+	return len + 1;
+}
+
+void animation_clocks_update(const f32 dt) {
+	const i32 len = atomic_load(&clocksLen);
+	for (i32 i = 0; i < len; i++) {
+		AnimationClock *clock = &clocks[i];
+		clock->timer = fmodf(clock->timer + (clock->speed * dt), (f32)clock->framesLen);
+		clock->currentFrame = (i32)clock->timer;
+	}
+}
+
+i32 animation_clock_frame(const AnimationClockID clock) {
+	panicIf(clock <= ANIMATION_CLOCK_NONE || clock > atomic_load(&clocksLen), "invalid animation clock %d", clock);
+	return clocks[clock - 1].currentFrame;
 }
 
 void animated_tiled_sprite_update(AnimatedTiledSprite *sprite, f32 dt) {
+	if (sprite->clock != ANIMATION_CLOCK_NONE) { return; }
+
 	sprite->frameTimer += sprite->animationSpeed * dt;
 	if (sprite->loop) {
 		sprite->currentFrame = (i32)fmodf(sprite->frameTimer, (f32)sprite->framesLen);
@@ -23,5 +71,12 @@ void animated_tiled_sprite_update(AnimatedTiledSprite *sprite, f32 dt) {
 }
 
 Rectangle animated_tiled_sprite_current_frame(const AnimatedTiledSprite *sprite) {
+	if (sprite->clock != ANIMATION_CLOCK_NONE) {
+		return sprite->sourceFrames[animation_clock_frame(sprite->clock)];
+	}
 	return sprite->sourceFrames[sprite->currentFrame];
 }
+
+Texture2D *animated_textures_sprite_current_frame(const AnimatedTexturesSprite *sprite) {
+	return &sprite->textures[animation_clock_frame(sprite->clock)];
+}
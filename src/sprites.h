@@ -48,6 +48,13 @@ static_assert(offsetof(StaticSprite, entity) == 0, "entity must be the first mem
 
 
 #define AnimatedSpriteAnimationFramesLen 4
+
+// Looping scenery (water, coast) always plays the same few frames at the same
+// speed, so instead of every sprite counting its own time they share a clock
+// per (speed, frames) pair that is advanced once a frame. 0 means no clock.
+#define MAX_ANIMATION_CLOCKS 16
+#define ANIMATION_CLOCK_NONE 0
+typedef i32 AnimationClockID;
 typedef struct AnimatedTiledSprite {
 	Entity entity; // cannot be moved from 1st position
 
@@ -58,6 +65,9 @@ typedef struct AnimatedTiledSprite {
 	i32 currentFrame;
 	f32 frameTimer;
 	f32 animationSpeed;
+	// looping sprites with a clock take their frame from it, the timer and
+	// current frame above are left alone.
+	AnimationClockID clock;
 	Rectangle sourceFrames[AnimatedSpriteAnimationFramesLen];
 } AnimatedTiledSprite;
 
@@ -68,9 +78,8 @@ typedef struct AnimatedTexturesSprite {
 
 	Texture2D *textures;
 	i32 framesLen;
-	i32 currentFrame;
-	f32 frameTimer;
 	f32 animationSpeed;
+	AnimationClockID clock; // always looping, the frame comes from the clock
 } AnimatedTexturesSprite;
 
 static_assert(
@@ -78,8 +87,19 @@ static_assert(
 	"entity must be the first member of AnimatedTexturesSprite"
 );
 
-void animated_textures_sprite_update(AnimatedTexturesSprite *sprite, f32 dt);
+/**
+ * Finds the clock for an animation, creating it the first time, safe to call
+ * from the map loader thread.
+ * @param speed frames per second
+ * @param framesLen frames in the loop
+ */
+AnimationClockID animation_clock_for(f32 speed, i32 framesLen);
+// advances every clock, once a frame.
+void animation_clocks_update(f32 dt);
+i32 animation_clock_frame(AnimationClockID clock);
+
 void animated_tiled_sprite_update(AnimatedTiledSprite *sprite, f32 dt);
 Rectangle animated_tiled_sprite_current_frame(const AnimatedTiledSprite *sprite);
+Texture2D *animated_textures_sprite_current_frame(const AnimatedTexturesSprite *sprite);
 
 #endif //RAYLIB_POKEMON_CLONE_SPRITES_H
@@ -0,0 +1,216 @@
+//
+// Created by Hector Mejia on 10/17/26.
+//
+
+#include "texture_cache.h"
+
+#include <pthread.h>
+
+#include "array/array.h"
+#include "platform.h"
+
+typedef struct TextureCacheEntry {
+	u64 hash;
+	char path[MAX_TEXTURE_PATH_LEN];
+	Texture2D texture;
+	i32 refs;
+	u64 bytes;
+} TextureCacheEntry;
+
+// maps decode their images on the loader thread, lookups come from both.
+static pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+static TextureCacheEntry *entries = nil;
+static TextureCacheStats stats = {};
+
+static void normalize_path(const char *path, char *outPath, usize len);
+static u64 hash_path(const char *path);
+static TextureCacheEntry *find_entry(const char *normalizedPath, u64 hash);
+static Texture2D insert_locked(const char *normalizedPath, u64 hash, Texture2D texture);
+
+Texture2D texture_cache_load(const char *path) {
+	Texture2D texture = {};
+	if (texture_cache_acquire(path, &texture)) {
+		return texture;
+	}
+
+	texture = platform_load_texture(path);
+	panicIf(!IsTextureReady(texture), "failed to load texture %s", path);
+	return texture_cache_insert(path, texture);
+}
+
+bool texture_cache_acquire(const char *path, Texture2D *outTexture) {
+	char normalized[MAX_TEXTURE_PATH_LEN];
+	normalize_path(path, normalized, sizeof(normalized));
+	const u64 hash = hash_path(normalized);
+
+	pthread_mutex_lock(&lock);
+	TextureCacheEntry *entry = find_entry(normalized, hash);
+	if (entry != nil) {
+		entry->refs++;
+		*outTexture = entry->texture;
+		stats.hits++;
+	} else {
+		stats.misses++;
+	}
+	pthread_mutex_unlock(&lock);
+	return entry != nil;
+}
+
+Texture2D texture_cache_insert(const char *path, const Texture2D texture) {
+	char normalized[MAX_TEXTURE_PATH_LEN];
+	normalize_path(path, normalized, sizeof(normalized));
+	const u64 hash = hash_path(normalized);
+
+	pthread_mutex_lock(&lock);
+	const Texture2D cached = insert_locked(normalized, hash, texture);
+	pthread_mutex_unlock(&lock);
+
+	if (cached.id != texture.id) {
+		platform_unload_texture(texture);
+	}
+	return cached;
+}
+
+void texture_cache_release(const Texture2D texture) {
+	if (texture.id == 0) { return; }
+
+	pthread_mutex_lock(&lock);
+	bool found = false;
+	array_range(entries, i) {
+		TextureCacheEntry *entry = &entries[i];
+		if (entry->texture.id != texture.id) { continue; }
+
+		found = true;
+		entry->refs--;
+		if (entry->refs == 0) {
+			platform_unload_texture(entry->texture);
+			stats.residentTextures--;
+			stats.residentBytes -= entry->bytes;
+			// order doesn't matter, the last entry takes its place.
+			entries[i] = entries[array_length(entries) - 1];
+			array_remove(entries, array_length(entries) - 1, sizeof(*entries));
+		}
+		break;
+	}
+	pthread_mutex_unlock(&lock);
+
+	if (!found) {
+		slogw("released texture #%d that is not in the texture cache", texture.id);
+	}
+}
+
+bool texture_cache_path(const u32 id, char *outPath, const usize len) {
+	pthread_mutex_lock(&lock);
+	bool found = false;
+	array_range(entries, i) {
+		if (entries[i].texture.id == id) {
+			snprintf(outPath, len, "%s", entries[i].path);
+			found = true;
+			break;
+		}
+	}
+	pthread_mutex_unlock(&lock);
+	return found;
+}
+
+TextureCacheStats texture_cache_stats() {
+	pthread_mutex_lock(&lock);
+	const TextureCacheStats current = stats;
+	pthread_mutex_unlock(&lock);
+	return current;
+}
+
+void texture_cache_shutdown() {
+	pthread_mutex_lock(&lock);
+	array_range(entries, i) {
+		slogw("texture %s is still held %d times at shutdown", entries[i].path, entries[i].refs);
+		platform_unload_texture(entries[i].texture);
+	}
+	if (entries != nil) {
+		array_free(entries);
+	}
+	entries = nil;
+	stats.residentTextures = 0;
+	stats.residentBytes = 0;
+	pthread_mutex_unlock(&lock);
+}
+
+// lexical only, "." and empty segments are dropped and ".." eats the segment
+// before it, links are not followed.
+static void normalize_path(const char *path, char *outPath, const usize len) {
+	panicIf(strlen(path) >= len, "texture path is too long: %s", path);
+
+	usize segmentStarts[MAX_TEXTURE_PATH_LEN / 2];
+	i32 segments = 0;
+	usize out = 0;
+	if (path[0] == '/') {
+		outPath[out++] = '/';
+	}
+	const usize root = out;
+
+	const char *cursor = path;
+	while (*cursor != '\0') {
+		const char *end = strchr(cursor, '/');
+		const usize segmentLen = end != nil ? (usize)(end - cursor) : strlen(cursor);
+
+		const bool isDot = segmentLen == 1 && cursor[0] == '.';
+		const bool isDotDot = segmentLen == 2 && cursor[0] == '.' && cursor[1] == '.';
+		const bool canPop = segments > 0 && !streq(outPath + segmentStarts[segments - 1], "..");
+		if (isDotDot && canPop) {
+			segments--;
+			out = segmentStarts[segments] > root ? segmentStarts[segments] - 1 : root;
+			outPath[out] = '\0';
+		} else if (segmentLen > 0 && !isDot) {
+			if (out > root) {
+				outPath[out++] = '/';
+			}
+			segmentStarts[segments++] = out;
+			memcpy(outPath + out, cursor, segmentLen);
+			out += segmentLen;
+			outPath[out] = '\0';
+		}
+
+		cursor += segmentLen;
+		if (*cursor == '/') { cursor++; }
+	}
+	outPath[out] = '\0';
+}
+
+// FNV-1a
+static u64 hash_path(const char *path) {
+	u64 hash = 0xcbf29ce484222325;
+	for (const char *c = path; *c != '\0'; c++) {
+		hash ^= (u8)*c;
+		hash *= 0x100000001b3;
+	}
+	return hash;
+}
+
+static TextureCacheEntry *find_entry(const char *normalizedPath, const u64 hash) {
+	array_range(entries, i) {
+		if (entries[i].hash == hash && streq(entries[i].path, normalizedPath)) {
+			return &entries[i];
+		}
+	}
+	return nil;
+}
+
+static Texture2D insert_locked(const char *normalizedPath, const u64 hash, const Texture2D texture) {
+	TextureCacheEntry *existing = find_entry(normalizedPath, hash);
+	if (existing != nil) {
+		existing->refs++;
+		return existing->texture;
+	}
+
+	TextureCacheEntry entry = {
+		.hash = hash,
+		.texture = texture,
+		.refs = 1,
+		.bytes = (u64)GetPixelDataSize(texture.width, texture.height, texture.format),
+	};
+	snprintf(entry.path, sizeof(entry.path), "%s", normalizedPath);
+	array_push(entries, entry);
+	stats.residentTextures++;
+	stats.residentBytes += entry.bytes;
+	return texture;
+}
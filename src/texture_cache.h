@@ -0,0 +1,60 @@
+//
+// Created by Hector Mejia on 10/17/26.
+//
+
+#ifndef RAYLIB_POKEMON_CLONE_TEXTURE_CACHE_H
+#define RAYLIB_POKEMON_CLONE_TEXTURE_CACHE_H
+
+#include "raylib.h"
+#include "common.h"
+
+// Every texture loaded from disk, keyed by its normalized path so the same
+// file reached through different relative paths (tilesets point at images
+// with "../../graphics/...") is only decoded and uploaded once. Each texture is
+// counted by who holds it and unloaded when the last one lets go.
+#define MAX_TEXTURE_PATH_LEN 256
+
+typedef struct TextureCacheStats {
+	i64 hits;
+	i64 misses;
+	i32 residentTextures;
+	u64 residentBytes; // estimated VRAM, mipmaps not included
+} TextureCacheStats;
+
+/**
+ * Returns the cached texture for a path, loading it on a miss. Has to be called
+ * on the main thread, it might upload.
+ * @param path any path to the image, it is normalized before the lookup
+ * @return the texture, to be handed back with texture_cache_release
+ */
+Texture2D texture_cache_load(const char *path);
+
+/**
+ * Looks a texture up without loading it, safe to call from any thread.
+ * @param outTexture the texture, only set when it was resident
+ * @return true if it was resident, the caller now holds a reference to it
+ */
+bool texture_cache_acquire(const char *path, Texture2D *outTexture);
+
+/**
+ * Adds a texture uploaded by the caller. If the path got cached in the
+ * meantime the given texture is unloaded and the cached one is returned.
+ * @return the texture to use, with a reference held by the caller
+ */
+Texture2D texture_cache_insert(const char *path, Texture2D texture);
+
+// drops a reference, the texture is unloaded once nobody holds it.
+void texture_cache_release(Texture2D texture);
+
+/**
+ * Finds the normalized path a cached texture was loaded from.
+ * @return false if the texture did not come from the cache
+ */
+bool texture_cache_path(u32 id, char *outPath, usize len);
+
+TextureCacheStats texture_cache_stats();
+
+// unloads whatever is left, complaining about every texture still held.
+void texture_cache_shutdown();
+
+#endif //RAYLIB_POKEMON_CLONE_TEXTURE_CACHE_H
@@ -4,10 +4,11 @@
 
 #include "timer.h"
 #include <raylib.h>
+#include "platform.h"
 
 void timer_start(Timer *timer, const double lifetime) {
     panicIfNil(timer, "provided a nil timer");
-    timer->startTime = GetTime();
+    timer->startTime = platform_time();
     timer->lifeTime = lifetime;
 }
 
@@ -23,14 +24,14 @@ bool timer_is_valid(const Timer timer) {
 
 bool timer_done(const Timer timer) {
     panicIf(!timer_is_valid(timer), "received invalid timer in timer_done");
-    return GetTime() - timer.startTime >= timer.lifeTime;
+    return platform_time() - timer.startTime >= timer.lifeTime;
 }
 
 f64 timer_get_elapsed(const Timer timer) {
-    return GetTime() - timer.startTime;
+    return platform_time() - timer.startTime;
 }
 
 void timer_reset(Timer *timer) {
     panicIfNil(timer, "provided a nil timer");
-    timer->startTime = GetTime();
+    timer->startTime = platform_time();
 }
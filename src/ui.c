@@ -4,10 +4,12 @@
 
 #include "ui.h"
 
+#include "gpu_stats.h"
+
 void ui_draw_progress_bar(Rectangle rect, f32 value, f32 maxValue, Color color, Color bgColor, f32 radius) {
     f32 ratio = rect.width / maxValue;
     Rectangle progressRect = rect;
     progressRect.width = clamp(value * ratio, 0, rect.width);
-    DrawRectangleRounded(rect, radius, 4, bgColor);
-    DrawRectangleRounded(progressRect, radius, 4, color);
+    gpu_draw_rectangle_rounded(rect, radius, 4, bgColor);
+    gpu_draw_rectangle_rounded(progressRect, radius, 4, color);
 }
@@ -0,0 +1,210 @@
+//
+// Created by Hector Mejia on 10/17/26.
+//
+
+#include "watchdog.h"
+
+#include "input.h"
+#include "profiler.h"
+#include "settings.h"
+
+// the frames go on a row of their own in the trace, after the profiler's.
+#define FRAMES_TRACE_TID MAX_PROFILER_THREADS
+#define SLOWEST_ZONES_TEXT_LEN 512
+
+typedef struct WatchdogFrame {
+	u64 frame;
+	u64 startNs;
+	u64 endNs;
+	const char *gameMode;
+	i32 mapID;
+	KeyboardKey keys[MAX_WATCHDOG_FRAME_KEYS];
+	i32 keysLen;
+} WatchdogFrame;
+
+typedef struct SlowZone {
+	const char *name;
+	f64 selfMs;
+	f64 ms;
+	i32 calls;
+} SlowZone;
+
+static struct {
+	WatchdogFrame frames[WATCHDOG_TRAILING_FRAMES];
+	i32 next;
+	i32 len;
+	u64 framesSeen;
+	u64 lastEndNs;
+	// frames left before another capture can happen.
+	i32 cooldown;
+	WatchdogStats stats;
+} watchdog = {};
+
+static void capture(const WatchdogFrame *spike, f64 frameMs);
+static i32 slowest_zones(SlowZone *outZones, i32 maxZones);
+static i32 compare_self_ms(const void *a, const void *b);
+
+bool watchdog_end_frame(const char *gameMode, const i32 mapID) {
+	const u64 now = profiler_now_ns();
+	if (watchdog.lastEndNs == 0) {
+		watchdog.lastEndNs = now;
+		return false;
+	}
+
+	WatchdogFrame *frame = &watchdog.frames[watchdog.next];
+	*frame = (WatchdogFrame){
+		.frame = watchdog.framesSeen++,
+		.startNs = watchdog.lastEndNs,
+		.endNs = now,
+		.gameMode = gameMode,
+		.mapID = mapID,
+	};
+	frame->keysLen = input_keys_down(frame->keys, MAX_WATCHDOG_FRAME_KEYS);
+	watchdog.lastEndNs = now;
+	watchdog.next = (watchdog.next + 1) % WATCHDOG_TRAILING_FRAMES;
+	watchdog.len = min(watchdog.len + 1, WATCHDOG_TRAILING_FRAMES);
+	watchdog.cooldown = max(watchdog.cooldown - 1, 0);
+
+	if (settings.frameBudgetMs <= 0) { return false; }
+
+	const f64 frameMs = (f64)(frame->endNs - frame->startNs) / 1e6;
+	if (frameMs <= settings.frameBudgetMs) { return false; }
+
+	watchdog.stats.spikes++;
+	watchdog.stats.lastSpikeMs = frameMs;
+	// a spike early on is captured with the frames there are so far.
+	if (watchdog.cooldown > 0 || watchdog.stats.captures >= MAX_WATCHDOG_CAPTURES) {
+		return false;
+	}
+
+	capture(frame, frameMs);
+	watchdog.cooldown = WATCHDOG_TRAILING_FRAMES;
+	return true;
+}
+
+WatchdogStats watchdog_stats() {
+	return watchdog.stats;
+}
+
+// a Chrome trace with the profiler zones of the trailing frames, the frames
+// themselves on a row of their own and the slowest zones in otherData.
+static void capture(const WatchdogFrame *spike, const f64 frameMs) {
+	SlowZone zones[WATCHDOG_SLOWEST_ZONES];
+	const i32 zonesLen = slowest_zones(zones, WATCHDOG_SLOWEST_ZONES);
+	char slowest[SLOWEST_ZONES_TEXT_LEN] = "";
+	usize slowestLen = 0;
+	for (i32 i = 0; i < zonesLen && slowestLen < sizeof(slowest); i++) {
+		slowestLen += snprintf(
+			slowest + slowestLen,
+			sizeof(slowest) - slowestLen,
+			"%s%s %.2f ms (%.2f ms total, %d calls)",
+			i > 0 ? ", " : "",
+			zones[i].name,
+			zones[i].selfMs,
+			zones[i].ms,
+			zones[i].calls
+		);
+	}
+
+	char timestamp[32];
+	const time_t now = time(nil);
+	struct tm local;
+	localtime_r(&now, &local);
+	strftime(timestamp, sizeof(timestamp), "%Y%m%d-%H%M%S", &local);
+	char path[MAX_WATCHDOG_PATH_LEN];
+	snprintf(path, sizeof(path), WATCHDOG_TRACE_PREFIX "%s_%llu.json", timestamp, (unsigned long long)spike->frame);
+
+	FILE *file = fopen(path, "w");
+	if (file == nil) {
+		slogw("could not open %s for writing", path);
+		return;
+	}
+
+	const i32 oldest = (watchdog.next - watchdog.len + WATCHDOG_TRAILING_FRAMES) % WATCHDOG_TRAILING_FRAMES;
+	fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+	fprintf(file, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"game\"}}");
+	profiler_write_trace_events(file, watchdog.frames[oldest].startNs);
+
+	fprintf(file, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"frames\"}}", FRAMES_TRACE_TID);
+	for (i32 i = 0; i < watchdog.len; i++) {
+		const WatchdogFrame *frame = &watchdog.frames[(oldest + i) % WATCHDOG_TRAILING_FRAMES];
+		fprintf(
+			file,
+			",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f,"
+			"\"args\":{\"frame\":%llu,\"map\":%d,\"mode\":",
+			frame == spike ? "over budget" : "frame",
+			FRAMES_TRACE_TID,
+			profiler_trace_us(frame->startNs),
+			(f64)(frame->endNs - frame->startNs) / 1e3,
+			(unsigned long long)frame->frame,
+			frame->mapID
+		);
+		profiler_write_json_string(file, frame->gameMode);
+		fprintf(file, ",\"keys\":[");
+		for (i32 k = 0; k < frame->keysLen; k++) {
+			fprintf(file, "%s%d", k > 0 ? "," : "", frame->keys[k]);
+		}
+		fprintf(file, "]}}");
+	}
+
+	fprintf(
+		file,
+		"\n],\"otherData\":{\"frame\":%llu,\"frameMs\":%.3f,\"budgetMs\":%.3f,\"slowestZones\":",
+		(unsigned long long)spike->frame,
+		frameMs,
+		settings.frameBudgetMs
+	);
+	profiler_write_json_string(file, slowest);
+	fprintf(file, "}}\n");
+
+	if (fclose(file) != 0) {
+		slogw("failed to write watchdog capture %s", path);
+		return;
+	}
+
+	watchdog.stats.captures++;
+	snprintf(watchdog.stats.lastCapture, sizeof(watchdog.stats.lastCapture), "%s", path);
+	slogw(
+		"frame %llu took %.2f ms, over the %.2f ms budget, wrote %s. slowest zones: %s",
+		(unsigned long long)spike->frame,
+		frameMs,
+		settings.frameBudgetMs,
+		path,
+		zonesLen > 0 ? slowest : "none"
+	);
+}
+
+// the zones of the frame profiler_frame_end just closed by the time spent in
+// them and not in their children. The children of a zone come right after it,
+// one level deeper.
+static i32 slowest_zones(SlowZone *outZones, const i32 maxZones) {
+	const ProfilerZoneStats *zones = nil;
+	const i32 zonesLen = profiler_frame_zones(&zones);
+
+	SlowZone all[MAX_PROFILER_FRAME_ZONES];
+	for (i32 i = 0; i < zonesLen; i++) {
+		f64 childrenMs = 0;
+		for (i32 child = i + 1; child < zonesLen && zones[child].depth > zones[i].depth; child++) {
+			if (zones[child].depth == zones[i].depth + 1) {
+				childrenMs += zones[child].ms;
+			}
+		}
+		all[i] = (SlowZone){
+			.name = zones[i].name,
+			.selfMs = max(zones[i].ms - childrenMs, 0.0),
+			.ms = zones[i].ms,
+			.calls = zones[i].calls,
+		};
+	}
+	qsort(all, zonesLen, sizeof(*all), compare_self_ms);
+
+	const i32 len = min(zonesLen, maxZones);
+	memcpy(outZones, all, sizeof(*outZones) * len);
+	return len;
+}
+
+static i32 compare_self_ms(const void *a, const void *b) {
+	const f64 selfA = ((const SlowZone *)a)->selfMs;
+	const f64 selfB = ((const SlowZone *)b)->selfMs;
+	return (selfA < selfB) - (selfA > selfB);
+}
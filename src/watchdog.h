@@ -0,0 +1,45 @@
+//
+// Created by Hector Mejia on 10/17/26.
+//
+
+#ifndef RAYLIB_POKEMON_CLONE_WATCHDOG_H
+#define RAYLIB_POKEMON_CLONE_WATCHDOG_H
+
+#include "common.h"
+
+// Watches the frame times for one over settings.frameBudgetMs and writes the
+// frames leading up to it out as a Chrome trace: the profiler zones of the
+// last WATCHDOG_TRAILING_FRAMES frames, plus a track with every frame's time,
+// game mode, map and held keys. The zones that took the most time of their
+// own in the slow frame are logged and named in the trace, so a hitch comes
+// with its culprits without anyone running the profiler by hand.
+//
+// A spike in the first frames gets captured with however many came before
+// it, up to WATCHDOG_TRAILING_FRAMES. After a capture the watchdog waits for
+// a whole new set of trailing frames before the next one.
+#define WATCHDOG_TRAILING_FRAMES 30
+#define WATCHDOG_SLOWEST_ZONES 5
+#define MAX_WATCHDOG_CAPTURES 32
+#define MAX_WATCHDOG_FRAME_KEYS 8
+#define MAX_WATCHDOG_PATH_LEN 128
+#define WATCHDOG_TRACE_PREFIX "./watchdog_"
+
+typedef struct WatchdogStats {
+	i64 spikes;
+	i64 captures;
+	f64 lastSpikeMs;
+	char lastCapture[MAX_WATCHDOG_PATH_LEN];
+} WatchdogStats;
+
+/**
+ * Ends the frame for the watchdog, meant to be called right after
+ * profiler_frame_end so the zones of the frame are there if it was too slow.
+ * The frame runs from the end of the last one.
+ * @param gameMode what the game was doing, a string literal
+ * @param mapID the map the frame was on
+ * @return true if the frame went over the budget and got captured
+ */
+bool watchdog_end_frame(const char *gameMode, i32 mapID);
+WatchdogStats watchdog_stats();
+
+#endif //RAYLIB_POKEMON_CLONE_WATCHDOG_H